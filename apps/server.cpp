@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+
+#include "sim/ProtocolServer.h"
+
+#include "slaythespire.h"
+
+using namespace sts;
+
+// usage: server [threadCount] [unixSocketPath]
+// speaks the json lines protocol in sim/ProtocolServer.h over stdin/stdout, or over a unix socket if a path is given
+int main(int argc, const char* argv[]) {
+    std::ios::sync_with_stdio(false); // lets the server see how much pipelined input is already buffered
+
+    ProtocolServer server;
+    if (argc > 1) {
+        server.threadCount = std::stoi(argv[1]);
+    }
+    server.getObservation = [](const GameContext &gc, const BattleContext *bc) {
+        const auto obs = NNInterface::getInstance()->getObservation(gc, bc);
+        return std::vector<int>(obs.begin(), obs.end());
+    };
+    NNInterface::getInstance();
+
+    if (argc > 2) {
+#ifndef _WIN32
+        return server.serveUnixSocket(argv[2]) ? 0 : 1;
+#else
+        std::cerr << "unix sockets are not supported on this platform" << std::endl;
+        return 1;
+#endif
+    }
+
+    server.serve(std::cin, std::cout);
+    return 0;
+}
@@ -2,32 +2,56 @@
 // Created by gamerpuppy on 7/8/2021.
 //
 
+#include <algorithm>
+#include <bitset>
 #include <iostream>
 #include <chrono>
 #include <cstdint>
+#include <fstream>
 #include <thread>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <sstream>
 
 #include "data_structure/fixed_list.h"
 #include "constants/Cards.h"
+#include "constants/CardInfo.h"
 #include "constants/Events.h"
 #include "constants/CardPools.h"
 #include "game/Game.h"
 #include "game/Map.h"
+#include "game/MapPathPlanner.h"
 #include "game/Neow.h"
+#include "game/RngOracle.h"
 #include "game/SaveFile.h"
+#include "game/SaveFileBatch.h"
+#include "game/SeedTable.h"
 #include "combat/BattleContext.h"
+#include "combat/DamageModifiers.h"
 #include "sim/ConsoleSimulator.h"
 #include "sim/PrintHelpers.h"
 #include "sim/RandomAgent.h"
+#include "sim/ScriptBatch.h"
+#include "sim/search/ActionSpace.h"
+#include "sim/search/AgentComparison.h"
 #include "sim/search/ScumSearchAgent2.h"
 #include "sim/search/SimpleAgent.h"
+#include "sim/search/StaticEvaluator.h"
 
 #include "sim/search/BattleScumSearcher2.h"
 
 using namespace sts;
 
+// size budgets for the structures copied on every search simulation, raise these deliberately.
+// the action queue holds std::function and its size depends on the standard library so it is budgeted separately
+static_assert(sizeof(Player) <= 160);
+static_assert(sizeof(MonsterGroup) <= 424);
+static_assert(sizeof(CardManager) <= 368);
+static_assert(sizeof(CardQueue) <= 192);
+static_assert(sizeof(CardQueueItem) <= 18);
+static_assert(sizeof(BattleContext) - sizeof(ActionQueue<50>) <= 1400);
+
 void printSizes() {
     std::cout << "sizeof Map:" << sizeof(Map) << '\n';
     std::cout << "sizeof Player: " << sizeof(Player) << '\n';
@@ -35,10 +59,24 @@ void printSizes() {
     std::cout << "sizeof MonsterGroup : " << sizeof(MonsterGroup) << '\n';
     std::cout << "sizeof CardInstance: " << sizeof(CardInstance) << '\n';
     std::cout << "sizeof CardManager : " << sizeof(CardManager) << '\n';
+    std::cout << "sizeof CardQueueItem : " << sizeof(CardQueueItem) << '\n';
+    std::cout << "sizeof CardQueue : " << sizeof(CardQueue) << '\n';
     std::cout << "sizeof ActionFunction : " << sizeof(ActionFunction) << '\n';
     std::cout << "sizeof ActionQueue<40> : " << sizeof(ActionQueue<40>) << '\n';
     std::cout << "sizeof BattleContext: " << sizeof(BattleContext) << '\n';
 
+    static const BattleContext bc {};
+    const auto offsetOf = [&](const void *member) {
+        return static_cast<const char*>(member) - reinterpret_cast<const char*>(&bc);
+    };
+    std::cout << "BattleContext offsets, player: " << offsetOf(&bc.player)
+        << " monsters: " << offsetOf(&bc.monsters)
+        << " cards: " << offsetOf(&bc.cards)
+        << " cardQueue: " << offsetOf(&bc.cardQueue)
+        << " actionQueue: " << offsetOf(&bc.actionQueue)
+        << " rngs: " << offsetOf(&bc.aiRng)
+        << " cold: " << offsetOf(&bc.seed) << '\n';
+
     std::cout << "sizeof GameContext: " << sizeof(GameContext) << '\n';
     std::cout << "sizeof Deck: " << sizeof(Deck) << '\n';
     std::cout << "sizeof Card: " << sizeof(Card) << '\n';
@@ -128,11 +166,19 @@ struct AgentMtInfo {
     std::int64_t lossCount = 0;
     std::int64_t floorSum = 0;
     std::int64_t totalSimulations = 0;
+    std::int64_t peakNodeCount = 0;
+    std::int64_t reclaimedNodeCount = 0;
 };
 
 static int g_searchAscension = 0;
 static int g_simulationCount = 5;
 static int g_print_level = 0;
+static std::int64_t g_nodeBudget = 0;
+static int g_determinizationCount = 1;
+static int g_ensembleThreadCount = 1;
+static double g_wideningBase = 0;
+static double g_priorWeight = 0;
+static search::MultiSelectMode g_multiSelectMode = search::MultiSelectMode::SKIP;
 
 void agentMtRunner(AgentMtInfo *info) {
     std::uint64_t seed;
@@ -149,6 +195,12 @@ void agentMtRunner(AgentMtInfo *info) {
         GameContext gc(CharacterClass::IRONCLAD, seed, g_searchAscension);
         search::ScumSearchAgent2 agent;
         agent.simulationCountBase = g_simulationCount;
+        agent.nodeBudget = g_nodeBudget;
+        agent.determinizationCount = g_determinizationCount;
+        agent.ensembleThreadCount = g_ensembleThreadCount;
+        agent.wideningBase = g_wideningBase;
+        agent.priorWeight = g_priorWeight;
+        agent.multiSelectMode = g_multiSelectMode;
         agent.rng = std::default_random_engine(gc.seed);
 
         agent.printActions = g_print_level & 0x1;
@@ -167,6 +219,8 @@ void agentMtRunner(AgentMtInfo *info) {
                 ++info->lossCount;
             }
             info->totalSimulations += agent.simulationCountTotal;
+            info->peakNodeCount = std::max(info->peakNodeCount, agent.peakNodeCount);
+            info->reclaimedNodeCount += agent.reclaimedNodeCount;
 
             seed = info->curSeed++;
         }
@@ -205,11 +259,17 @@ void agentMt(int threadCount, std::uint64_t startSeed, int playoutCount) {
         << " percentWin: " << static_cast<double>(info.winCount) / playoutCount * 100 << "%"
         << " avgFloorReached: " << static_cast<double>(info.floorSum) / playoutCount << '\n'
         << " totalSimulations: " << info.totalSimulations
-        << " avgPerFloor: " << (double)info.totalSimulations/info.floorSum << '\n';
+        << " avgPerFloor: " << (double)info.totalSimulations/info.floorSum << '\n'
+        << " peakNodeCount: " << info.peakNodeCount
+        << " reclaimedNodeCount: " << info.reclaimedNodeCount << '\n';
 
     std::cout << "threads: " << threadCount
               << " playoutCount: " << playoutCount
               << " depth: " << g_simulationCount
+              << " determinizations: " << g_determinizationCount
+              << " widening: " << g_wideningBase
+              << " priorWeight: " << g_priorWeight
+              << " multiSelectMode: " << static_cast<int>(g_multiSelectMode)
         << " asc: " << g_searchAscension
         << " elapsed: " << duration
         << std::endl;
@@ -229,6 +289,7 @@ int mcts(int argc, const char *argv[]) {
     bc.init(gc);
 
     search::BattleScumSearcher2 searcher(bc);
+    searcher.nodeBudget = argc > 4 ? std::stoll(argv[4]) : 0;
 
     auto startTime = std::chrono::high_resolution_clock::now();
     searcher.search(simulationCount);
@@ -236,6 +297,8 @@ int mcts(int argc, const char *argv[]) {
     double duration = std::chrono::duration<double>(endTime-startTime).count();
 
     std::cout << "steps: " << simulationCount << " search time: " << duration << "s\n";
+    std::cout << "nodes: " << searcher.nodeCount << " peak: " << searcher.peakNodeCount
+        << " reclaimed: " << searcher.reclaimedNodeCount << " prunes: " << searcher.pruneCount << '\n';
     std::cout << "best search value: " << searcher.bestActionValue << " depth: " << searcher.bestActionSequence.size() << '\n';
     if (searcher.bestActionSequence.empty()) {
         std::cout << "bestActionSequenceIsEmpty" << std::endl;
@@ -255,6 +318,1220 @@ int mcts(int argc, const char *argv[]) {
     return 0;
 }
 
+// cross checks the fixed point damage modifiers against calculateCardDamage and calculateDamageToPlayer on random states
+bool verifyDamageModifiers(std::uint64_t startSeed, int stateCount) {
+    static constexpr MonsterEncounter encounters[] {
+        MonsterEncounter::GREMLIN_GANG, MonsterEncounter::LOTS_OF_SLIMES, MonsterEncounter::THREE_LOUSE,
+        MonsterEncounter::THREE_SENTRIES, MonsterEncounter::THREE_BYRDS, MonsterEncounter::JAW_WORM,
+    };
+    static constexpr CardId cards[] { CardId::STRIKE_RED, CardId::POMMEL_STRIKE, CardId::BASH, CardId::CLEAVE };
+
+    std::int64_t checkCount = 0;
+    std::int64_t mismatchCount = 0;
+
+    for (std::uint64_t seed = startSeed; seed < startSeed + stateCount; ++seed) {
+        std::default_random_engine rng(seed);
+        const auto randInt = [&](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+        const auto coin = [&]() { return randInt(0, 1) == 1; };
+
+        GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+        BattleContext bc;
+        bc.init(gc, encounters[randInt(0, std::size(encounters)-1)]);
+
+        auto &p = bc.player;
+        p.strength = randInt(-10, 30);
+        p.setHasRelic<R::STRIKE_DUMMY>(coin());
+        p.setHasRelic<R::WRIST_BLADE>(coin());
+        p.setHasRelic<R::PAPER_PHROG>(coin());
+        p.setHasRelic<R::PAPER_KRANE>(coin());
+        p.setHasRelic<R::ODD_MUSHROOM>(coin());
+        if (coin()) {
+            p.buff<PS::VIGOR>(randInt(1, 15));
+        }
+        p.setHasStatus<PS::DOUBLE_DAMAGE>(coin());
+        p.setHasStatus<PS::PEN_NIB>(coin());
+        p.setHasStatus<PS::WEAK>(coin());
+        p.setHasStatus<PS::VULNERABLE>(coin());
+        p.setHasStatus<PS::INTANGIBLE>(randInt(0, 4) == 0);
+        p.setHasStatus<PS::SURROUNDED>(coin());
+        p.lastTargetedMonster = randInt(0, bc.monsters.monsterCount-1);
+        p.stance = static_cast<Stance>(randInt(0, 3));
+
+        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+            auto &m = bc.monsters.arr[i];
+            m.strength = randInt(-5, 20);
+            m.setHasStatus<MS::VULNERABLE>(coin());
+            m.setHasStatus<MS::WEAK>(coin());
+            // flight and intangible only matter by presence, they share their amount with slow
+            m.setHasStatus<MS::FLIGHT>(randInt(0, 3) == 0);
+            m.setHasStatus<MS::INTANGIBLE>(randInt(0, 4) == 0);
+            if (randInt(0, 3) == 0) {
+                m.setHasStatus<MS::SLOW>(true);
+                m.setStatus<MS::SLOW>(randInt(1, 12));
+            }
+            if (randInt(0, 5) == 0) {
+                m.curHp = 0;
+            }
+        }
+
+        CardInstance card(cards[randInt(0, std::size(cards)-1)], coin());
+        card.costForTurn = static_cast<std::int8_t>(randInt(0, 2));
+
+        const int baseDamage = randInt(0, 7) == 0 ? randInt(-40000, 40000) : randInt(-5, 60);
+        const CardDamageModifiers cardModifiers(bc, card);
+        const IncomingDamageModifiers incomingModifiers(bc);
+
+        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+            const int expected = bc.calculateCardDamage(card, i, baseDamage);
+            const int actual = cardModifiers.calculate(i, baseDamage);
+            const int expectedIncoming = bc.monsters.arr[i].calculateDamageToPlayer(bc, baseDamage);
+            const int actualIncoming = incomingModifiers.calculate(i, baseDamage);
+            checkCount += 2;
+
+            if (expected != actual || expectedIncoming != actualIncoming) {
+                ++mismatchCount;
+                std::cout << "mismatch seed: " << seed << " monster: " << i << " baseDamage: " << baseDamage
+                    << " card: " << expected << " " << actual
+                    << " incoming: " << expectedIncoming << " " << actualIncoming << '\n';
+            }
+        }
+    }
+
+    std::cout << "damage modifier checks: " << checkCount << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+// plays games with SimpleAgent and checks the rewards and shop of each room against an RngOracle forked at the map
+// screen before the room was entered. combat writes potionRng back, so potion drop mismatches are only counted
+bool verifyRngOracle(std::uint64_t startSeed, int gameCount) {
+    const auto sameRewards = [](const Rewards &a, const Rewards &b) {
+        if (a.gold[0] != b.gold[0] || a.relicCount != b.relicCount || a.cardRewardCount != b.cardRewardCount) {
+            return false;
+        }
+        for (int i = 0; i < a.relicCount; ++i) {
+            if (a.relics[i] != b.relics[i]) {
+                return false;
+            }
+        }
+        for (int i = 0; i < a.cardRewardCount; ++i) {
+            if (a.cardRewards[i].size() != b.cardRewards[i].size() ||
+                !std::equal(a.cardRewards[i].begin(), a.cardRewards[i].end(), b.cardRewards[i].begin())) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const auto samePotions = [](const Rewards &a, const Rewards &b) {
+        return a.potionCount == b.potionCount && (a.potionCount == 0 || a.potions[0] == b.potions[0]);
+    };
+
+    const auto sameShop = [](const Shop &a, const Shop &b) {
+        return std::equal(std::begin(a.cards), std::end(a.cards), std::begin(b.cards)) &&
+               std::equal(std::begin(a.relics), std::end(a.relics), std::begin(b.relics)) &&
+               std::equal(std::begin(a.potions), std::end(a.potions), std::begin(b.potions)) &&
+               std::equal(std::begin(a.prices), std::end(a.prices), std::begin(b.prices)) &&
+               a.removeCost == b.removeCost;
+    };
+
+    std::int64_t checkCount = 0;
+    std::int64_t mismatchCount = 0;
+    std::int64_t potionMismatchCount = 0;
+
+    for (std::uint64_t seed = startSeed; seed < startSeed + gameCount; ++seed) {
+        GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+        search::SimpleAgent agent;
+        agent.curGameContext = &gc;
+        BattleContext bc;
+
+        Room pendingRoom = Room::INVALID; // a room whose rewards screen hasn't opened yet
+        Rewards expected;
+
+        while (gc.outcome == GameOutcome::UNDECIDED) {
+            if (gc.screenState == ScreenState::BATTLE) {
+                bc = BattleContext();
+                bc.init(gc);
+                agent.playoutBattle(bc);
+                bc.exitBattle(gc);
+
+            } else if (gc.screenState == ScreenState::MAP_SCREEN) {
+                const auto monsterRewards = RngOracle(gc).nextCombatReward(Room::MONSTER);
+                const auto eliteRewards = RngOracle(gc).nextCombatReward(Room::ELITE);
+                const auto chestRewards = RngOracle(gc).nextTreasureChest();
+                const auto shop = RngOracle(gc).nextShop();
+
+                agent.stepOutOfCombat(gc);
+
+                pendingRoom = Room::INVALID;
+                if (gc.screenState == ScreenState::SHOP_ROOM) {
+                    ++checkCount;
+                    if (!sameShop(shop, gc.info.shop)) {
+                        ++mismatchCount;
+                        std::cout << "seed: " << seed << " floor: " << gc.floorNum << " shop mismatch\n";
+                    }
+                } else if (gc.screenState == ScreenState::TREASURE_ROOM) {
+                    pendingRoom = Room::TREASURE;
+                    expected = chestRewards;
+                } else if (gc.screenState == ScreenState::BATTLE && gc.curRoom == Room::MONSTER) {
+                    pendingRoom = Room::MONSTER;
+                    expected = monsterRewards;
+                } else if (gc.screenState == ScreenState::BATTLE && gc.curRoom == Room::ELITE) {
+                    pendingRoom = Room::ELITE;
+                    expected = eliteRewards;
+                }
+                continue;
+
+            } else {
+                agent.stepOutOfCombat(gc);
+            }
+
+            if (pendingRoom != Room::INVALID && gc.screenState == ScreenState::REWARDS) {
+                const auto &actual = gc.info.rewardsContainer;
+                ++checkCount;
+                if (!sameRewards(expected, actual)) {
+                    ++mismatchCount;
+                    std::cout << "seed: " << seed << " floor: " << gc.floorNum
+                              << " room: " << roomStrings[static_cast<int>(pendingRoom)] << " rewards mismatch\n";
+                }
+                if (!samePotions(expected, actual)) {
+                    ++potionMismatchCount;
+                }
+                pendingRoom = Room::INVALID;
+            }
+        }
+    }
+
+    std::cout << "games: " << gameCount
+              << " checks: " << checkCount
+              << " mismatches: " << mismatchCount
+              << " potion mismatches: " << potionMismatchCount
+              << std::endl;
+    return mismatchCount == 0;
+}
+
+// checks CardSubsetGenerator on random hands with repeated cards against every subset of the hand: the selections
+// are distinct and complete, count() agrees, pick sequences reach the same selections, and picking one card at a
+// time ends in the same state as selecting all of them at once
+bool verifyCardSubsets(std::uint64_t startSeed, int stateCount) {
+    static constexpr CardId cards[] { CardId::STRIKE_RED, CardId::DEFEND_RED, CardId::BASH, CardId::ANGER, CardId::WOUND };
+
+    std::int64_t checkCount = 0;
+    std::int64_t mismatchCount = 0;
+
+    for (std::uint64_t seed = startSeed; seed < startSeed + stateCount; ++seed) {
+        std::mt19937 rng(seed); // the first outputs of a minstd engine are tiny for small seeds
+        const auto randInt = [&](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+        GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+        BattleContext bc;
+        bc.init(gc, MonsterEncounter::JAW_WORM);
+
+        bc.cards.cardsInHand = randInt(0, CardManager::MAX_HAND_SIZE);
+        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+            bc.cards.hand[i] = CardInstance(cards[randInt(0, std::size(cards)-1)], randInt(0, 3) == 0);
+        }
+        bc.inputState = InputState::CARD_SELECT;
+        bc.cardSelectInfo.cardSelectTask = randInt(0, 1) ? CardSelectTask::GAMBLE : CardSelectTask::EXHAUST_MANY;
+        bc.cardSelectInfo.pickCount = randInt(1, 5);
+        bc.cardSelectInfo.multiSelect_PickedBits() = 0;
+
+        const auto getKey = [&](std::uint32_t bits) {
+            std::vector<int> key;
+            for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+                if (bits & (1U << i)) {
+                    key.push_back(static_cast<int>(bc.cards.hand[i].id) * 2 + bc.cards.hand[i].upgraded);
+                }
+            }
+            std::sort(key.begin(), key.end());
+            return key;
+        };
+
+        const auto maxPicks = search::CardSubsetGenerator::getMaxPicks(bc);
+        std::set<std::vector<int>> expected;
+        for (std::uint32_t bits = 0; bits < (1U << bc.cards.cardsInHand); ++bits) {
+            if (std::bitset<10>(bits).count() <= maxPicks) {
+                expected.insert(getKey(bits));
+            }
+        }
+
+        search::CardSubsetGenerator gen(bc);
+        std::set<std::vector<int>> generated;
+        std::vector<std::uint32_t> selections;
+        bool ok = gen.count() == static_cast<std::int64_t>(expected.size());
+        search::Action a;
+        while (gen.next(a)) {
+            ok &= a.isValidAction(bc) && generated.insert(getKey(a.bits & 0x3FF)).second;
+            selections.push_back(a.bits & 0x3FF);
+        }
+        ok &= generated == expected;
+
+        std::set<std::vector<int>> picked;
+        std::vector<std::uint32_t> stack {0};
+        while (!stack.empty()) {
+            const auto bits = stack.back();
+            stack.pop_back();
+
+            BattleContext pickState(bc);
+            pickState.cardSelectInfo.multiSelect_PickedBits() = static_cast<int>(bits);
+            for (auto pick : gen.getNextPicks(bits)) {
+                ok &= pick.isValidAction(pickState);
+                if (pick == search::Action::multiSelectDone()) {
+                    ok &= picked.insert(getKey(bits)).second;
+                } else {
+                    stack.push_back(bits | (pick.bits & 0x3FF));
+                }
+            }
+        }
+        ok &= picked == expected;
+
+        const auto selection = selections[randInt(0, static_cast<int>(selections.size())-1)];
+        BattleContext all(bc);
+        BattleContext oneByOne(bc);
+        search::Action(search::ActionType::MULTI_CARD_SELECT, static_cast<int>(selection)).execute(all);
+        for (auto idx : search::Action(selection).getSelectedIdxs()) {
+            search::Action::multiSelectPick(idx).execute(oneByOne);
+        }
+        search::Action::multiSelectDone().execute(oneByOne);
+
+        ok &= all.cards.cardsInHand == oneByOne.cards.cardsInHand &&
+              all.cards.exhaustPile.size() == oneByOne.cards.exhaustPile.size() &&
+              all.cards.discardPile.size() == oneByOne.cards.discardPile.size() &&
+              all.cards.drawPile.size() == oneByOne.cards.drawPile.size() &&
+              all.inputState == oneByOne.inputState;
+        for (int i = 0; ok && i < all.cards.cardsInHand; ++i) {
+            ok &= all.cards.hand[i].id == oneByOne.cards.hand[i].id;
+        }
+
+        ++checkCount;
+        if (!ok) {
+            ++mismatchCount;
+            std::cout << "mismatch seed: " << seed << " hand: " << bc.cards.cardsInHand
+                      << " selections: " << expected.size() << " generated: " << generated.size()
+                      << " picked: " << picked.size() << '\n';
+        }
+    }
+
+    std::cout << "card subset checks: " << checkCount << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+namespace {
+
+    // a random ironclad battle for the verifiers: 2 to 8 of cards added to the starter deck, up to 2 of relics and up
+    // to 3 of potions, against one of encounters. everything is drawn from one rng so a seed replays the same battle
+    class RandomBattle {
+    public:
+        BattleContext bc;
+
+        RandomBattle(std::uint64_t seed,
+                     const std::vector<CardId> &cards,
+                     const std::vector<RelicId> &relics,
+                     const std::vector<Potion> &potions,
+                     const std::vector<MonsterEncounter> &encounters) : rng(seed) {
+            GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+            for (int i = randInt(2, 8); i > 0; --i) {
+                gc.deck.obtainRaw(Card(pick(cards)));
+            }
+            if (!relics.empty()) {
+                for (int i = randInt(0, 2); i > 0; --i) {
+                    gc.obtainRelic(pick(relics));
+                }
+            }
+            if (!potions.empty()) {
+                for (int i = randInt(0, 3); i > 0; --i) {
+                    gc.obtainPotion(pick(potions));
+                }
+            }
+            bc.init(gc, pick(encounters));
+        }
+
+        int randInt(int lo, int hi) {
+            return std::uniform_int_distribution<int>(lo, hi)(rng);
+        }
+
+        // executes a uniformly chosen legal index of the action space, false if there is none
+        bool stepRandomly() {
+            std::array<std::uint8_t, search::ActionSpace::SIZE> mask {};
+            search::ActionSpace::writeLegalityMask(bc, mask.data());
+            std::vector<int> legal;
+            for (int idx = 0; idx < search::ActionSpace::SIZE; ++idx) {
+                if (mask[idx]) {
+                    legal.push_back(idx);
+                }
+            }
+            if (legal.empty()) {
+                return false;
+            }
+            search::ActionSpace::decode(pick(legal)).execute(bc);
+            return true;
+        }
+
+    private:
+        std::mt19937 rng;
+
+        template <typename T>
+        const T &pick(const std::vector<T> &list) {
+            return list[randInt(0, static_cast<int>(list.size())-1)];
+        }
+    };
+
+}
+
+// plays random battles and in every state compares the MonsterGroup kernels against calling the Monster functions on
+// each monster, on copies of the state. some monsters are given extra statuses first so both paths of the kernels run
+bool verifyMonsterKernels(std::uint64_t startSeed, int battleCount) {
+    static const std::vector<CardId> cards { CardId::CLEAVE, CardId::WHIRLWIND, CardId::THUNDERCLAP, CardId::IMMOLATE,
+                                            CardId::BASH, CardId::METALLICIZE, CardId::SHRUG_IT_OFF, CardId::INFLAME };
+    static const std::vector<RelicId> relics { RelicId::HAND_DRILL, RelicId::THE_BOOT, RelicId::MERCURY_HOURGLASS,
+                                               RelicId::LETTER_OPENER };
+    static const std::vector<MonsterEncounter> encounters { MonsterEncounter::SMALL_SLIMES, MonsterEncounter::THREE_LOUSE,
+                                                            MonsterEncounter::GREMLIN_GANG, MonsterEncounter::LAGAVULIN,
+                                                            MonsterEncounter::THREE_SENTRIES, MonsterEncounter::THREE_BYRDS,
+                                                            MonsterEncounter::THREE_CULTIST,
+                                                            MonsterEncounter::SHELLED_PARASITE_AND_FUNGI };
+
+    std::int64_t stateCount = 0;
+    std::int64_t mismatchCount = 0;
+
+    for (std::uint64_t seed = startSeed; seed < startSeed + battleCount; ++seed) {
+        RandomBattle battle(seed, cards, relics, {}, encounters);
+        auto &bc = battle.bc;
+        const auto randInt = [&](int lo, int hi) { return battle.randInt(lo, hi); };
+
+        bool ok = true;
+        for (int step = 0; ok && step < 1000 && bc.outcome == Outcome::UNDECIDED; ++step) {
+            BattleContext start(bc);
+            for (int i = 0; i < start.monsters.monsterCount; ++i) {
+                auto &m = start.monsters.arr[i];
+                switch (randInt(0, 15)) {
+                    case 0: m.buff<MS::METALLICIZE>(randInt(1, 5)); break;
+                    case 1: m.buff<MS::PLATED_ARMOR>(randInt(1, 5)); break;
+                    case 2: m.buff<MS::THORNS>(randInt(1, 3)); break;
+                    case 3: m.buff<MS::RITUAL>(randInt(1, 3)); break;
+                    case 4: m.buff<MS::REGEN>(randInt(1, 5)); break;
+                    case 5: m.buff<MS::ANGRY>(randInt(1, 3)); break;
+                    case 6: m.addBlock(randInt(1, 15)); break;
+                    default: break;
+                }
+            }
+
+            const auto compare = [&](const BattleContext &kernel, const BattleContext &scalar) {
+                std::ostringstream a;
+                std::ostringstream b;
+                a << kernel;
+                b << scalar;
+                return a.str() == b.str();
+            };
+
+            int damage[5];
+            for (auto &d : damage) {
+                d = randInt(-2, 30);
+            }
+            const auto isDeadOrEscaped = [](const Monster &m) { return m.isDeadOrEscaped(); };
+            const auto isDyingOrEscaping = [](const Monster &m) { return m.isDying() || m.isEscaping(); };
+            const auto forEachMonster = [&](BattleContext &scalar, auto skip, auto f) {
+                for (int i = 0; i < scalar.monsters.monsterCount; ++i) {
+                    if (!skip(scalar.monsters.arr[i])) {
+                        f(scalar.monsters.arr[i], i);
+                    }
+                }
+            };
+
+            BattleContext kernel(start);
+            BattleContext scalar(start);
+            kernel.monsters.attackAll(kernel, damage);
+            forEachMonster(scalar, isDeadOrEscaped, [&](Monster &m, int i) { m.attacked(scalar, damage[i]); });
+            ok &= compare(kernel, scalar);
+
+            kernel = start;
+            scalar = start;
+            kernel.monsters.damageAll(kernel, damage[0]);
+            forEachMonster(scalar, isDeadOrEscaped, [&](Monster &m, int) { m.damage(scalar, damage[0]); });
+            ok &= compare(kernel, scalar);
+
+            kernel = start;
+            scalar = start;
+            kernel.applyEndOfRoundPowers();
+            forEachMonster(scalar, isDyingOrEscaping, [&](Monster &m, int) { m.applyEndOfTurnTriggers(scalar); });
+            scalar.player.applyAtEndOfRoundPowers();
+            forEachMonster(scalar, isDyingOrEscaping, [&](Monster &m, int) { m.applyEndOfRoundPowers(scalar); });
+            ok &= compare(kernel, scalar);
+
+            kernel = start;
+            scalar = start;
+            kernel.monsters.applyPreTurnLogic(kernel);
+            forEachMonster(scalar, isDyingOrEscaping, [&](Monster &m, int) { m.applyStartOfTurnPowers(scalar); });
+            ok &= compare(kernel, scalar);
+
+            ++stateCount;
+            if (!ok || !battle.stepRandomly()) {
+                break;
+            }
+        }
+
+        if (!ok) {
+            ++mismatchCount;
+            std::cout << "mismatch seed: " << seed << " encounter: " << monsterEncounterStrings[static_cast<int>(bc.encounter)] << '\n';
+        }
+    }
+
+    std::cout << "monster kernel states: " << stateCount << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+// walks random battles choosing uniformly among the legal indices of the fixed action space, checking in every state
+// that the mask agrees with isValidAction on the decoded actions, that indices round trip through encode, and that
+// everything the searcher enumerates is encodable and legal
+bool verifyActionSpace(std::uint64_t startSeed, int battleCount) {
+    static const std::vector<CardId> cards { CardId::ARMAMENTS, CardId::WARCRY, CardId::HEADBUTT, CardId::BURNING_PACT,
+                                            CardId::PURITY, CardId::DUAL_WIELD, CardId::EXHUME, CardId::SECRET_TECHNIQUE,
+                                            CardId::SECRET_WEAPON, CardId::DISCOVERY, CardId::CLEAVE, CardId::TRIP };
+    static const std::vector<Potion> potions { Potion::FIRE_POTION, Potion::BLOCK_POTION, Potion::FAIRY_POTION,
+                                               Potion::GAMBLERS_BREW, Potion::LIQUID_MEMORIES, Potion::WEAK_POTION };
+    static const std::vector<MonsterEncounter> encounters { MonsterEncounter::JAW_WORM, MonsterEncounter::SMALL_SLIMES,
+                                                            MonsterEncounter::GREMLIN_GANG, MonsterEncounter::THREE_LOUSE };
+
+    std::int64_t stateCount = 0;
+    std::int64_t mismatchCount = 0;
+    std::array<std::uint8_t, search::ActionSpace::SIZE> mask {};
+
+    for (std::uint64_t seed = startSeed; seed < startSeed + battleCount; ++seed) {
+        RandomBattle battle(seed, cards, {}, potions, encounters);
+        auto &bc = battle.bc;
+
+        for (int step = 0; step < 1000 && bc.outcome == Outcome::UNDECIDED; ++step) {
+            const auto legalCount = search::ActionSpace::writeLegalityMask(bc, mask.data());
+
+            bool ok = legalCount == std::count(mask.begin(), mask.end(), 1);
+            for (int idx = 0; idx < search::ActionSpace::SIZE; ++idx) {
+                const auto a = search::ActionSpace::decode(idx);
+                bool expected = a.isValidAction(bc);
+                if (expected && a.getTargetIdx() != 0 && a.getTargetIdx() < search::ActionSpace::MAX_TARGETS) {
+                    // untargeted cards and potions only have their target 0 index
+                    if (a.getActionType() == search::ActionType::CARD) {
+                        expected = bc.cards.hand[a.getSourceIdx()].requiresTarget();
+                    } else if (a.getActionType() == search::ActionType::POTION) {
+                        expected = potionRequiresTarget(bc.potions[a.getSourceIdx()]);
+                    }
+                }
+                ok &= search::ActionSpace::encode(a) == idx && (mask[idx] != 0) == expected;
+            }
+
+            search::ActionList enumerated;
+            search::BattleScumSearcher2::enumerateActions(bc, enumerated);
+            if (bc.inputState == InputState::CARD_SELECT && (bc.cardSelectInfo.cardSelectTask == CardSelectTask::EXHAUST_MANY ||
+                                                             bc.cardSelectInfo.cardSelectTask == CardSelectTask::GAMBLE)) {
+                search::CardSubsetGenerator gen(bc);
+                for (auto a : gen.getNextPicks(bc.cardSelectInfo.multiSelect_PickedBits())) {
+                    enumerated.push_back(a);
+                }
+            }
+            for (auto a : enumerated) {
+                const auto idx = search::ActionSpace::encode(a);
+                ok &= idx >= 0 && mask[idx];
+            }
+
+            ++stateCount;
+            if (!ok || !battle.stepRandomly()) {
+                ++mismatchCount;
+                std::cout << "mismatch seed: " << seed << " step: " << step << " legal: " << legalCount << '\n';
+                break;
+            }
+        }
+    }
+
+    std::cout << "action space states: " << stateCount << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+// containsCardWithId for every queue size and front slot, each queued card at every position of the ring, in the
+// queue and in a copy of it
+bool verifyCardQueue() {
+    std::int64_t checkCount = 0;
+    std::int64_t mismatchCount = 0;
+
+    for (int front = 0; front < CardQueue::capacity; ++front) {
+        for (int size = 1; size <= CardQueue::capacity; ++size) {
+            CardQueue q;
+            for (int i = 0; i < front; ++i) {
+                q.pushBack(CardQueueItem(CardInstance(CardId::STRIKE_RED), 0, 0));
+                q.popFront();
+            }
+            for (int i = 0; i < size; ++i) {
+                CardInstance c(CardId::STRIKE_RED);
+                c.setUniqueId(100 + i);
+                q.pushBack(CardQueueItem(c, 0, 0));
+            }
+
+            const CardQueue copy(q);
+            for (int id = 99; id <= 100 + size; ++id) {
+                const bool expected = id >= 100 && id < 100 + size;
+                checkCount += 2;
+                if (q.containsCardWithId(id) != expected || copy.containsCardWithId(id) != expected) {
+                    ++mismatchCount;
+                    std::cout << "mismatch front: " << front << " size: " << size << " id: " << id << '\n';
+                }
+            }
+        }
+    }
+
+    std::cout << "card queue checks: " << checkCount << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+// checks every record of cardInfoTable against the functions in Cards.h it was generated from
+bool verifyCardInfo() {
+    int checkCount = 0;
+    int mismatchCount = 0;
+
+    for (int i = 0; i < CARD_ID_COUNT; ++i) {
+        const auto id = static_cast<CardId>(i);
+        for (int up = 0; up < 2; ++up) {
+            const auto &info = getCardInfo(id, up);
+            const bool matches = info.getType() == getCardType(id) &&
+                    info.getRarity() == getCardRarity(id) &&
+                    info.getColor() == getCardColor(id) &&
+                    info.cost == getEnergyCost(id, up) &&
+                    info.baseDamage == getBaseDamage(id, up) &&
+                    info.has(CardInfo::TARGETS_ENEMY) == cardTargetsEnemy(id, up) &&
+                    info.has(CardInfo::ETHEREAL) == isCardEthereal(id, up) &&
+                    info.has(CardInfo::EXHAUSTS) == doesCardExhaust(id, up) &&
+                    info.has(CardInfo::INNATE) == isCardInnate(id, up) &&
+                    info.has(CardInfo::SELF_RETAIN) == doesCardSelfRetain(id, up) &&
+                    info.has(CardInfo::X_COST) == isXCost(id) &&
+                    info.has(CardInfo::STRIKE) == isCardStrikeCard(id) &&
+                    info.has(CardInfo::STARTER_STRIKE_OR_DEFEND) == isStarterStrikeOrDefend(id);
+
+            const CardInstance c(id, up);
+            const bool instanceMatches = c.getType() == getCardType(id) &&
+                    c.cost == getEnergyCost(id, up) &&
+                    c.requiresTarget() == cardTargetsEnemy(id, up) &&
+                    c.isEthereal() == isCardEthereal(id, up) &&
+                    c.doesExhaust() == doesCardExhaust(id, up) &&
+                    c.hasSelfRetain() == doesCardSelfRetain(id, up) &&
+                    c.isXCost() == isXCost(id);
+
+            ++checkCount;
+            if (!matches || !instanceMatches) {
+                ++mismatchCount;
+                std::cout << "mismatch: " << getCardEnumName(id) << (up ? "+" : "") << '\n';
+            }
+        }
+    }
+
+    std::cout << "card info checks: " << checkCount << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+// checks every column of sampled rows of a seed table against a fully constructed GameContext of the same seed and a
+// path planner over its map
+bool verifySeedTable(const std::string &path, int sampleCount) {
+    const SeedTable table(path);
+    if (table.getRowCount() == 0) {
+        std::cout << "seed table has no rows" << std::endl;
+        return sampleCount == 0;
+    }
+    std::default_random_engine rng(table.getRowCount());
+    std::uniform_int_distribution<std::uint64_t> dist(0, table.getRowCount()-1);
+
+    std::int64_t mismatchCount = 0;
+    for (int i = 0; i < sampleCount; ++i) {
+        const auto rowIdx = dist(rng);
+        const auto seed = table.getStartSeed() + rowIdx;
+        const GameContext gc(CharacterClass::IRONCLAD, seed, table.getAscension());
+
+        SeedRow expected {};
+        for (int j = 0; j < 4; ++j) {
+            expected[NEOW_BONUS+j] = static_cast<std::uint8_t>(gc.info.neowRewards[j].r);
+            expected[NEOW_DRAWBACK+j] = static_cast<std::uint8_t>(gc.info.neowRewards[j].d);
+        }
+        expected[BOSS] = static_cast<std::uint8_t>(gc.boss);
+        for (int j = 0; j < gc.monsterList.size(); ++j) {
+            expected[MONSTERS+j] = static_cast<std::uint8_t>(gc.monsterList[j]);
+        }
+        for (int j = 0; j < gc.eliteMonsterList.size(); ++j) {
+            expected[ELITES+j] = static_cast<std::uint8_t>(gc.eliteMonsterList[j]);
+        }
+
+        const Map &map = *gc.map;
+        for (int y = 0; y < 15; ++y) {
+            for (int x = 0; x < 7; ++x) {
+                const auto room = map.getNode(x, y).room;
+                if (room <= Room::TREASURE) {
+                    ++expected[MAP_ROOMS+static_cast<int>(room)];
+                }
+            }
+        }
+        expected[BURNING_ELITE_X] = static_cast<std::uint8_t>(map.burningEliteX);
+        expected[BURNING_ELITE_Y] = static_cast<std::uint8_t>(map.burningEliteY);
+        expected[BURNING_ELITE_BUFF] = static_cast<std::uint8_t>(map.burningEliteBuff);
+
+        // the table scans every planner path, here each extreme is a query of its own
+        const MapPathPlanner planner(map);
+        const auto extremeCount = [&](PathObjective o, int direction) {
+            return static_cast<std::uint8_t>(planner.query(MapPathQuery().weight(o, direction))->getCount(o));
+        };
+        expected[PATH_MAX_ELITES] = extremeCount(PathObjective::ELITE, 1);
+        expected[PATH_MIN_ELITES] = extremeCount(PathObjective::ELITE, -1);
+        expected[PATH_MAX_RESTS] = extremeCount(PathObjective::REST, 1);
+        expected[PATH_MAX_SHOPS] = extremeCount(PathObjective::SHOP, 1);
+
+        if (table.getRow(rowIdx) != expected) {
+            ++mismatchCount;
+            std::cout << "mismatch seed: " << seed << '\n';
+        }
+    }
+
+    std::cout << "seed table rows: " << table.getRowCount() << " checked: " << sampleCount
+              << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+// terms are NAME=v1,v2,... or NAME=lo-hi, a group name without an index such as NEOW_BONUS matches any column of the group
+void querySeedTable(const std::string &path, int threadCount, const std::vector<std::string> &terms) {
+    const SeedTable table(path);
+
+    SeedFilter f;
+    for (const auto &term : terms) {
+        const auto eq = term.find('=');
+        const auto name = term.substr(0, eq);
+        const auto valueStr = term.substr(eq+1);
+
+        SeedFilter::Term t {getSeedColumnForName(name), 1};
+        if (t.firstColumn == -1) {
+            t.firstColumn = getSeedColumnForName(name + "_0");
+            while (getSeedColumnForName(name + "_" + std::to_string(t.columnCount)) != -1) {
+                ++t.columnCount;
+            }
+        }
+        if (t.firstColumn == -1) {
+            std::cout << "unknown column: " << name << std::endl;
+            return;
+        }
+
+        const auto dash = valueStr.find('-');
+        if (dash != std::string::npos && dash > 0) {
+            for (int v = std::stoi(valueStr.substr(0, dash)); v <= std::stoi(valueStr.substr(dash+1)); ++v) {
+                t.values[v] = true;
+            }
+        } else {
+            std::istringstream iss(valueStr);
+            std::string v;
+            while (std::getline(iss, v, ',')) {
+                t.values[static_cast<std::uint8_t>(std::stoi(v))] = true;
+            }
+        }
+        f.addTerm(t);
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const auto count = table.count(f, threadCount);
+    const auto seeds = table.select(f, 10, threadCount);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double>(endTime-startTime).count();
+
+    for (auto seed : seeds) {
+        std::cout << seed << " " << SeedHelper::getString(seed) << '\n';
+    }
+    std::cout << "rows: " << table.getRowCount()
+              << " matches: " << count
+              << " threads: " << threadCount
+              << " elapsed: " << duration
+              << std::endl;
+}
+
+namespace {
+
+    PathCounts getBruteForceRoomCounts(const Map &map, int x, int y) {
+        PathCounts ret = 0;
+        const auto room = map.nodes[y][x].room;
+        const int objective = room == Room::ELITE ? 0 : room == Room::REST ? 1 : room == Room::SHOP ? 2 :
+                              room == Room::EVENT ? 3 : room == Room::MONSTER ? 4 : -1;
+        if (objective != -1) {
+            ret += 1 << (4*objective);
+        }
+        if (room == Room::ELITE && map.burningEliteX == x && map.burningEliteY == y) {
+            ret += 1 << (4*static_cast<int>(PathObjective::BURNING_ELITE));
+        }
+        return ret;
+    }
+
+    // every path from (x, y) to the top of the map, without any pruning
+    void enumeratePaths(const Map &map, int x, int y, PathCounts counts, std::set<PathCounts> &out) {
+        const auto &node = map.nodes[y][x];
+        if (node.edgeCount == 0 || y == 14) {
+            out.insert(counts);
+            return;
+        }
+        for (int i = 0; i < node.edgeCount; ++i) {
+            const int nextX = node.edges[i];
+            enumeratePaths(map, nextX, y+1, counts + getBruteForceRoomCounts(map, nextX, y+1), out);
+        }
+    }
+
+    // the route must follow the map's edges and add up to the counts it is stored with
+    bool isValidPlannedRoute(const Map &map, const MapPath &path) {
+        PathCounts counts = 0;
+        for (int y = path.firstRow; y <= path.lastRow; ++y) {
+            const int x = path.getX(y);
+            if (y > path.firstRow) {
+                const auto &prev = map.nodes[y-1][path.getX(y-1)];
+                if (std::find(prev.edges.begin(), prev.edges.begin()+prev.edgeCount, x) == prev.edges.begin()+prev.edgeCount) {
+                    return false;
+                }
+            }
+            counts += getBruteForceRoomCounts(map, x, y);
+        }
+        return counts == path.counts;
+    }
+
+    bool checkPlanner(const Map &map, const MapPathPlanner &planner, const std::set<PathCounts> &all) {
+        std::set<PathCounts> planned;
+        for (const auto &p : planner.getPaths()) {
+            planned.insert(p.counts);
+            if (!isValidPlannedRoute(map, p)) {
+                return false;
+            }
+        }
+        if (planned != all) {
+            return false;
+        }
+
+        std::vector<MapPathQuery> queries;
+        for (int minRest = 0; minRest <= 4; ++minRest) {
+            queries.push_back(MapPathQuery().atLeast(PathObjective::REST, minRest).weight(PathObjective::ELITE, 1));
+        }
+        queries.push_back(MapPathQuery().atMost(PathObjective::ELITE, 1).weight(PathObjective::SHOP, 2).weight(PathObjective::MONSTER, -1));
+        queries.push_back(MapPathQuery().atLeast(PathObjective::BURNING_ELITE, 1).weight(PathObjective::REST, 1));
+
+        for (const auto &q : queries) {
+            std::optional<int> best;
+            for (auto counts : all) {
+                if (q.isSatisfiedBy(counts) && (!best || q.score(counts) > *best)) {
+                    best = q.score(counts);
+                }
+            }
+            const auto res = planner.query(q);
+            if (res.has_value() != best.has_value() ||
+                (res && (q.score(res->counts) != *best || !q.isSatisfiedBy(res->counts)))) {
+                return false;
+            }
+        }
+
+        const std::array<std::int8_t, PATH_OBJECTIVE_COUNT> directions {1, 1, 0, 0, -1, 0};
+        const auto normalize = [&](PathCounts counts) {
+            std::array<int, PATH_OBJECTIVE_COUNT> ret {};
+            for (int k = 0; k < PATH_OBJECTIVE_COUNT; ++k) {
+                ret[k] = directions[k] * static_cast<int>((counts >> (4*k)) & 0xF);
+            }
+            return ret;
+        };
+        std::set<std::array<int, PATH_OBJECTIVE_COUNT>> expectedFrontier;
+        for (auto a : all) {
+            const auto va = normalize(a);
+            const bool dominated = std::any_of(all.begin(), all.end(), [&](PathCounts b) {
+                const auto vb = normalize(b);
+                return vb != va && std::equal(va.begin(), va.end(), vb.begin(), [](int x, int y) { return x <= y; });
+            });
+            if (!dominated) {
+                expectedFrontier.insert(va);
+            }
+        }
+        std::set<std::array<int, PATH_OBJECTIVE_COUNT>> frontier;
+        for (const auto &p : planner.getParetoFrontier(directions)) {
+            frontier.insert(normalize(p.counts));
+        }
+        return frontier == expectedFrontier;
+    }
+
+}
+
+// the planner's counts, routes, queries and Pareto frontiers against brute force enumeration of every path, on the
+// maps of acts 1 to 4 of each seed and from a node on the fourth row
+bool verifyMapPathPlanner(std::uint64_t startSeed, int seedCount) {
+    std::int64_t mapCount = 0;
+    std::int64_t mismatchCount = 0;
+
+    for (auto seed = startSeed; seed < startSeed + seedCount; ++seed) {
+        for (int act = 1; act <= 4; ++act) {
+            const auto map = act == 4 ? Map::act4Map() : Map::fromSeed(seed, 0, act, true);
+
+            std::set<PathCounts> all;
+            for (int x = 0; x < 7; ++x) {
+                if (map.nodes[0][x].edgeCount > 0) {
+                    enumeratePaths(map, x, 0, getBruteForceRoomCounts(map, x, 0), all);
+                }
+            }
+            ++mapCount;
+            if (!checkPlanner(map, MapPathPlanner(map), all)) {
+                ++mismatchCount;
+                std::cout << "mismatch seed: " << seed << " act: " << act << '\n';
+            }
+
+            for (int x = 0; x < 7 && act < 4; ++x) {
+                if (map.nodes[3][x].edgeCount > 0) {
+                    std::set<PathCounts> fromNode;
+                    enumeratePaths(map, x, 3, 0, fromNode);
+                    MapPathPlanner planner;
+                    planner.init(map, x, 3);
+                    if (!checkPlanner(map, planner, fromNode)) {
+                        ++mismatchCount;
+                        std::cout << "mismatch seed: " << seed << " act: " << act << " from x: " << x << '\n';
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    std::cout << "map path planner maps: " << mapCount << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+namespace {
+
+    // parents are compared in increasing x, the order unpack lists them in
+    bool isSameMap(Map a, const Map &b) {
+        a.normalizeParents();
+        if (a.burningEliteX != b.burningEliteX || a.burningEliteY != b.burningEliteY ||
+            a.burningEliteBuff != b.burningEliteBuff) {
+            return false;
+        }
+        for (int y = 0; y < 15; ++y) {
+            for (int x = 0; x < 7; ++x) {
+                const auto &n0 = a.nodes[y][x];
+                const auto &n1 = b.nodes[y][x];
+                if (n0.x != n1.x || n0.y != n1.y || n0.room != n1.room ||
+                    n0.edgeCount != n1.edgeCount || n0.parentCount != n1.parentCount ||
+                    !std::equal(n0.edges.begin(), n0.edges.begin()+n0.edgeCount, n1.edges.begin()) ||
+                    !std::equal(n0.parents.begin(), n0.parents.begin()+n0.parentCount, n1.parents.begin())) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+}
+
+// unpack(pack(map)) against the generated map for acts 1 to 3 of each seed over a range of ascensions, and the act 4 map
+bool verifyPackedMap(std::uint64_t startSeed, int seedCount) {
+    std::int64_t mapCount = 0;
+    std::int64_t mismatchCount = 0;
+
+    const auto check = [&](const Map &map, const char *desc, std::uint64_t seed) {
+        const auto packed = PackedMap::pack(map);
+        const auto unpacked = packed.unpack();
+        ++mapCount;
+        if (!isSameMap(map, unpacked) || PackedMap::pack(unpacked) != packed || unpacked.toString() != map.toString()) {
+            ++mismatchCount;
+            std::cout << "mismatch " << desc << " seed: " << seed << '\n';
+        }
+    };
+
+    for (auto seed = startSeed; seed < startSeed + seedCount; ++seed) {
+        for (int act = 1; act <= 3; ++act) {
+            const Map map = Map::fromSeed(seed, static_cast<int>(seed % 21), act, seed % 2 == 0);
+            check(map, act == 1 ? "act 1" : act == 2 ? "act 2" : "act 3", seed);
+        }
+    }
+    check(Map::act4Map(), "act 4", 0);
+
+    std::cout << "packed maps: " << mapCount << " mismatches: " << mismatchCount << std::endl;
+    return mismatchCount == 0;
+}
+
+// max elites with at least minRest rest sites for acts 1 to 3 of every seed, prints how many paths reach each elite count
+void mapPlanBatch(std::uint64_t startSeed, int seedCount, int ascension, int threadCount, int minRest) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    MapPathQuery q;
+    q.atLeast(PathObjective::REST, minRest).weight(PathObjective::ELITE, 1);
+    const auto results = MapPathPlanner::queryBatch(startSeed, seedCount, ascension, {1, 2, 3}, q, threadCount);
+
+    std::array<int, 16> eliteCounts {};
+    int noPathCount = 0;
+    for (const auto &r : results) {
+        if (r.path) {
+            ++eliteCounts[r.path->getCount(PathObjective::ELITE)];
+        } else {
+            ++noPathCount;
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double>(endTime-startTime).count();
+
+    for (int i = 0; i < eliteCounts.size(); ++i) {
+        if (eliteCounts[i]) {
+            std::cout << "elites: " << i << " maps: " << eliteCounts[i] << '\n';
+        }
+    }
+    std::cout << "no path: " << noPathCount << '\n';
+    std::cout << "threads: " << threadCount
+              << " maps: " << results.size()
+              << " elapsed: " << duration
+              << std::endl;
+}
+
+// decodes every .autosave in a directory, optionally building a GameContext from each one and writing snapshots
+void ingestSaves(const std::string &dirPath, int threadCount, const std::string &snapshotOutPath, bool initGameContexts) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const auto paths = SaveFileBatch::listSaveFiles(dirPath);
+
+    std::mutex m;
+    std::vector<SaveFileBatchResult> results(paths.size());
+    std::int64_t failCount = 0;
+    std::int64_t floorSum = 0;
+
+    SaveFileBatch::forEach(paths, threadCount, CharacterClass::IRONCLAD, [&](std::size_t idx, SaveFileBatchResult &result) {
+        int floorNum = 0;
+        if (result.ok && initGameContexts) {
+            GameContext gc;
+            gc.initFromSave(result.save);
+            floorNum = gc.floorNum;
+        }
+
+        std::scoped_lock lock(m);
+        if (!result.ok) {
+            ++failCount;
+            std::cout << result.path << ": " << result.error << '\n';
+        }
+        floorSum += floorNum;
+        if (!snapshotOutPath.empty()) {
+            results[idx] = std::move(result);
+        }
+    });
+
+    if (!snapshotOutPath.empty()) {
+        SaveFileBatch::writeSnapshots(snapshotOutPath, results);
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double>(endTime-startTime).count();
+
+    std::cout << "files: " << paths.size()
+              << " failed: " << failCount;
+    if (initGameContexts) {
+        std::cout << " floorSum: " << floorSum;
+    }
+    std::cout << '\n';
+
+    std::cout << "threads: " << threadCount
+              << " elapsed: " << duration
+              << std::endl;
+}
+
+// decodeFast against Base64::decode on random data, then loadFromPathFast and the snapshot round trip against the full
+// SaveFile constructor for every save file in dirPath. a file both loaders reject counts as agreeing
+bool verifySaveLoad(const std::string &dirPath, int threadCount) {
+    std::int64_t base64MismatchCount = 0;
+    std::mt19937 rng(static_cast<std::uint32_t>(dirPath.size()));
+    for (int len = 0; len < 600; ++len) {
+        std::string raw(len, '\0');
+        for (auto &c : raw) {
+            c = static_cast<char>(rng());
+        }
+        const auto enc = Base64::encode(raw);
+        std::string wrapped; // line breaks every 76 characters like MIME output
+        for (std::size_t i = 0; i < enc.size(); i += 76) {
+            wrapped += enc.substr(i, 76) + "\r\n";
+        }
+
+        std::string fast;
+        Base64::decodeFast(enc.data(), enc.size(), fast);
+        std::string fastWrapped = "prefix";
+        Base64::decodeFast(wrapped.data(), wrapped.size(), fastWrapped);
+        if (fast != Base64::decode(enc) || fast != raw || fastWrapped != "prefix" + raw) {
+            ++base64MismatchCount;
+            std::cout << "base64 mismatch length: " << len << '\n';
+        }
+    }
+
+    const auto paths = SaveFileBatch::listSaveFiles(dirPath);
+    const auto results = SaveFileBatch::load(paths, threadCount, CharacterClass::IRONCLAD);
+
+    std::int64_t mismatchCount = 0;
+    std::int64_t rejectCount = 0;
+    for (const auto &result : results) {
+        const auto cc = SaveFileBatch::getCharacterClassFromPath(result.path, CharacterClass::IRONCLAD);
+
+        std::string expected;
+        try {
+            std::ostringstream os;
+            SaveFile::loadFromPath(result.path, cc).writeSnapshot(os);
+            expected = os.str();
+        } catch (const std::exception &e) {
+            if (result.ok) {
+                ++mismatchCount;
+                std::cout << result.path << ": only the full load failed: " << e.what() << '\n';
+            } else {
+                ++rejectCount;
+            }
+            continue;
+        }
+
+        if (!result.ok) {
+            ++mismatchCount;
+            std::cout << result.path << ": only the fast load failed: " << result.error << '\n';
+            continue;
+        }
+
+        std::ostringstream fast;
+        result.save.writeSnapshot(fast);
+        std::istringstream is(fast.str());
+        std::ostringstream roundTrip;
+        SaveFile::readSnapshot(is).writeSnapshot(roundTrip);
+
+        if (fast.str() != expected || roundTrip.str() != expected) {
+            ++mismatchCount;
+            std::cout << result.path << ": fields differ\n";
+        }
+    }
+
+    std::cout << "base64 checks: 600 mismatches: " << base64MismatchCount << '\n';
+    std::cout << "save files: " << results.size() << " rejected by both: " << rejectCount
+              << " mismatches: " << mismatchCount << std::endl;
+    return base64MismatchCount == 0 && mismatchCount == 0;
+}
+
+// runs every console simulator script in a directory, returns false if any script failed an assert
+bool runScripts(const std::string &dirPath, int threadCount, double outlierFactor) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const auto paths = ScriptBatch::listScripts(dirPath);
+
+    std::mutex m;
+    std::vector<ScriptResult> results(paths.size());
+    std::int64_t failCount = 0;
+
+    ScriptBatch::forEach(paths, threadCount, [&](std::size_t idx, ScriptResult &result) {
+        std::scoped_lock lock(m);
+        if (result.passed) {
+            std::cout << "PASS " << result.path;
+        } else {
+            ++failCount;
+            std::cout << "FAIL " << result.path << ": " << result.failure;
+        }
+        std::cout << " lines: " << result.lineCount << " elapsed: " << result.seconds << '\n';
+        results[idx] = std::move(result);
+    });
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double>(endTime-startTime).count();
+
+    std::int64_t lineSum = 0;
+    double secondsSum = 0;
+    std::vector<double> times;
+    for (const auto &r : results) {
+        lineSum += r.lineCount;
+        secondsSum += r.seconds;
+        times.push_back(r.seconds);
+    }
+
+    if (!times.empty()) {
+        std::nth_element(times.begin(), times.begin() + times.size()/2, times.end());
+        const double median = times[times.size()/2];
+        std::cout << "median elapsed: " << median << " outliers (>" << outlierFactor << "x median):\n";
+        for (const auto &r : results) {
+            if (r.seconds > median * outlierFactor) {
+                std::cout << "\t" << r.path << " elapsed: " << r.seconds << '\n';
+            }
+        }
+    }
+
+    std::cout << "scripts: " << paths.size()
+              << " passed: " << paths.size() - failCount
+              << " failed: " << failCount
+              << " lines: " << lineSum << '\n';
+
+    std::cout << "threads: " << threadCount
+              << " lines/s: " << (duration > 0 ? lineSum / duration : 0)
+              << " lines/s per thread: " << (secondsSum > 0 ? lineSum / secondsSum : 0)
+              << " elapsed: " << duration
+              << std::endl;
+
+    return failCount == 0;
+}
+
+// plays simple agent games and logs a calibration sample at the start of each of the player's turns, the targets are
+// the mean outcome of rolloutCount playouts with RolloutPolicy::epsilonMix(epsilon)
+void logEvaluatorSamples(std::uint64_t startSeed, int gameCount, int ascension, int rolloutCount, double epsilon,
+                         search::EvaluatorCalibration &calibration) {
+    const auto policy = search::RolloutPolicy::epsilonMix(epsilon);
+    for (std::uint64_t seed = startSeed; seed < startSeed + gameCount; ++seed) {
+        GameContext gc(CharacterClass::IRONCLAD, seed, ascension);
+        search::SimpleAgent agent;
+        agent.curGameContext = &gc;
+        std::default_random_engine rng(seed);
+
+        while (gc.outcome == GameOutcome::UNDECIDED) {
+            if (gc.screenState != ScreenState::BATTLE) {
+                agent.stepOutOfCombat(gc);
+                continue;
+            }
+
+            // the same steps as SimpleAgent::playoutBattle
+            BattleContext bc;
+            bc.init(gc);
+            bool usedPotions = !isBossEncounter(bc.encounter);
+            int loggedTurn = -1;
+            while (bc.outcome == Outcome::UNDECIDED) {
+                if (bc.inputState == InputState::CARD_SELECT) {
+                    agent.stepBattleCardSelect(bc);
+                    continue;
+                }
+                if (bc.turn != loggedTurn) {
+                    loggedTurn = bc.turn;
+                    calibration.addSample(bc, policy, rolloutCount, rng);
+                }
+                if (usedPotions) {
+                    agent.stepBattleCardPlay(bc);
+                } else {
+                    usedPotions = agent.playPotion(bc);
+                }
+            }
+            bc.exitBattle(gc);
+        }
+        std::cout << "seed: " << seed << " floor: " << gc.floorNum << " samples: " << calibration.samples.size() << '\n';
+    }
+}
+
+// fits on every sample but each fifth, which are held out to compare the fit with evaluateTruncatedState and the
+// current StaticEvaluator::intentAware weights
+void fitEvaluator(const std::string &logPath, double ridge, const std::string &weightsPath) {
+    search::EvaluatorCalibration all;
+    std::ifstream is(logPath);
+    all.readSamples(is);
+
+    search::EvaluatorCalibration train;
+    search::EvaluatorCalibration test;
+    for (int i = 0; i < all.samples.size(); ++i) {
+        (i % 5 == 4 ? test : train).samples.push_back(all.samples[i]);
+    }
+
+    const auto fitted = train.fit(ridge);
+    const auto current = search::StaticEvaluator::intentAware();
+    for (int i = 0; i < search::EVAL_FEATURE_COUNT; ++i) {
+        std::cout << search::evalFeatureStrings[i] << ": " << fitted.weights[i] << '\n';
+    }
+
+    const auto printErrors = [](const char *name, double mse, double variance) {
+        std::cout << name << " mse: " << mse << " r2: " << (variance > 0 ? 1 - mse / variance : 0) << '\n';
+    };
+    std::cout << "samples: " << all.samples.size() << " train: " << train.samples.size()
+              << " test: " << test.samples.size() << '\n';
+    printErrors("fit train", train.getMeanSquaredError(fitted), train.getTargetVariance());
+    printErrors("fit test", test.getMeanSquaredError(fitted), test.getTargetVariance());
+    printErrors("intentAware test", test.getMeanSquaredError(current), test.getTargetVariance());
+    printErrors("evaluateTruncatedState test", test.getBaselineMeanSquaredError(), test.getTargetVariance());
+
+    if (!weightsPath.empty()) {
+        std::ofstream(weightsPath) << fitted.toJson().dump(2) << '\n';
+    }
+}
+
 int main(int argc, const char* argv[]) {
 
     if (argc < 2) {
@@ -280,12 +1557,75 @@ int main(int argc, const char* argv[]) {
         const std::uint64_t startSeedLong(std::stoull(argv[5]));
         const int playoutCount(std::stoi(argv[6]));
         const int printLevel = std::stoi(argv[7]);
+        g_nodeBudget = argc > 8 ? std::stoll(argv[8]) : 0;
+        g_determinizationCount = argc > 9 ? std::stoi(argv[9]) : 1;
+        g_ensembleThreadCount = argc > 10 ? std::stoi(argv[10]) : 1;
+        g_wideningBase = argc > 11 ? std::stod(argv[11]) : 0;
+        g_priorWeight = argc > 12 ? std::stod(argv[12]) : 0;
+        g_multiSelectMode = static_cast<search::MultiSelectMode>(argc > 13 ? std::stoi(argv[13]) : 0);
         g_print_level = printLevel;
         g_searchAscension = ascensionIn;
         g_simulationCount = depthArg;
 
         agentMt(threadCount, startSeedLong, playoutCount);
 
+    } if (command == "agent_compare") {
+        const int threadCount(std::stoi(argv[2]));
+        const int ascension(std::stoi(argv[3]));
+        const std::uint64_t startSeed(std::stoull(argv[4]));
+        const int maxPairs(std::stoi(argv[5]));
+        const auto configA = nlohmann::json::parse(argv[6]);
+        const auto configB = nlohmann::json::parse(argv[7]);
+        const std::string reportPath(argc > 8 ? argv[8] : "");
+
+        search::AgentComparison ac;
+        ac.agentA = search::AgentComparison::makeAgent(configA, ascension);
+        ac.agentB = search::AgentComparison::makeAgent(configB, ascension);
+        ac.threadCount = threadCount;
+        ac.startSeed = startSeed;
+        ac.maxPairs = maxPairs;
+        ac.alpha = argc > 9 ? std::stod(argv[9]) : ac.alpha;
+        ac.floorTolerance = argc > 10 ? std::stod(argv[10]) : ac.floorTolerance;
+        ac.winRateTolerance = argc > 11 ? std::stod(argv[11]) : ac.winRateTolerance;
+        ac.onPair = [](const search::PairedPlayout &p, const search::AgentComparison &ac) {
+            std::cout << "seed: " << p.seed
+                      << " a: " << (p.a.won ? "W" : "L") << p.a.floorNum
+                      << " b: " << (p.b.won ? "W" : "L") << p.b.floorNum
+                      << " winDiff: " << ac.winDifference.mean
+                      << " floorDiff: " << ac.floorDifference.mean
+                      << " " << search::comparisonDecisionStrings[static_cast<int>(ac.winDecision)]
+                      << " " << search::comparisonDecisionStrings[static_cast<int>(ac.floorDecision)] << '\n';
+        };
+        ac.run();
+
+        const auto report = ac.getReport(configA, configB);
+        std::cout << "pairs: " << ac.pairs.size() << " resolved: " << ac.isResolved()
+                  << " winRate: " << report["winRate"]["decision"].get<std::string>()
+                  << " floor: " << report["floor"]["decision"].get<std::string>()
+                  << " elapsed: " << ac.seconds << std::endl;
+        if (!reportPath.empty()) {
+            std::ofstream(reportPath) << report.dump(2) << '\n';
+        }
+
+    } if (command == "evaluator_log") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int gameCount(std::stoi(argv[3]));
+        const int ascension(std::stoi(argv[4]));
+        const int rolloutCount(std::stoi(argv[5]));
+        const double epsilon(std::stod(argv[6]));
+        const std::string logPath(argv[7]);
+
+        search::EvaluatorCalibration calibration;
+        logEvaluatorSamples(startSeed, gameCount, ascension, rolloutCount, epsilon, calibration);
+        std::ofstream os(logPath, std::ios::app);
+        calibration.writeSamples(os);
+
+    } if (command == "evaluator_fit") {
+        const std::string logPath(argv[2]);
+        const double ridge(argc > 3 ? std::stod(argv[3]) : 0.001);
+        const std::string weightsPath(argc > 4 ? argv[4] : "");
+        fitEvaluator(logPath, ridge, weightsPath);
+
     } if (command == "simple_agent_mt") { // actually doing tree search now
         const int threadCount(std::stoi(argv[2]));
         const std::uint64_t startSeedLong(std::stoull(argv[3]));
@@ -305,6 +1645,129 @@ int main(int argc, const char* argv[]) {
         outFileStream << SaveFile::getJsonFromSaveFile(saveFilePath);
         outFileStream.close();
 
+    } else if (command == "verify_damage") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int stateCount(std::stoi(argv[3]));
+        if (!verifyDamageModifiers(startSeed, stateCount)) {
+            return 1;
+        }
+
+    } else if (command == "verify_card_subsets") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int stateCount(std::stoi(argv[3]));
+        if (!verifyCardSubsets(startSeed, stateCount)) {
+            return 1;
+        }
+
+    } else if (command == "verify_action_space") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int battleCount(std::stoi(argv[3]));
+        if (!verifyActionSpace(startSeed, battleCount)) {
+            return 1;
+        }
+
+    } else if (command == "verify_monster_kernels") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int battleCount(std::stoi(argv[3]));
+        if (!verifyMonsterKernels(startSeed, battleCount)) {
+            return 1;
+        }
+
+    } else if (command == "verify_card_queue") {
+        if (!verifyCardQueue()) {
+            return 1;
+        }
+
+    } else if (command == "verify_card_info") {
+        if (!verifyCardInfo()) {
+            return 1;
+        }
+
+    } else if (command == "verify_rng_oracle") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int gameCount(std::stoi(argv[3]));
+        if (!verifyRngOracle(startSeed, gameCount)) {
+            return 1;
+        }
+
+    } else if (command == "map_plan") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int seedCount(std::stoi(argv[3]));
+        const int ascension(std::stoi(argv[4]));
+        const int threadCount(std::stoi(argv[5]));
+        const int minRest(std::stoi(argv[6]));
+
+        mapPlanBatch(startSeed, seedCount, ascension, threadCount, minRest);
+
+    } else if (command == "verify_map_planner") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int seedCount(std::stoi(argv[3]));
+
+        if (!verifyMapPathPlanner(startSeed, seedCount)) {
+            return 1;
+        }
+
+    } else if (command == "verify_packed_map") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const int seedCount(std::stoi(argv[3]));
+
+        if (!verifyPackedMap(startSeed, seedCount)) {
+            return 1;
+        }
+
+    } else if (command == "seed_table_write") {
+        const std::string path(argv[2]);
+        const std::uint64_t startSeed(std::stoull(argv[3]));
+        const std::uint64_t seedCount(std::stoull(argv[4]));
+        const int ascension(std::stoi(argv[5]));
+        const int threadCount(std::stoi(argv[6]));
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        try {
+            SeedTable::write(path, startSeed, seedCount, ascension, threadCount);
+        } catch (const std::exception &e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        auto endTime = std::chrono::high_resolution_clock::now();
+        std::cout << "seeds: " << seedCount
+                  << " threads: " << threadCount
+                  << " elapsed: " << std::chrono::duration<double>(endTime-startTime).count()
+                  << std::endl;
+
+    } else if (command == "seed_table_verify") {
+        if (!verifySeedTable(argv[2], std::stoi(argv[3]))) {
+            return 1;
+        }
+
+    } else if (command == "seed_table_query") {
+        querySeedTable(argv[2], std::stoi(argv[3]), std::vector<std::string>(argv+4, argv+argc));
+
+    } else if (command == "ingest_saves") {
+        const std::string dirPath(argv[2]);
+        const int threadCount(std::stoi(argv[3]));
+        const std::string snapshotOutPath(argc > 4 && std::string(argv[4]) != "-" ? argv[4] : ""); // - to skip
+        const bool initGameContexts = argc > 5 && std::string(argv[5]) == "gc";
+
+        ingestSaves(dirPath, threadCount, snapshotOutPath, initGameContexts);
+
+    } else if (command == "verify_save_load") {
+        const std::string dirPath(argv[2]);
+        const int threadCount(argc > 3 ? std::stoi(argv[3]) : 1);
+
+        if (!verifySaveLoad(dirPath, threadCount)) {
+            return 1;
+        }
+
+    } else if (command == "run_scripts") {
+        const std::string dirPath(argv[2]);
+        const int threadCount(std::stoi(argv[3]));
+        const double outlierFactor = argc > 4 ? std::stod(argv[4]) : 4.0;
+
+        if (!runScripts(dirPath, threadCount, outlierFactor)) {
+            return 1;
+        }
+
     } else if (command == "json_to_save") {
         const std::string jsonInPath(argv[2]);
         const std::string saveFileOutPath(argv[3]);
@@ -321,9 +1784,16 @@ int main(int argc, const char* argv[]) {
         }
 
     } else if (command == "mcts_save") {
-        return mcts(argc, argv);
+        mcts(argc, argv);
+
+    } else if (command == "sizes") {
+        printSizes();
     }
 
+#ifdef sts_profile
+    profile::print(std::cout, profile::collect());
+#endif
+
     //    printSizes();
 //    std::cout << SeedHelper::getString(77) << '\n';
 //    playRandom();
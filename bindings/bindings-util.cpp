@@ -74,8 +74,8 @@ namespace sts {
             int battleOffset = 412;
 
             // ===== 玩家基础战斗状态 [412-415] =====
-            ret[battleOffset++] = std::max(0, bc->player.energy);
-            ret[battleOffset++] = std::max(0, bc->player.block);
+            ret[battleOffset++] = std::max(0, static_cast<int>(bc->player.energy));
+            ret[battleOffset++] = std::max(0, static_cast<int>(bc->player.block));
             ret[battleOffset++] = bc->player.strength;
             ret[battleOffset++] = bc->player.dexterity;
 
@@ -103,14 +103,14 @@ namespace sts {
             }
 
             // ===== 敌人意图信息 [451-465] (5敌人 * 3属性) =====
+            IntentSummary intents;
+            bc->monsters.getIntentSummary(*bc, intents);
             for (int i = 0; i < 5; ++i) {
                 const auto &m = bc->monsters.arr[i];
                 if (m.isAlive()) {
-                    DamageInfo dInfo = m.getMoveBaseDamage(*bc);
-                    int calculatedDamage = m.calculateDamageToPlayer(*bc, dInfo.damage);
-                    ret[battleOffset++] = calculatedDamage;       // 计算后的单次伤害
-                    ret[battleOffset++] = dInfo.attackCount;      // 攻击次数
-                    ret[battleOffset++] = m.isAttacking() ? 1 : 0; // 是否攻击
+                    ret[battleOffset++] = intents.damage[i].damage;       // 计算后的单次伤害
+                    ret[battleOffset++] = intents.damage[i].attackCount;      // 攻击次数
+                    ret[battleOffset++] = intents.attacking.test(i) ? 1 : 0; // 是否攻击
                 } else {
                     battleOffset += 3;
                 }
@@ -6,6 +6,7 @@
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 
 #include <sstream>
 #include <algorithm>
@@ -15,9 +16,12 @@
 #include "sim/search/BattleScumSearcher2.h"
 #include "sim/search/GameAction.h"
 #include "sim/search/Action.h"
+#include "sim/search/ActionSpace.h"
+#include "sim/search/StaticEvaluator.h"
 #include "sim/SimHelpers.h"
 #include "sim/PrintHelpers.h"
 #include "game/Game.h"
+#include "game/MapPathPlanner.h"
 #include "combat/BattleContext.h"
 
 #include "slaythespire.h"
@@ -25,12 +29,159 @@
 
 using namespace sts;
 
+namespace {
+
+    template <typename M, typename = void>
+    struct FieldType { typedef M type; };
+
+    template <typename M>
+    struct FieldType<M, std::enable_if_t<std::is_enum_v<M>>> { typedef std::underlying_type_t<M> type; };
+
+    // a numpy structured dtype over some fields of T, with T's own size so arrays of T can be viewed in place.
+    // offsets come from member pointers on a probe object because Player isn't standard layout
+    template <typename T>
+    class StructuredDtype {
+        pybind11::list names;
+        pybind11::list formats;
+        pybind11::list offsets;
+
+    public:
+        template <typename M>
+        StructuredDtype& field(const char *name, M T::*member) {
+            static const T probe {};
+            names.append(name);
+            formats.append(pybind11::dtype::of<typename FieldType<M>::type>());
+            offsets.append(reinterpret_cast<const char*>(&(probe.*member)) - reinterpret_cast<const char*>(&probe));
+            return *this;
+        }
+
+        [[nodiscard]] pybind11::dtype build() const {
+            return pybind11::dtype(names, formats, offsets, sizeof(T));
+        }
+    };
+
+    const pybind11::dtype& getCardDtype() {
+        static const auto dt = StructuredDtype<CardInstance>()
+                .field("id", &CardInstance::id)
+                .field("unique_id", &CardInstance::uniqueId)
+                .field("special_data", &CardInstance::specialData)
+                .field("cost", &CardInstance::cost)
+                .field("cost_for_turn", &CardInstance::costForTurn)
+                .field("upgraded", &CardInstance::upgraded)
+                .field("free_to_play_once", &CardInstance::freeToPlayOnce)
+                .field("retain", &CardInstance::retain)
+                .build();
+        return dt;
+    }
+
+    const pybind11::dtype& getMonsterDtype() {
+        static const auto dt = StructuredDtype<Monster>()
+                .field("idx", &Monster::idx)
+                .field("id", &Monster::id)
+                .field("cur_hp", &Monster::curHp)
+                .field("max_hp", &Monster::maxHp)
+                .field("block", &Monster::block)
+                .field("half_dead", &Monster::halfDead)
+                .field("status_bits", &Monster::statusBits)
+                .field("artifact", &Monster::artifact)
+                .field("metallicize", &Monster::metallicize)
+                .field("plated_armor", &Monster::platedArmor)
+                .field("poison", &Monster::poison)
+                .field("regen", &Monster::regen)
+                .field("shackled", &Monster::shackled)
+                .field("strength", &Monster::strength)
+                .field("vulnerable", &Monster::vulnerable)
+                .field("weak", &Monster::weak)
+                .field("unique_power0", &Monster::uniquePower0)
+                .field("unique_power1", &Monster::uniquePower1)
+                .field("misc_info", &Monster::miscInfo)
+                .build();
+        return dt;
+    }
+
+    const pybind11::dtype& getPlayerDtype() {
+        static const auto dt = StructuredDtype<Player>()
+                .field("gold", &Player::gold)
+                .field("cur_hp", &Player::curHp)
+                .field("max_hp", &Player::maxHp)
+                .field("energy", &Player::energy)
+                .field("energy_per_turn", &Player::energyPerTurn)
+                .field("card_draw_per_turn", &Player::cardDrawPerTurn)
+                .field("stance", &Player::stance)
+                .field("orb_slots", &Player::orbSlots)
+                .field("block", &Player::block)
+                .field("artifact", &Player::artifact)
+                .field("dexterity", &Player::dexterity)
+                .field("focus", &Player::focus)
+                .field("strength", &Player::strength)
+                .field("status_bits0", &Player::statusBits0)
+                .field("status_bits1", &Player::statusBits1)
+                .field("relic_bits0", &Player::relicBits0)
+                .field("relic_bits1", &Player::relicBits1)
+                .build();
+        return dt;
+    }
+
+    // a read only array over memory owned by the BattleContext in owner, owner is kept alive by the array.
+    // it aliases the live battle, so after stepping the battle take a new view, a pile may have been reallocated
+    template <typename T>
+    pybind11::array makeView(const pybind11::dtype &dt, const T *data, std::vector<pybind11::ssize_t> shape, pybind11::handle owner) {
+        std::vector<pybind11::ssize_t> strides(shape.size(), static_cast<pybind11::ssize_t>(sizeof(T)));
+        pybind11::array ret(dt, std::move(shape), std::move(strides), data, owner);
+        ret.attr("setflags")(pybind11::arg("write") = false);
+        return ret;
+    }
+
+    template <typename Container>
+    pybind11::array makePileView(const Container &pile, pybind11::handle owner) {
+        // not data(), so it also works with sts_card_manager_use_fixed_list
+        const CardInstance *data = pile.begin() == pile.end() ? nullptr : &*pile.begin();
+        return makeView(getCardDtype(), data, {static_cast<pybind11::ssize_t>(pile.size())}, owner);
+    }
+
+}
+
 PYBIND11_MODULE(slaythespire, m) {
     m.doc() = "pybind11 example plugin"; // optional module docstring
     m.def("play", &sts::py::play, "play Slay the Spire Console");
     m.def("get_seed_str", &SeedHelper::getString, "gets the integral representation of seed string used in the game ui");
     m.def("get_seed_long", &SeedHelper::getLong, "gets the seed string representation of an integral seed");
     m.def("getNNInterface", &sts::NNInterface::getInstance, "gets the NNInterface object");
+    m.def("get_profile_counters", []() {
+        const auto c = profile::collect();
+        pybind11::dict cardPlays;
+        for (int i = 0; i < profile::CARD_ID_COUNT; ++i) {
+            if (c.cardPlayCount[i]) {
+                cardPlays[cardEnumStrings[i]] = pybind11::make_tuple(c.cardPlayCount[i], c.cardPlayCycles[i]);
+            }
+        }
+        pybind11::dict monsterTurns;
+        for (int i = 0; i < profile::MONSTER_ID_COUNT; ++i) {
+            if (c.monsterTurnCount[i]) {
+                monsterTurns[monsterIdStrings[i]] = pybind11::make_tuple(c.monsterTurnCount[i], c.monsterTurnCycles[i]);
+            }
+        }
+        pybind11::dict searchPhases;
+        for (int i = 0; i < profile::SEARCH_PHASE_COUNT; ++i) {
+            searchPhases[profile::searchPhaseStrings[i]] = pybind11::make_tuple(c.searchPhaseCount[i], c.searchPhaseCycles[i]);
+        }
+
+        pybind11::dict ret;
+        ret["card_plays"] = cardPlays;
+        ret["monster_turns"] = monsterTurns;
+        ret["search_phases"] = searchPhases;
+        ret["action_queue_pushes"] = c.actionQueuePushCount;
+        ret["action_queue_pops"] = c.actionQueuePopCount;
+        ret["action_queue_max_depth"] = c.actionQueueMaxDepth;
+        ret["battle_context_copies"] = c.battleContextCopies;
+        return ret;
+    }, "merged profiling counters of all threads as (count, cycles) pairs, all zero unless built with sts_profile");
+    m.def("reset_profile_counters", &profile::reset, "zero the profiling counters of all threads");
+    m.def("print_profile_counters", []() {
+        std::ostringstream oss;
+        profile::print(oss, profile::collect());
+        return oss.str();
+    }, "formatted table of the merged profiling counters");
 
     pybind11::class_<NNInterface> nnInterface(m, "NNInterface");
     nnInterface
@@ -44,6 +195,8 @@ PYBIND11_MODULE(slaythespire, m) {
         .def("getObservationMaximums", &NNInterface::getObservationMaximums, "get the defined maximum values of the observation space")
         .def_property_readonly("observation_space_size", [](const NNInterface&) { return NNInterface::observation_space_size; });
 
+    m.attr("ACTION_SPACE_SIZE") = search::ActionSpace::SIZE;
+
     // GameAction class for RL step-by-step control (out of combat)
     pybind11::class_<search::GameAction> gameAction(m, "GameAction");
     gameAction.def(pybind11::init<>())
@@ -75,6 +228,8 @@ PYBIND11_MODULE(slaythespire, m) {
         .def("execute", &search::Action::execute, "Execute this combat action")
         .def("is_valid", &search::Action::isValidAction, "Check if this combat action is valid")
         .def_static("enumerate_card_select", &search::Action::enumerateCardSelectActions, "Get card select actions")
+        .def_static("from_index", &search::ActionSpace::decode, "the action at an index of the fixed action space")
+        .def_property_readonly("index", &search::ActionSpace::encode, "index in the fixed action space, -1 if it has none")
         .def_property_readonly("bits", [](const search::Action &a) { return a.bits; })
         .def_property_readonly("action_type", &search::Action::getActionType)
         .def_property_readonly("source_idx", &search::Action::getSourceIdx)
@@ -119,6 +274,18 @@ PYBIND11_MODULE(slaythespire, m) {
             }
             return 0;
         })
+        .def_property_readonly("incoming_damage", [](const BattleContext &bc) { return bc.monsters.getIncomingDamage(bc); })
+        .def_property_readonly("unblocked_incoming_damage", [](const BattleContext &bc) {
+            return std::max(0, bc.monsters.getIncomingDamage(bc) - bc.player.block);
+        })
+        .def("get_monster_intent", [](const BattleContext &bc, int idx) {
+            if (idx >= 0 && idx < bc.monsters.monsterCount) {
+                IntentSummary s;
+                bc.monsters.getIntentSummary(bc, s);
+                return pybind11::make_tuple(s.damage[idx].damage, s.damage[idx].attackCount, s.attacking.test(idx));
+            }
+            return pybind11::make_tuple(0, 0, false);
+        }, "(damage per hit, hit count, is attacking) of a monster's current move")
         .def("get_all_actions", [](const BattleContext &bc) {
             std::vector<search::Action> actions;
             
@@ -170,6 +337,33 @@ PYBIND11_MODULE(slaythespire, m) {
             
             return actions;
         }, "Get all valid combat actions")
+        .def("hand_view", [](pybind11::object self) {
+            const auto &bc = self.cast<const BattleContext&>();
+            return makeView(getCardDtype(), bc.cards.hand.data(), {static_cast<pybind11::ssize_t>(bc.cards.cardsInHand)}, self);
+        }, "read only structured array over the cards in hand, valid until the battle changes")
+        .def("draw_pile_view", [](pybind11::object self) {
+            return makePileView(self.cast<const BattleContext&>().cards.drawPile, self);
+        }, "read only structured array over the draw pile, the top card is last")
+        .def("discard_pile_view", [](pybind11::object self) {
+            return makePileView(self.cast<const BattleContext&>().cards.discardPile, self);
+        })
+        .def("exhaust_pile_view", [](pybind11::object self) {
+            return makePileView(self.cast<const BattleContext&>().cards.exhaustPile, self);
+        })
+        .def("monster_view", [](pybind11::object self) {
+            const auto &bc = self.cast<const BattleContext&>();
+            return makeView(getMonsterDtype(), bc.monsters.arr.data(), {static_cast<pybind11::ssize_t>(bc.monsters.monsterCount)}, self);
+        }, "read only structured array over the monsters, dead ones included")
+        .def("player_view", [](pybind11::object self) {
+            return makeView(getPlayerDtype(), &self.cast<const BattleContext&>().player, {}, self);
+        }, "read only 0-d structured array over the player's hot fields")
+        .def("write_legal_action_mask", [](const BattleContext &bc, pybind11::buffer out) {
+            const auto info = out.request(true);
+            if (info.itemsize != 1 || info.ndim != 1 || info.strides[0] != 1 || info.size < search::ActionSpace::SIZE) {
+                throw pybind11::value_error("expected a contiguous uint8 buffer of at least ACTION_SPACE_SIZE bytes");
+            }
+            return search::ActionSpace::writeLegalityMask(bc, static_cast<std::uint8_t*>(info.ptr));
+        }, "writes 1 for each legal index of the fixed action space into out, returns the number of legal actions")
         .def("__repr__", [](const BattleContext &bc) {
             std::ostringstream oss;
             oss << "<BattleContext turn=" << bc.turn 
@@ -180,6 +374,36 @@ PYBIND11_MODULE(slaythespire, m) {
             return oss.str();
         });
 
+    pybind11::class_<search::RolloutPolicy> rolloutPolicy(m, "RolloutPolicy");
+    rolloutPolicy.def(pybind11::init<>())
+        .def_static("uniform", &search::RolloutPolicy::uniform, "choose uniformly at random from all valid actions")
+        .def_static("heuristic", &search::RolloutPolicy::heuristic, "play cards the way the simple agent does")
+        .def_static("epsilon_mix", &search::RolloutPolicy::epsilonMix, "play heuristically, but choose a uniformly random action with probability epsilon")
+        .def_readwrite("max_actions", &search::RolloutPolicy::maxActions, "cut off playouts after this many actions, 0 for no limit")
+        .def_readwrite("max_turns", &search::RolloutPolicy::maxTurns, "cut off playouts after this many turns, 0 for no limit")
+        .def("set_cutoff_eval_fn", [](search::RolloutPolicy &p, const search::EvalFnc &fn) {
+            p.cutoffEvalFnc = fn;
+        })
+        .def("set_static_evaluator", [](search::RolloutPolicy &p, const search::StaticEvaluator &e) {
+            p.cutoffEvalFnc = e.getEvalFnc();
+        }, "score cut off playouts with the evaluator instead of a python callback");
+
+    pybind11::class_<search::StaticEvaluator> staticEvaluator(m, "StaticEvaluator");
+    staticEvaluator.def(pybind11::init<>())
+        .def_static("intent_aware", &search::StaticEvaluator::intentAware, "weights fit against the outcomes of full playouts")
+        .def_static("feature_names", []() {
+            return std::vector<std::string>(std::begin(search::evalFeatureStrings), std::end(search::evalFeatureStrings));
+        })
+        .def_static("features", [](const BattleContext &bc) {
+            search::EvalFeatures features;
+            search::getEvalFeatures(bc, features);
+            return features;
+        }, "the feature values of a battle state, in feature_names order")
+        .def_readwrite("weights", &search::StaticEvaluator::weights, "one weight per feature, in feature_names order")
+        .def("evaluate", [](const search::StaticEvaluator &e, const BattleContext &bc) {
+            return e.evaluate(bc);
+        }, "scores a battle state on the scale of the end of battle evaluation");
+
     pybind11::class_<search::BattleScumSearcher2> battleSearcher(m, "BattleScumSearcher2");
     battleSearcher
         .def(pybind11::init<const BattleContext &>())
@@ -189,6 +413,12 @@ PYBIND11_MODULE(slaythespire, m) {
         .def_readwrite("outcome_player_hp", &search::BattleScumSearcher2::outcomePlayerHp)
         .def_readwrite("best_action_value", &search::BattleScumSearcher2::bestActionValue)
         .def_readwrite("min_action_value", &search::BattleScumSearcher2::minActionValue)
+        .def_readwrite("rollout_policy", &search::BattleScumSearcher2::rolloutPolicy)
+        .def_readwrite("node_budget", &search::BattleScumSearcher2::nodeBudget, "prune the tree when it holds more nodes than this, 0 for no limit")
+        .def_readonly("node_count", &search::BattleScumSearcher2::nodeCount)
+        .def_readonly("peak_node_count", &search::BattleScumSearcher2::peakNodeCount)
+        .def_readonly("reclaimed_node_count", &search::BattleScumSearcher2::reclaimedNodeCount)
+        .def_static("node_budget_for_bytes", &search::BattleScumSearcher2::nodeBudgetForBytes)
         .def("set_eval_fn", [](search::BattleScumSearcher2 &s, const search::EvalFnc &fn) {
             s.evalFnc = fn;
         });
@@ -199,6 +429,10 @@ PYBIND11_MODULE(slaythespire, m) {
         .def_readwrite("boss_simulation_multiplier", &search::ScumSearchAgent2::bossSimulationMultiplier, "bonus multiplier to the simulation count for boss fights")
         .def_readwrite("pause_on_card_reward", &search::ScumSearchAgent2::pauseOnCardReward, "causes the agent to pause so as to cede control to the user when it encounters a card reward choice")
         .def_readwrite("print_logs", &search::ScumSearchAgent2::printLogs, "when set to true, the agent prints state information as it makes actions")
+        .def_readwrite("rollout_policy", &search::ScumSearchAgent2::rolloutPolicy, "the policy used to finish battles from the leaves of the search tree")
+        .def_readwrite("node_budget", &search::ScumSearchAgent2::nodeBudget, "node budget for each search tree, 0 for no limit")
+        .def_readonly("peak_node_count", &search::ScumSearchAgent2::peakNodeCount, "largest search tree over all searches")
+        .def_readonly("reclaimed_node_count", &search::ScumSearchAgent2::reclaimedNodeCount, "nodes freed by pruning over all searches")
         .def("playout", &search::ScumSearchAgent2::playout);
 
     pybind11::class_<GameContext> gameContext(m, "GameContext");
@@ -277,6 +511,38 @@ PYBIND11_MODULE(slaythespire, m) {
     map.def("__repr__", [](const Map &m) {
         return m.toString(true);
     });
+    // counts are ordered (elite, rest, shop, event, monster, burning elite), returns the route of x per row or None
+    map.def("plan_path", [](const Map &m, const std::array<int,6> &minCounts, const std::array<int,6> &maxCounts, const std::array<int,6> &weights) {
+        MapPathQuery q;
+        for (int i = 0; i < PATH_OBJECTIVE_COUNT; ++i) {
+            q.minCounts[i] = static_cast<std::int8_t>(minCounts[i]);
+            q.maxCounts[i] = static_cast<std::int8_t>(maxCounts[i]);
+            q.weights[i] = static_cast<std::int8_t>(weights[i]);
+        }
+        const auto path = MapPathPlanner(m).query(q);
+        if (!path) {
+            return pybind11::object(pybind11::none());
+        }
+        const auto route = path->toRoute();
+        return pybind11::object(pybind11::cast(std::vector<int>(route.begin(), route.end())));
+    }, "best route for weights within count bounds");
+    // directions are 1 to maximize, -1 to minimize, 0 to ignore. returns a list of (counts, route)
+    map.def("pareto_paths", [](const Map &m, const std::array<int,6> &directions) {
+        std::array<std::int8_t, PATH_OBJECTIVE_COUNT> dirs {};
+        for (int i = 0; i < PATH_OBJECTIVE_COUNT; ++i) {
+            dirs[i] = static_cast<std::int8_t>(directions[i]);
+        }
+        pybind11::list ret;
+        for (const auto &p : MapPathPlanner(m).getParetoFrontier(dirs)) {
+            std::vector<int> counts;
+            for (int i = 0; i < PATH_OBJECTIVE_COUNT; ++i) {
+                counts.push_back(p.getCount(static_cast<PathObjective>(i)));
+            }
+            const auto route = p.toRoute();
+            ret.append(pybind11::make_tuple(counts, std::vector<int>(route.begin(), route.end())));
+        }
+        return ret;
+    });
 
     pybind11::class_<Card> card(m, "Card");
     card.def(pybind11::init<CardId>())
@@ -6,6 +6,7 @@
 #define STS_LIGHTSPEED_ACTIONQUEUE_H
 
 #include "sts_common.h"
+#include "combat/Profiler.h"
 
 #include <bitset>
 #include <functional>
@@ -79,6 +80,7 @@ namespace sts {
         }
         bits.set(front, a.clearOnCombatVictory);
         arr[front] = std::move(a.actFunc);
+        STS_PROFILE(profile::recordActionQueuePush(size));
     }
 
     template<int capacity>
@@ -95,6 +97,7 @@ namespace sts {
         arr[back] = std::move(a.actFunc);
         ++back;
         ++size;
+        STS_PROFILE(profile::recordActionQueuePush(size));
     }
 
     template<int capacity>
@@ -107,6 +110,7 @@ namespace sts {
 #ifdef sts_asserts
         assert(size > 0 );
 #endif
+        STS_PROFILE(profile::recordActionQueuePop());
         ActionFunction a = arr[front];
         ++front;
         --size;
@@ -26,7 +26,9 @@
 
 namespace sts {
 
-
+    namespace triggers {
+        struct StatusTrigger;
+    }
 
     enum class Outcome {
         UNDECIDED=0,
@@ -46,52 +48,54 @@ namespace sts {
 
     struct BattleContext {
 
-        // begin for debugging purposes
-        inline static int sum = 0; // for preventing optimization in benchmarks
-        bool haveUsedDiscoveryAction = false; // for tracking undefined behavior resulting from using the action
-        bool undefinedBehaviorEvoked = false; // some cards cause inconsistent outcomes in games
-        std::uint64_t seed = 0;
-        int floorNum = 0;
-        MonsterEncounter encounter = MonsterEncounter::INVALID;
-        int loopCount = 0;
-        int energyWasted = 0;
-        int cardsDrawn = 0;
-        // end for debugging purposes
-
-        Random aiRng;
-        Random cardRandomRng;
-        Random miscRng;
-        Random monsterHpRng;
-        Random potionRng;
-        Random shuffleRng;
-
-        int ascension = 0;
+        // ********* hot state, read on nearly every action *********
         Outcome outcome = Outcome::UNDECIDED;
         InputState inputState = InputState::EXECUTING_ACTIONS;
-        CardSelectInfo cardSelectInfo;
 
-        int monsterTurnIdx = 6;
+        std::int16_t turn = 0;
+        std::int8_t monsterTurnIdx = 6;
+        std::int8_t ascension = 0;
 
         bool isBattleOver = false;
         bool endTurnQueued = false;
         bool turnHasEnded = false;
         bool skipMonsterTurn = false;
 
-        ActionQueue<50> actionQueue;
-        CardQueue cardQueue;
-
-        int potionCount = 0;
-        int potionCapacity = 3;
+        std::int8_t potionCount = 0;
+        std::int8_t potionCapacity = 3;
         std::array<Potion, 5> potions;
 
-        int turn = 0;
+        std::bitset<32> miscBits; // 0 stolen gold check,
+        CardSelectInfo cardSelectInfo;
+
         Player player;
         MonsterGroup monsters;
         CardManager cards;
 
         CardQueueItem curCardQueueItem;
+        CardQueue cardQueue;
+        ActionQueue<50> actionQueue;
 
-        std::bitset<32> miscBits; // 0 stolen gold check,
+        Random aiRng;
+        Random cardRandomRng;
+        Random miscRng;
+        Random monsterHpRng;
+        Random potionRng;
+        Random shuffleRng;
+
+        // ********* cold state, only read on battle setup and for debugging *********
+        inline static int sum = 0; // for preventing optimization in benchmarks
+        std::uint64_t seed = 0;
+        MonsterEncounter encounter = MonsterEncounter::INVALID;
+        std::int16_t floorNum = 0;
+        bool haveUsedDiscoveryAction = false; // for tracking undefined behavior resulting from using the action
+        bool undefinedBehaviorEvoked = false; // some cards cause inconsistent outcomes in games
+        int loopCount = 0;
+        int energyWasted = 0;
+        int cardsDrawn = 0;
+#ifdef sts_profile
+        profile::CopyCounter copyCounter;
+#endif
 
         BattleContext() = default;
         BattleContext(const BattleContext &rhs) = default;
@@ -130,6 +134,7 @@ namespace sts {
         void onUsePowerCard();
 
         void onUseStatusOrCurseCard();
+        void onUseCardPowers(const triggers::StatusTrigger &trigger);
         void onAfterUseCard();
 
         void setState(InputState state);
@@ -7,6 +7,8 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <new>
 
 #include "combat/CardInstance.h"
 
@@ -15,23 +17,28 @@ namespace sts {
     struct CardQueueItem {
         CardInstance card; // todo taking a copy is is incorrect because the card needs to be read from hand I believe in some scenarios, not sure
 //        int cardIdx;
-        int target = 0;
-
-        // special data
-        bool isEndTurn = false;
-        bool triggerOnUse = true;
-        bool ignoreEnergyTotal = false;
-        int energyOnUse = 0;
-        bool freeToPlay = false;
-        bool randomTarget = false;
-        bool autoplay = false;
-        int regretCardCount = 0; // maybe use to indicate triggerOnUse too?
-
-        bool purgeOnUse = false;
-        bool exhaustOnUse = false;
-
-        CardQueueItem() = default;
-        CardQueueItem(const CardInstance &card, int target, int energyOnUse) : card(card), target(target), energyOnUse(energyOnUse) {}
+        std::int8_t target = 0;
+        std::int8_t regretCardCount = 0; // maybe use to indicate triggerOnUse too?
+        std::int16_t energyOnUse = 0;
+
+        // special data, bitfields can't have default member initializers so they are set in the constructor
+        bool isEndTurn : 1;
+        bool triggerOnUse : 1;
+        bool ignoreEnergyTotal : 1;
+        bool freeToPlay : 1;
+        bool randomTarget : 1;
+        bool autoplay : 1;
+        bool purgeOnUse : 1;
+        bool exhaustOnUse : 1;
+
+        CardQueueItem() : isEndTurn(false), triggerOnUse(true), ignoreEnergyTotal(false), freeToPlay(false),
+                          randomTarget(false), autoplay(false), purgeOnUse(false), exhaustOnUse(false) {}
+
+        CardQueueItem(const CardInstance &card, int target, int energyOnUse) : CardQueueItem() {
+            this->card = card;
+            this->target = static_cast<std::int8_t>(target);
+            this->energyOnUse = static_cast<std::int16_t>(energyOnUse);
+        }
 
         static CardQueueItem endTurnItem() {
             CardQueueItem ret;
@@ -45,7 +52,26 @@ namespace sts {
         int size = 0;
         int backIdx = 0;
         int frontIdx = 0;
-        std::array<CardQueueItem, capacity> arr;
+
+        // the queue is usually empty, so slots are left unconstructed and copies only take the occupied ring segment
+        union Slot {
+            CardQueueItem item;
+            Slot() {}
+        };
+        std::array<Slot, capacity> arr;
+
+        CardQueue() = default;
+        CardQueue(const CardQueue &rhs) : size(rhs.size), backIdx(rhs.backIdx), frontIdx(rhs.frontIdx) {
+            copyItems(rhs);
+        }
+
+        CardQueue &operator=(const CardQueue &rhs) {
+            size = rhs.size;
+            backIdx = rhs.backIdx;
+            frontIdx = rhs.frontIdx;
+            copyItems(rhs);
+            return *this;
+        }
 
         void clear();
         void pushFront(CardQueueItem item);
@@ -57,7 +83,16 @@ namespace sts {
         CardQueueItem popBack();
         CardQueueItem &front();
 
-
+    private:
+        void copyItems(const CardQueue &rhs) {
+            int idx = rhs.frontIdx;
+            for (int i = 0; i < rhs.size; ++i) {
+                new (&arr[idx].item) CardQueueItem(rhs.arr[idx].item);
+                if (++idx >= capacity) {
+                    idx = 0;
+                }
+            }
+        }
     };
 
 }
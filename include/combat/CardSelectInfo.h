@@ -71,7 +71,10 @@ namespace sts {
         std::array<CardId, 3>& discovery_Cards() { return cards; }
         int& discovery_CopyCount() { return data0; }
         int& dualWield_CopyCount() { return data0; }
+        int& multiSelect_PickedBits() { return data0; } // hand cards picked so far when a multi select is made one card at a time
+        [[nodiscard]] int multiSelect_PickedBits() const { return data0; }
         std::array<CardId, 3>& codexCards() { return cards; }
+        [[nodiscard]] const std::array<CardId, 3>& codexCards() const { return cards; }
     };
 
 }
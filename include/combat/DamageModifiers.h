@@ -0,0 +1,53 @@
+#ifndef STS_LIGHTSPEED_DAMAGEMODIFIERS_H
+#define STS_LIGHTSPEED_DAMAGEMODIFIERS_H
+
+#include <cstdint>
+
+namespace sts {
+
+    class BattleContext;
+    struct CardInstance;
+
+    // Integer versions of BattleContext::calculateCardDamage and Monster::calculateDamageToPlayer.
+    // Except for slow and weak with paper krane, every multiplier in those float chains is a small integer times a power of two,
+    // so for bounded damage every float step is exact and the same result comes from integer math on (value << shift).
+    // The other cases fall back to the float functions, so results are always identical to them.
+    struct DamageMultiplier {
+        std::int32_t mul = 1;
+        std::int32_t shift = 0; // the multiplier is mul / 2^shift
+
+        void apply(int m, int s) { mul *= m; shift += s; }
+    };
+
+    // the player side of calculateCardDamage for one card, evaluated against each target
+    class CardDamageModifiers {
+        const BattleContext &bc;
+        const CardInstance &card;
+
+        int flatBonus; // relics, strength and vigor
+        DamageMultiplier playerMultiplier; // double damage, pen nib, weak and stance
+
+    public:
+        CardDamageModifiers(const BattleContext &bc, const CardInstance &card);
+
+        [[nodiscard]] int calculate(int targetIdx, int baseDamage) const;
+        void calculateAll(int baseDamage, int (&out)[5]) const; // for every monster that is not dead or escaping
+    };
+
+    // the player side of calculateDamageToPlayer, evaluated for each monster
+    class IncomingDamageModifiers {
+        const BattleContext &bc;
+
+        DamageMultiplier playerMultiplier; // vulnerable and wrath
+        std::int8_t facingIdx; // with surrounded, attacks from every other monster deal 50% more. -1 if not in effect
+        bool intangible;
+
+    public:
+        explicit IncomingDamageModifiers(const BattleContext &bc);
+
+        [[nodiscard]] int calculate(int monsterIdx, int baseDamage) const;
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_DAMAGEMODIFIERS_H
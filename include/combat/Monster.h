@@ -117,12 +117,13 @@ namespace sts {
         template <MonsterStatus> void setJustApplied(bool value);
         template <MonsterStatus> [[nodiscard]] bool wasJustApplied() const;
 
-        [[nodiscard]] bool isAlive() const;
-        [[nodiscard]] bool isTargetable() const;
-        [[nodiscard]] bool isDying() const;
-        [[nodiscard]] bool isEscaping() const;
-        [[nodiscard]] bool isDeadOrEscaped() const;
-        [[nodiscard]] bool isHalfDead() const;
+        // inline, the MonsterGroup kernels test these for every monster on every hit
+        [[nodiscard]] bool isAlive() const { return curHp > 0; }
+        [[nodiscard]] bool isTargetable() const { return !isDeadOrEscaped(); }
+        [[nodiscard]] bool isDying() const { return curHp <= 0; }
+        [[nodiscard]] bool isEscaping() const { return isEscapingB; }
+        [[nodiscard]] bool isDeadOrEscaped() const { return isDying() || isHalfDead() || isEscaping(); }
+        [[nodiscard]] bool isHalfDead() const { return halfDead; }
         [[nodiscard]] bool doesEscapeNext() const;
         [[nodiscard]] bool isAttacking() const;
 
@@ -137,6 +138,13 @@ namespace sts {
         void attacked(BattleContext &bc, int damage);
         void damageUnblockedHelper(BattleContext &bc, int damage);
         void damage(BattleContext &bc, int damage);
+
+        // the parts attacked and damage share. damageBlock returns the damage left after block, with hand drill
+        // triggering if the block breaks, loseHp takes unblocked damage > 0.
+        // loseHpAfterBlock is attacked or damage for a monster without any of the statuses they test
+        int damageBlock(BattleContext &bc, int damage);
+        void loseHp(BattleContext &bc, int damage);
+        void loseHpAfterBlock(BattleContext &bc, int damage);
         void onHpLost(BattleContext &bc, int amount);
         void removeDebuffs();
 
@@ -15,6 +15,16 @@
 
 namespace sts {
 
+    // what the monsters' current moves would do to the player this turn
+    struct IntentSummary {
+        std::array<DamageInfo, 5> damage; // per hit damage after modifiers, set for every monster with hp left
+        std::bitset<5> attacking; // the monster's move is an attack
+        std::bitset<5> active; // the monster is not dead, half dead or escaping
+        int totalDamage = 0; // damage * attackCount summed over active monsters
+
+        [[nodiscard]] int getUnblockedDamage(int block) const { return std::max(0, totalDamage - block); }
+    };
+
     struct MonsterGroup {
         int monstersAlive = 0;
         int monsterCount = 0;
@@ -23,6 +33,10 @@ namespace sts {
         std::bitset<5> extraRollMoveOnTurn;
         std::bitset<5> skipTurn;
 
+        // computed on each call, callers that need it more than once in a state should keep the result
+        void getIntentSummary(const BattleContext &bc, IntentSummary &summary) const;
+        [[nodiscard]] int getIncomingDamage(const BattleContext &bc) const; // before the player's block
+
         [[nodiscard]] bool areMonstersBasicallyDead() const;
         [[nodiscard]] int getAliveCount() const;
         [[nodiscard]] int getTargetableCount() const; // calculated here, not fast
@@ -48,6 +62,13 @@ namespace sts {
         // actions
         void doMonsterTurn(BattleContext &bc); // take a turn for the next monster
 
+        // group kernels, the same as calling the Monster function on every monster that is not dead or escaping
+        // (dying or escaping for the turn hooks) in index order. monsters without a status the function reacts
+        // to are handled inline, which in most rounds is all of them
+        void attackAll(BattleContext &bc, const int *damage); // damage per monster index
+        void damageAll(BattleContext &bc, int damage);
+        void applyEndOfTurnTriggers(BattleContext &bc);
+        void applyEndOfRoundPowers(BattleContext &bc);
         void applyPreTurnLogic(BattleContext &bc);
         void applyEmeraldEliteBuff(BattleContext &bc, int buffType, int act);
 
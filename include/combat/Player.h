@@ -34,9 +34,9 @@ namespace sts {
         CharacterClass cc;
 
         int16_t gold = 0;
-        int curHp = 80;
-        int maxHp = 80;
-        int energy = 0;
+        int16_t curHp = 80;
+        int16_t maxHp = 80;
+        int16_t energy = 0;
         int8_t energyPerTurn = 3;
         int8_t cardDrawPerTurn = 5; // AbstractPlayer gameHandSize
 
@@ -47,11 +47,11 @@ namespace sts {
         std::int8_t lastTargetedMonster = 1;
 
         // todo rework all of the power data structures...
-        int block = 0;
-        int artifact = 0;
-        int dexterity = 0;
-        int focus = 0;
-        int strength = 0;
+        int16_t block = 0;
+        int16_t artifact = 0;
+        int16_t dexterity = 0;
+        int16_t focus = 0;
+        int16_t strength = 0;
 
         std::uint32_t justAppliedBits = 0;
         std::uint64_t statusBits0 = 0;
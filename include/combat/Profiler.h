@@ -0,0 +1,123 @@
+#ifndef STS_LIGHTSPEED_PROFILER_H
+#define STS_LIGHTSPEED_PROFILER_H
+
+#include "sts_common.h"
+#include "constants/Cards.h"
+#include "constants/MonsterIds.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// hot path counters for the combat engine and search, only recorded when sts_profile is defined in sts_common.h
+#ifdef sts_profile
+#define STS_PROFILE(stmt) stmt
+#else
+#define STS_PROFILE(stmt)
+#endif
+
+namespace sts::profile {
+
+    enum class SearchPhase {
+        SELECT=0,
+        EXPAND,
+        ROLLOUT,
+        BACKPROP,
+    };
+
+    static constexpr const char* searchPhaseStrings[] = {"SELECT", "EXPAND", "ROLLOUT", "BACKPROP"};
+
+    static constexpr int CARD_ID_COUNT = std::size(cardEnumStrings);
+    static constexpr int MONSTER_ID_COUNT = std::size(monsterIdStrings);
+    static constexpr int SEARCH_PHASE_COUNT = std::size(searchPhaseStrings);
+
+    struct Counters {
+        std::array<std::uint64_t, CARD_ID_COUNT> cardPlayCount {};
+        std::array<std::uint64_t, CARD_ID_COUNT> cardPlayCycles {}; // BattleContext::useCard only, queued actions are not included
+        std::array<std::uint64_t, MONSTER_ID_COUNT> monsterTurnCount {};
+        std::array<std::uint64_t, MONSTER_ID_COUNT> monsterTurnCycles {};
+
+        std::uint64_t actionQueuePushCount = 0;
+        std::uint64_t actionQueuePopCount = 0;
+        std::uint64_t actionQueueMaxDepth = 0;
+        std::uint64_t battleContextCopies = 0;
+
+        std::array<std::uint64_t, SEARCH_PHASE_COUNT> searchPhaseCount {};
+        std::array<std::uint64_t, SEARCH_PHASE_COUNT> searchPhaseCycles {};
+
+        void merge(const Counters &rhs);
+    };
+
+    Counters& local(); // counters of the calling thread
+
+    // sums the counters of every thread that has recorded anything, including threads that have exited.
+    // counters of running threads are read without synchronization, so call this when simulation is paused for exact numbers
+    Counters collect();
+    void reset();
+    void print(std::ostream &os, const Counters &c);
+
+    inline std::uint64_t readCycles() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    // adds the cycles spent in its lifetime to a counter
+    class ScopedCycles {
+        std::uint64_t &cycles;
+        std::uint64_t start;
+
+    public:
+        ScopedCycles(std::uint64_t &count, std::uint64_t &cycles) : cycles(cycles), start(readCycles()) { ++count; }
+        ScopedCycles(const ScopedCycles &rhs) = delete;
+        ~ScopedCycles() { cycles += readCycles() - start; }
+    };
+
+    inline ScopedCycles cardPlayScope(CardId id) {
+        auto &c = local();
+        return {c.cardPlayCount[static_cast<int>(id)], c.cardPlayCycles[static_cast<int>(id)]};
+    }
+
+    inline ScopedCycles monsterTurnScope(MonsterId id) {
+        auto &c = local();
+        return {c.monsterTurnCount[static_cast<int>(id)], c.monsterTurnCycles[static_cast<int>(id)]};
+    }
+
+    inline ScopedCycles searchPhaseScope(SearchPhase phase) {
+        auto &c = local();
+        return {c.searchPhaseCount[static_cast<int>(phase)], c.searchPhaseCycles[static_cast<int>(phase)]};
+    }
+
+    inline void recordActionQueuePush(int depth) {
+        auto &c = local();
+        ++c.actionQueuePushCount;
+        c.actionQueueMaxDepth = std::max(c.actionQueueMaxDepth, static_cast<std::uint64_t>(depth));
+    }
+
+    inline void recordActionQueuePop() {
+        ++local().actionQueuePopCount;
+    }
+
+    // member of BattleContext in profile builds, counts copies but not moves of the owning object
+    struct CopyCounter {
+        CopyCounter() = default;
+        CopyCounter(const CopyCounter &) { ++local().battleContextCopies; }
+        CopyCounter(CopyCounter &&) noexcept {}
+        CopyCounter& operator=(const CopyCounter &) { ++local().battleContextCopies; return *this; }
+        CopyCounter& operator=(CopyCounter &&) noexcept { return *this; }
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_PROFILER_H
@@ -0,0 +1,155 @@
+#ifndef STS_LIGHTSPEED_TRIGGERTABLES_H
+#define STS_LIGHTSPEED_TRIGGERTABLES_H
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+
+#include "data_structure/bits.h"
+#include "combat/Player.h"
+
+// dispatch tables for combat hooks. each trigger lists the relics or powers that respond to it in the order the hook
+// applies them. a hook first intersects the trigger's mask with the player's relic or status bits, which is usually
+// empty, and otherwise iterates the set bits of ownedBy() in trigger order, so the result is the same as testing
+// every relic or power in turn.
+// for example:
+//      for (auto bits = onShuffleRelics.ownedBy(player); bits; bits &= bits-1) {
+//          switch (onShuffleRelics[bits::lowest(bits)]) { ... }
+//      }
+
+namespace sts::triggers {
+
+    static constexpr int MAX_TRIGGER_SIZE = 32;
+
+    struct RelicTrigger {
+        std::array<RelicId, MAX_TRIGGER_SIZE> order {};
+        int size = 0;
+        std::uint64_t mask0 = 0;
+        std::uint64_t mask1 = 0;
+
+        constexpr RelicTrigger(std::initializer_list<RelicId> relics) {
+            for (auto r : relics) {
+                order[size++] = r;
+                if (static_cast<int>(r) < 64) {
+                    mask0 |= 1ULL << static_cast<int>(r);
+                } else {
+                    mask1 |= 1ULL << (static_cast<int>(r)-64);
+                }
+            }
+        }
+
+        constexpr RelicId operator[](int idx) const {
+            return order[idx];
+        }
+
+        // bit i is set if the player has order[i]
+        [[nodiscard]] std::uint32_t ownedBy(const Player &p) const {
+            if (((p.relicBits0 & mask0) | (p.relicBits1 & mask1)) == 0) {
+                return 0;
+            }
+            std::uint32_t ret = 0;
+            for (int i = 0; i < size; ++i) {
+                ret |= static_cast<std::uint32_t>(p.hasRelicRuntime(order[i])) << i;
+            }
+            return ret;
+        }
+    };
+
+    // only for powers tracked in statusBits, not artifact, dexterity, focus or strength
+    struct StatusTrigger {
+        std::array<PlayerStatus, MAX_TRIGGER_SIZE> order {};
+        int size = 0;
+        std::uint64_t mask0 = 0;
+        std::uint32_t mask1 = 0;
+
+        constexpr StatusTrigger(std::initializer_list<PlayerStatus> statuses) {
+            for (auto s : statuses) {
+                order[size++] = s;
+                if (static_cast<int>(s) < 64) {
+                    mask0 |= 1ULL << static_cast<int>(s);
+                } else {
+                    mask1 |= 1U << (static_cast<int>(s)-64);
+                }
+            }
+        }
+
+        constexpr PlayerStatus operator[](int idx) const {
+            return order[idx];
+        }
+
+        // bit i is set if the player has order[i]
+        [[nodiscard]] std::uint32_t ownedBy(const Player &p) const {
+            if (((p.statusBits0 & mask0) | (p.statusBits1 & mask1)) == 0) {
+                return 0;
+            }
+            std::uint32_t ret = 0;
+            for (int i = 0; i < size; ++i) {
+                const int idx = static_cast<int>(order[i]);
+                const auto has = idx < 64 ? (p.statusBits0 >> idx) & 1 : (p.statusBits1 >> (idx-64)) & 1;
+                ret |= static_cast<std::uint32_t>(has) << i;
+            }
+            return ret;
+        }
+    };
+
+    // ********* powers onUseCard *********
+
+    static constexpr StatusTrigger onUseAttackPowers {
+        PS::AFTER_IMAGE, PS::DOUBLE_TAP, PS::DUPLICATION, PS::ECHO_FORM, PS::PANACHE, PS::RAGE, PS::VIGOR,
+        PS::FREE_ATTACK_POWER, PS::PEN_NIB
+    };
+
+    static constexpr StatusTrigger onUseSkillPowers {
+        PS::AFTER_IMAGE, PS::BURST, PS::DUPLICATION, PS::ECHO_FORM, PS::HEX, PS::PANACHE
+    };
+
+    // power, status and curse cards
+    static constexpr StatusTrigger onUseOtherPowers {
+        PS::AFTER_IMAGE, PS::DUPLICATION, PS::ECHO_FORM, PS::HEX, PS::PANACHE
+    };
+
+    // ********* relics onUseCard *********
+
+    static constexpr RelicTrigger onUseAttackRelics {
+        R::INK_BOTTLE, R::KUNAI, R::ORANGE_PELLETS, R::ORNAMENTAL_FAN, R::SHURIKEN, R::NECRONOMICON, R::PEN_NIB,
+        R::DUALITY, R::NUNCHAKU
+    };
+
+    static constexpr RelicTrigger onUseSkillRelics {
+        R::INK_BOTTLE, R::ORANGE_PELLETS, R::LETTER_OPENER
+    };
+
+    static constexpr RelicTrigger onUsePowerRelics {
+        R::BIRD_FACED_URN, R::INK_BOTTLE, R::ORANGE_PELLETS, R::MUMMIFIED_HAND
+    };
+
+    // ********* other triggers *********
+
+    static constexpr RelicTrigger onShuffleRelics {
+        R::THE_ABACUS, R::SUNDIAL
+    };
+
+    static constexpr RelicTrigger onExhaustRelics {
+        R::CHARONS_ASHES, R::DEAD_BRANCH
+    };
+
+    static constexpr StatusTrigger onExhaustPowers {
+        PS::DARK_EMBRACE, PS::FEEL_NO_PAIN
+    };
+
+    static constexpr RelicTrigger atTurnStartRelics {
+        R::ART_OF_WAR, R::BRIMSTONE, R::CAPTAINS_WHEEL, R::DAMARU, R::HAPPY_FLOWER, R::HORN_CLEAT, R::INCENSE_BURNER,
+        R::INSERTER, R::MERCURY_HOURGLASS, R::NECRONOMICON, R::ORANGE_PELLETS
+    };
+
+    static constexpr RelicTrigger atTurnStartPostDrawRelics {
+        R::POCKETWATCH, R::WARPED_TONGS
+    };
+
+    static constexpr RelicTrigger wasHpLostRelics {
+        R::CENTENNIAL_PUZZLE, R::SELF_FORMING_CLAY, R::RUNIC_CUBE, R::RED_SKULL
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_TRIGGERTABLES_H
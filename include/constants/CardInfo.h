@@ -0,0 +1,89 @@
+#ifndef STS_LIGHTSPEED_CARDINFO_H
+#define STS_LIGHTSPEED_CARDINFO_H
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+
+#include "constants/Cards.h"
+
+// one packed record per CardId and upgrade state, generated at compile time from the tables and switch functions in
+// Cards.h so the combat code can answer every static card query with a single load.
+// the functions in Cards.h remain the source of truth, test.cpp verify_card_info checks the table against them
+
+namespace sts {
+
+    static constexpr int CARD_ID_COUNT = static_cast<int>(CardId::ZAP)+1;
+
+    struct CardInfo {
+        enum Flags : std::uint8_t {
+            TARGETS_ENEMY = 1 << 0,
+            ETHEREAL = 1 << 1,
+            EXHAUSTS = 1 << 2,
+            INNATE = 1 << 3,
+            SELF_RETAIN = 1 << 4,
+            X_COST = 1 << 5,
+            STRIKE = 1 << 6,
+            STARTER_STRIKE_OR_DEFEND = 1 << 7,
+        };
+
+        std::uint8_t type = static_cast<std::uint8_t>(CardType::INVALID);
+        std::uint8_t rarity = static_cast<std::uint8_t>(CardRarity::INVALID);
+        std::uint8_t color = static_cast<std::uint8_t>(CardColor::INVALID);
+        std::int8_t cost = 0;
+        std::int8_t baseDamage = -1;
+        std::uint8_t flags = 0;
+
+        [[nodiscard]] constexpr CardType getType() const { return static_cast<CardType>(type); }
+        [[nodiscard]] constexpr CardRarity getRarity() const { return static_cast<CardRarity>(rarity); }
+        [[nodiscard]] constexpr CardColor getColor() const { return static_cast<CardColor>(color); }
+        [[nodiscard]] constexpr bool has(Flags f) const { return flags & f; }
+    };
+
+    static_assert(sizeof(CardInfo) == 6);
+
+    static constexpr CardInfo makeCardInfo(CardId id, bool upgraded) {
+        const int idx = static_cast<int>(id);
+
+        CardInfo info;
+        info.type = static_cast<std::uint8_t>(cardTypes[idx]);
+        info.rarity = static_cast<std::uint8_t>(cardRarities[idx]);
+        info.color = static_cast<std::uint8_t>(cardColors[idx]);
+        info.cost = static_cast<std::int8_t>(getEnergyCost(id, upgraded));
+        info.baseDamage = cardBaseDamage[upgraded ? 1 : 0][idx];
+        info.flags = static_cast<std::uint8_t>(
+                (cardTargetsEnemy(id, upgraded) ? CardInfo::TARGETS_ENEMY : 0) |
+                (isCardEthereal(id, upgraded) ? CardInfo::ETHEREAL : 0) |
+                (doesCardExhaust(id, upgraded) ? CardInfo::EXHAUSTS : 0) |
+                (isCardInnate(id, upgraded) ? CardInfo::INNATE : 0) |
+                (doesCardSelfRetain(id, upgraded) ? CardInfo::SELF_RETAIN : 0) |
+                (isXCost(id) ? CardInfo::X_COST : 0) |
+                (isCardStrikeCard(id) ? CardInfo::STRIKE : 0) |
+                (isStarterStrikeOrDefend(id) ? CardInfo::STARTER_STRIKE_OR_DEFEND : 0));
+        return info;
+    }
+
+    static constexpr std::array<CardInfo, CARD_ID_COUNT*2> makeCardInfoTable() {
+        std::array<CardInfo, CARD_ID_COUNT*2> ret {};
+        for (int i = 0; i < CARD_ID_COUNT; ++i) {
+            ret[i*2] = makeCardInfo(static_cast<CardId>(i), false);
+            ret[i*2+1] = makeCardInfo(static_cast<CardId>(i), true);
+        }
+        return ret;
+    }
+
+    // indexed by id*2 + upgraded
+    static constexpr std::array<CardInfo, CARD_ID_COUNT*2> cardInfoTable = makeCardInfoTable();
+
+    static constexpr const CardInfo& getCardInfo(CardId id, bool upgraded) {
+        return cardInfoTable[static_cast<int>(id)*2 + (upgraded ? 1 : 0)];
+    }
+
+    static_assert(std::size(cardEnumStrings) == CARD_ID_COUNT);
+    static_assert(std::size(cardTypes) == CARD_ID_COUNT && std::size(cardTargets) == CARD_ID_COUNT);
+    static_assert(getCardInfo(CardId::BASH, true).baseDamage == 10);
+    static_assert(!getCardInfo(CardId::TRIP, true).has(CardInfo::TARGETS_ENEMY));
+
+}
+
+#endif //STS_LIGHTSPEED_CARDINFO_H
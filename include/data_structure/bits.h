@@ -0,0 +1,64 @@
+#ifndef STS_LIGHTSPEED_BITS_H
+#define STS_LIGHTSPEED_BITS_H
+
+#include <bitset>
+#include <cstdint>
+
+namespace sts {
+
+    namespace bits {
+
+        inline int popcount(std::uint64_t x) {
+            return static_cast<int>(std::bitset<64>(x).count());
+        }
+
+        // index of the lowest set bit, x must not be 0
+        inline int lowest(std::uint64_t x) {
+#if defined(__GNUC__)
+            return __builtin_ctzll(x);
+#else
+            int i = 0;
+            while (!(x & 1)) {
+                x >>= 1;
+                ++i;
+            }
+            return i;
+#endif
+        }
+
+        // index of the highest set bit, x must not be 0
+        inline int highest(std::uint64_t x) {
+#if defined(__GNUC__)
+            return 63 - __builtin_clzll(x);
+#else
+            int i = 63;
+            while (!(x >> i)) {
+                --i;
+            }
+            return i;
+#endif
+        }
+
+        // index of the k-th (0 based) set bit, x must have more than k bits set
+        inline int select(std::uint64_t x, int k) {
+            int base = 0;
+            for (int width = 32; width >= 8; width >>= 1) {
+                // narrow down to the half of the current block that contains the bit
+                const int lowCount = popcount((x >> base) & ((std::uint64_t(1) << width) - 1));
+                if (k >= lowCount) {
+                    k -= lowCount;
+                    base += width;
+                }
+            }
+            x >>= base;
+            for (; k > 0; --k) {
+                x &= x-1;
+            }
+            return base + lowest(x);
+        }
+
+    }
+
+}
+
+#endif //STS_LIGHTSPEED_BITS_H
@@ -0,0 +1,166 @@
+#ifndef STS_LIGHTSPEED_ORDERED_POOL_H
+#define STS_LIGHTSPEED_ORDERED_POOL_H
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+
+#include "data_structure/bits.h"
+
+namespace sts {
+
+    // an insertion ordered list where elements are removed by clearing their bit in a mask, so the relative order
+    // of the remaining elements never changes and removing never moves memory.
+    // the k-th remaining element is found with popcounts instead of a linear search
+    template<typename T, int capacity>
+    class ordered_pool {
+        static_assert(capacity <= 64, "ordered_pool is indexed by a 64 bit mask");
+
+    private:
+        std::uint64_t present = 0;
+        int slot_count = 0;
+        std::array<T,capacity> arr;
+
+    public:
+        class const_iterator {
+            const ordered_pool *pool;
+            std::uint64_t remaining;
+
+        public:
+            const_iterator(const ordered_pool *pool, std::uint64_t remaining) : pool(pool), remaining(remaining) {}
+
+            const T& operator*() const { return pool->arr[bits::lowest(remaining)]; }
+            const_iterator& operator++() { remaining &= remaining-1; return *this; }
+            bool operator==(const const_iterator &rhs) const { return remaining == rhs.remaining; }
+            bool operator!=(const const_iterator &rhs) const { return remaining != rhs.remaining; }
+        };
+
+        ordered_pool() = default;
+
+        template<typename ForwardIterator>
+        ordered_pool(ForwardIterator begin, ForwardIterator end) {
+            insert(begin, end);
+        }
+
+        static constexpr int max_size() {
+            return capacity;
+        }
+
+        int size() const {
+            return bits::popcount(present);
+        }
+
+        bool empty() const {
+            return present == 0;
+        }
+
+        void clear() {
+            present = 0;
+            slot_count = 0;
+        }
+
+        // removed slots are not reused, so at most capacity elements can be pushed between clears
+        void push_back(const T &t) {
+            if (slot_count >= capacity) {
+                throw std::length_error("ordered_pool is full");
+            }
+            arr[slot_count] = t;
+            present |= std::uint64_t(1) << slot_count;
+            ++slot_count;
+        }
+
+        template<typename ForwardIterator>
+        void insert(ForwardIterator begin, ForwardIterator end) {
+            for (auto it = begin; it != end; ++it) {
+                push_back(*it);
+            }
+        }
+
+        const_iterator begin() const {
+            return {this, present};
+        }
+
+        const_iterator end() const {
+            return {this, 0};
+        }
+
+        // the slots in insertion order including removed ones, for reordering a pool before anything is removed
+        T* slots_begin() {
+            return arr.data();
+        }
+
+        T* slots_end() {
+            return arr.data() + slot_count;
+        }
+
+        std::uint64_t mask() const {
+            return present;
+        }
+
+        const T& slot(int idx) const {
+            return arr[idx];
+        }
+
+        const T& front() const {
+            return arr[bits::lowest(present)];
+        }
+
+        const T& back() const {
+            return arr[bits::highest(present)];
+        }
+
+        T pop_front() {
+            const int idx = bits::lowest(present);
+            present &= present-1;
+            return arr[idx];
+        }
+
+        T pop_back() {
+            const int idx = bits::highest(present);
+            present &= ~(std::uint64_t(1) << idx);
+            return arr[idx];
+        }
+
+        // the mask of remaining slots where pred(element) is true
+        template<typename Predicate>
+        std::uint64_t filter(Predicate pred) const {
+            std::uint64_t ret = 0;
+            for (auto m = present; m; m &= m-1) {
+                const int idx = bits::lowest(m);
+                if (pred(arr[idx])) {
+                    ret |= std::uint64_t(1) << idx;
+                }
+            }
+            return ret;
+        }
+
+        // the slot index of the first remaining element equal to t, or -1
+        int find(const T &t) const {
+            for (auto m = present; m; m &= m-1) {
+                const int idx = bits::lowest(m);
+                if (arr[idx] == t) {
+                    return idx;
+                }
+            }
+            return -1;
+        }
+
+        void erase_slot(int idx) {
+            present &= ~(std::uint64_t(1) << idx);
+        }
+
+        // removes the first remaining element equal to t, returns false if there was none
+        bool erase_first(const T &t) {
+            const int idx = find(t);
+            if (idx == -1) {
+                return false;
+            }
+            erase_slot(idx);
+            return true;
+        }
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_ORDERED_POOL_H
@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "data_structure/fixed_list.h"
+#include "data_structure/ordered_pool.h"
 
 #include "constants/Misc.h"
 #include "constants/CardPools.h"
@@ -37,6 +38,12 @@ namespace sts {
         PLAYER_VICTORY,
     };
 
+    static constexpr const char * gameOutcomeStrings[] {
+            "PLAYER_LOSS",
+            "UNDECIDED",
+            "PLAYER_VICTORY",
+    };
+
     enum RngReference {
         MISC_RNG,
         CARD_RNG,
@@ -68,6 +75,19 @@ namespace sts {
         BATTLE,
     };
 
+    static constexpr const char * screenStateStrings[] {
+            "INVALID",
+            "EVENT_SCREEN",
+            "REWARDS",
+            "BOSS_RELIC_REWARDS",
+            "CARD_SELECT",
+            "MAP_SCREEN",
+            "TREASURE_ROOM",
+            "REST_ROOM",
+            "SHOP_ROOM",
+            "BATTLE",
+    };
+
     struct SelectScreenCard {
         Card card;
         std::int16_t deckIdx = -1;
@@ -172,16 +192,15 @@ namespace sts {
         Random shuffleRng;
         Random treasureRng;
 
-        // todo change these to fixed lists
-        std::vector<Event> eventList;
-        std::vector<Event> shrineList;
-        std::vector<Event> specialOneTimeEventList;
+        ordered_pool<Event, 16> eventList;
+        ordered_pool<Event, 8> shrineList;
+        ordered_pool<Event, 16> specialOneTimeEventList;
 
-        std::vector<RelicId> commonRelicPool;
-        std::vector<RelicId> uncommonRelicPool;
-        std::vector<RelicId> rareRelicPool;
-        std::vector<RelicId> shopRelicPool;
-        std::vector<RelicId> bossRelicPool;
+        ordered_pool<RelicId, 40> commonRelicPool;
+        ordered_pool<RelicId, 40> uncommonRelicPool;
+        ordered_pool<RelicId, 40> rareRelicPool;
+        ordered_pool<RelicId, 40> shopRelicPool;
+        ordered_pool<RelicId, 40> bossRelicPool;
 
         std::array<CardId, 35> colorlessCardPool = baseColorlessPool;
 
@@ -212,7 +231,7 @@ namespace sts {
 
         int curMapNodeX = -1;
         int curMapNodeY = -1;
-        std::shared_ptr<Map> map = nullptr; // todo fix memory leak
+        std::shared_ptr<const Map> map = nullptr; // shared with MapCache
 
         int act = 1;
         int ascension = 0;
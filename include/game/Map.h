@@ -6,8 +6,12 @@
 #define STS_LIGHTSPEED_MAP_H
 
 #include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
 #include <string>
 
+#include "sts_common.h"
 #include "constants/Rooms.h"
 
 namespace sts {
@@ -42,8 +46,21 @@ namespace sts {
         Map() = default;
         Map(std::uint64_t seed, int ascension, int act, bool assignBurningElite);
 
-        MapNode &getNode(int x, int y);
-        [[nodiscard]] const MapNode &getNode(int x, int y) const;
+        // not bounds checked outside of asserts, these are on the hot path of agents and map planning
+        MapNode &getNode(int x, int y) {
+#ifdef sts_asserts
+            assert(x >= 0 && x < 7 && y >= 0 && y < 15);
+#endif
+            return nodes[y][x];
+        }
+
+        [[nodiscard]] const MapNode &getNode(int x, int y) const {
+#ifdef sts_asserts
+            assert(x >= 0 && x < 7 && y >= 0 && y < 15);
+#endif
+            return nodes[y][x];
+        }
+
         [[nodiscard]] std::string toString(bool showRoomSymbols=true) const;
         static Map fromSeed(std::uint64_t seed, int ascension= 0, int act= 1, bool assignBurningElite=false);
         static Map act4Map();
@@ -51,6 +68,38 @@ namespace sts {
         void normalizeParents();
     };
 
+    // one byte per node, the room in the low 4 bits and edges to x-1, x, x+1 in bits 4 to 6.
+    // the top row uses the middle bit for its edge to the boss
+    struct PackedMap {
+        std::array<std::uint8_t, 15*7> nodes {};
+        std::int8_t burningEliteX = -1;
+        std::int8_t burningEliteY = -1;
+        std::int8_t burningEliteBuff = -1;
+
+        [[nodiscard]] Room getRoom(int x, int y) const { return static_cast<Room>(nodes[y*7+x] & 0xF); }
+        [[nodiscard]] int getEdgeMask(int x, int y) const { return nodes[y*7+x] >> 4; }
+        [[nodiscard]] bool hasEdge(int x, int y, int x2) const { return x2 >= x-1 && x2 <= x+1 && (getEdgeMask(x, y) & (1 << (x2-x+1))); }
+
+        static PackedMap pack(const Map &map);
+        [[nodiscard]] Map unpack() const; // parents are listed in increasing x
+
+        bool operator==(const PackedMap &rhs) const;
+        bool operator!=(const PackedMap &rhs) const { return !(*this == rhs); }
+    };
+
+    // Process wide cache of generated maps, shared read only by game contexts, agents and seed scanners.
+    // Direct mapped with a fixed number of slots so long seed sweeps stay bounded, a colliding key replaces the slot.
+    struct MapCache {
+        static constexpr int SLOT_COUNT = 2048;
+
+        static std::shared_ptr<const Map> get(std::uint64_t seed, int ascension, int act, bool assignBurningElite);
+        static std::shared_ptr<const Map> getAct4Map();
+        static void clear();
+
+        static std::uint64_t getHitCount();
+        static std::uint64_t getMissCount();
+    };
+
 }
 
 #endif //STS_LIGHTSPEED_MAP_H
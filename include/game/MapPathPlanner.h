@@ -0,0 +1,91 @@
+#ifndef STS_LIGHTSPEED_MAPPATHPLANNER_H
+#define STS_LIGHTSPEED_MAPPATHPLANNER_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "data_structure/fixed_list.h"
+#include "game/Map.h"
+
+namespace sts {
+
+    enum class PathObjective : std::uint8_t {
+        ELITE=0, // includes the burning elite
+        REST,
+        SHOP,
+        EVENT,
+        MONSTER,
+        BURNING_ELITE,
+    };
+
+    static constexpr int PATH_OBJECTIVE_COUNT = 6;
+    static constexpr const char* pathObjectiveStrings[] = {"ELITE", "REST", "SHOP", "EVENT", "MONSTER", "BURNING_ELITE"};
+
+    // room counts packed 4 bits per objective, so counts of two path segments add as integers
+    typedef std::uint32_t PathCounts;
+
+    struct MapPath {
+        PathCounts counts = 0;
+        std::uint64_t route = 0; // x of the node taken in row y in bits [3y, 3y+3)
+        std::int8_t firstRow = 0;
+        std::int8_t lastRow = -1;
+
+        [[nodiscard]] int getCount(PathObjective o) const { return (counts >> (4*static_cast<int>(o))) & 0xF; }
+        [[nodiscard]] int getX(int y) const { return static_cast<int>((route >> (3*y)) & 0x7); }
+
+        // x of every row from the first row of the path, followed by 0 for the boss, as SimpleAgent::getBestMapPathForWeights returns
+        [[nodiscard]] fixed_list<int,16> toRoute() const;
+    };
+
+    // counts must lie within [minCounts, maxCounts], the sum of weights * counts is maximized
+    struct MapPathQuery {
+        std::array<std::int8_t, PATH_OBJECTIVE_COUNT> minCounts {};
+        std::array<std::int8_t, PATH_OBJECTIVE_COUNT> maxCounts {15, 15, 15, 15, 15, 15};
+        std::array<std::int8_t, PATH_OBJECTIVE_COUNT> weights {};
+
+        MapPathQuery& atLeast(PathObjective o, int count) { minCounts[static_cast<int>(o)] = static_cast<std::int8_t>(count); return *this; }
+        MapPathQuery& atMost(PathObjective o, int count) { maxCounts[static_cast<int>(o)] = static_cast<std::int8_t>(count); return *this; }
+        MapPathQuery& weight(PathObjective o, int w) { weights[static_cast<int>(o)] = static_cast<std::int8_t>(w); return *this; }
+
+        [[nodiscard]] bool isSatisfiedBy(PathCounts counts) const;
+        [[nodiscard]] int score(PathCounts counts) const;
+    };
+
+    // Finds every distinct combination of room counts reachable on a map, keeping one route for each.
+    // Paths are built row by row and deduplicated by counts at every node, so any query over the counts is a scan of a few hundred entries.
+    class MapPathPlanner {
+        std::vector<MapPath> paths; // sorted by counts
+        int startRow = 0;
+
+    public:
+        MapPathPlanner() = default;
+        explicit MapPathPlanner(const Map &map) { init(map); }
+
+        // with a start node the paths continue from it and its own room is not counted
+        void init(const Map &map, int startX=-1, int startY=-1);
+
+        [[nodiscard]] const std::vector<MapPath>& getPaths() const { return paths; }
+        [[nodiscard]] int getStartRow() const { return startRow; }
+
+        // ties are broken toward the smaller counts then the leftmost route
+        [[nodiscard]] std::optional<MapPath> query(const MapPathQuery &q) const;
+
+        // directions are 1 to maximize an objective, -1 to minimize and 0 to ignore it
+        [[nodiscard]] std::vector<MapPath> getParetoFrontier(const std::array<std::int8_t, PATH_OBJECTIVE_COUNT> &directions) const;
+
+        struct BatchResult {
+            std::uint64_t seed;
+            int act;
+            std::optional<MapPath> path;
+        };
+
+        // runs one query on the maps of many seeds and acts, results are ordered by seed then act
+        static std::vector<BatchResult> queryBatch(std::uint64_t startSeed, int seedCount, int ascension,
+                                                   const std::vector<int> &acts, const MapPathQuery &q, int threadCount);
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_MAPPATHPLANNER_H
@@ -0,0 +1,42 @@
+#ifndef STS_LIGHTSPEED_RNGORACLE_H
+#define STS_LIGHTSPEED_RNGORACLE_H
+
+#include <vector>
+
+#include "game/GameContext.h"
+
+namespace sts {
+
+    // predicts what card rewards, shops, relics and potions the current rng streams and pools of a game would produce
+    // without playing forward. the oracle runs the real generators on a fork that holds only the state they read:
+    // cardRng, merchantRng, potionRng, relicRng, treasureRng, the relic and colorless pools, the rarity and potion
+    // counters, relics and deck. each call advances the fork the way the room would, so consecutive calls predict
+    // consecutive rooms.
+    // the streams are shared, for example cardRng feeds card rewards and shops, so call the next* methods in the order
+    // a route visits the rooms. events and combat can also draw from these streams (combat writes potionRng back),
+    // which the oracle can't see.
+    class RngOracle {
+        GameContext fork;
+
+    public:
+        explicit RngOracle(const GameContext &gc);
+
+        [[nodiscard]] const GameContext& getFork() const { return fork; }
+
+        CardReward nextCardReward(Room room);
+        Rewards nextCombatReward(Room room); // MONSTER or ELITE, gold, potion, relics and cards as afterBattle creates them
+        Shop nextShop();
+        Rewards nextTreasureChest(); // the chest of a treasure room, as opening it would fill the rewards screen
+        RelicId nextRelic(RelicTier tier, bool shopRoom=false);
+        Potion nextPotionDrop(); // Potion::INVALID when the drop roll fails
+
+        // the next count rooms of one kind, when no other kind of room is visited in between
+        static std::vector<CardReward> cardRewards(const GameContext &gc, Room room, int count);
+        static std::vector<Shop> shops(const GameContext &gc, int count);
+        static std::vector<RelicId> relics(const GameContext &gc, RelicTier tier, int count);
+        static std::vector<Potion> potionDrops(const GameContext &gc, int count);
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_RNGORACLE_H
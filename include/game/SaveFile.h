@@ -80,6 +80,10 @@ namespace sts {
 
         static std::string decode(const std::string &base64Str);
         static std::string encode(const std::string &data);
+
+        // table driven decode of whole 4 character groups, appends to out.
+        // characters outside the alphabet are skipped, decoding stops at the first '='
+        static void decodeFast(const char *data, std::size_t size, std::string &out);
     };
 
     struct SaveFile {
@@ -153,6 +157,17 @@ namespace sts {
 
         static SaveFile loadFromPath(const std::string& path, CharacterClass cc);
 
+        // same result as the constructor, but only the fields used by GameContext::initFromSave are read,
+        // in a single streaming pass without building a json document. throws std::runtime_error on bad input
+        static SaveFile fromJsonStream(std::string json, CharacterClass cc);
+        static SaveFile loadFromPathFast(const std::string& path, CharacterClass cc);
+
+        // binary copy of every field except json, for caching parsed save files. readSnapshot throws
+        // std::runtime_error on a truncated or corrupt snapshot
+        void writeSnapshot(std::ostream &os) const;
+        static SaveFile readSnapshot(std::istream &is);
+
+        static std::string decodeSaveFileContents(const std::string &contents); // base64 decode and xor in one pass
         static std::string getJsonFromSaveFile(const std::string &savePath);
         static void writeJsonToSaveFile(std::ifstream &jsonIs, const std::string &savePath);
         static std::string readFileToStringHelper(const std::string &path);
@@ -0,0 +1,38 @@
+#ifndef STS_LIGHTSPEED_SAVEFILEBATCH_H
+#define STS_LIGHTSPEED_SAVEFILEBATCH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "game/SaveFile.h"
+
+namespace sts {
+
+    struct SaveFileBatchResult {
+        std::string path;
+        bool ok = false;
+        std::string error; // set when ok is false
+        SaveFile save;
+    };
+
+    // loads large numbers of save files on a pool of threads using SaveFile::loadFromPathFast
+    struct SaveFileBatch {
+        typedef std::function<void (std::size_t pathIdx, SaveFileBatchResult &result)> ResultFnc;
+
+        static std::vector<std::string> listSaveFiles(const std::string &dirPath); // *.autosave files, sorted
+        static CharacterClass getCharacterClassFromPath(const std::string &path, CharacterClass defaultCc); // from the IRONCLAD.autosave naming
+
+        // fn is called from the worker threads as each file finishes, so it must be thread safe
+        static void forEach(const std::vector<std::string> &paths, int threadCount, CharacterClass defaultCc, const ResultFnc &fn);
+
+        // results are in the same order as paths
+        static std::vector<SaveFileBatchResult> load(const std::vector<std::string> &paths, int threadCount, CharacterClass defaultCc);
+
+        static void writeSnapshots(const std::string &outPath, const std::vector<SaveFileBatchResult> &results); // successful results only
+        static std::vector<SaveFile> readSnapshots(const std::string &path);
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_SAVEFILEBATCH_H
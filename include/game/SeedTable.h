@@ -0,0 +1,102 @@
+#ifndef STS_LIGHTSPEED_SEEDTABLE_H
+#define STS_LIGHTSPEED_SEEDTABLE_H
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace sts {
+
+    // columns of a seed table, every column is one byte per seed.
+    // groups of columns are addressed by their first column plus an index, e.g. MONSTERS+3 is the fourth monster room
+    enum SeedColumn : int {
+        NEOW_BONUS = 0,                         // 4 columns, Neow::Bonus of each option
+        NEOW_DRAWBACK = NEOW_BONUS + 4,         // 4 columns, Neow::Drawback of each option
+        BOSS = NEOW_DRAWBACK + 4,               // act 1 MonsterEncounter
+        MONSTERS = BOSS + 1,                    // 16 columns, act 1 monster list
+        ELITES = MONSTERS + 16,                 // 10 columns, act 1 elite list
+        MAP_ROOMS = ELITES + 10,                // 6 columns indexed by Room SHOP to TREASURE, room counts on the act 1 map
+        BURNING_ELITE_X = MAP_ROOMS + 6,        // -1 stored as 255
+        BURNING_ELITE_Y,
+        BURNING_ELITE_BUFF,
+        PATH_MAX_ELITES,                        // over every path through the act 1 map, burning elite included
+        PATH_MIN_ELITES,
+        PATH_MAX_RESTS,
+        PATH_MAX_SHOPS,
+        SEED_COLUMN_COUNT,
+    };
+
+    std::string getSeedColumnName(int column); // e.g. MONSTERS_3
+    int getSeedColumnForName(const std::string &name); // -1 if unknown
+
+    // the row of one seed, equal to what GameContext(cc, seed, ascension) generates. only the monster lists and the map
+    // are generated, not the rest of a new game
+    typedef std::array<std::uint8_t, SEED_COLUMN_COUNT> SeedRow;
+    SeedRow computeSeedRow(std::uint64_t seed, int ascension);
+
+    // a conjunction of terms, a term matches a row if any of its columns holds one of its values
+    class SeedFilter {
+    public:
+        struct Term {
+            int firstColumn;
+            int columnCount;
+            std::array<bool, 256> values {};
+        };
+
+    private:
+        std::vector<Term> terms;
+
+    public:
+        SeedFilter& where(int column, std::initializer_list<int> values);
+        SeedFilter& whereRange(int column, int lo, int hi); // lo <= value <= hi
+        SeedFilter& whereAny(int firstColumn, int columnCount, std::initializer_list<int> values);
+        SeedFilter& addTerm(const Term &t);
+
+        [[nodiscard]] const std::vector<Term>& getTerms() const { return terms; }
+    };
+
+    // a file of precomputed rows for a contiguous range of seeds, stored column by column after a 64 byte header.
+    // the file is memory mapped so a filter only reads the columns it tests
+    class SeedTable {
+        const std::uint8_t *data = nullptr;
+        std::size_t size = 0;
+        std::vector<std::uint8_t> buffer; // used instead of a mapping where mmap is unavailable
+
+        std::uint64_t startSeed = 0;
+        std::uint64_t rowCount = 0;
+        int ascension = 0;
+
+    public:
+        static constexpr int HEADER_SIZE = 64;
+
+        SeedTable() = default;
+        explicit SeedTable(const std::string &path) { open(path); }
+        SeedTable(const SeedTable &rhs) = delete;
+        SeedTable& operator=(const SeedTable &rhs) = delete;
+        ~SeedTable() { close(); }
+
+        void open(const std::string &path); // throws std::runtime_error if the file isn't a seed table
+        void close();
+
+        [[nodiscard]] std::uint64_t getStartSeed() const { return startSeed; }
+        [[nodiscard]] std::uint64_t getRowCount() const { return rowCount; }
+        [[nodiscard]] int getAscension() const { return ascension; }
+
+        [[nodiscard]] const std::uint8_t* getColumn(int column) const { return data + HEADER_SIZE + column * rowCount; }
+        [[nodiscard]] std::uint8_t get(std::uint64_t row, int column) const { return getColumn(column)[row]; }
+        [[nodiscard]] SeedRow getRow(std::uint64_t row) const;
+
+        [[nodiscard]] std::uint64_t count(const SeedFilter &f, int threadCount=1) const;
+        [[nodiscard]] std::vector<std::uint64_t> select(const SeedFilter &f, std::size_t limit, int threadCount=1) const; // seeds in increasing order
+
+        // computes rows on a pool of threads chunkSize seeds at a time, so memory stays bounded for any seedCount.
+        // throws std::runtime_error if the file can't be opened or written
+        static void write(const std::string &path, std::uint64_t startSeed, std::uint64_t seedCount, int ascension,
+                          int threadCount, std::uint64_t chunkSize=1<<20);
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_SEEDTABLE_H
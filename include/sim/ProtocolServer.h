@@ -0,0 +1,73 @@
+#ifndef STS_LIGHTSPEED_PROTOCOLSERVER_H
+#define STS_LIGHTSPEED_PROTOCOLSERVER_H
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "game/GameContext.h"
+#include "combat/BattleContext.h"
+
+// a machine protocol for driving many games from another process, one json object per line in each direction.
+// requests are handled as they are read, a client may send any number of them without waiting for responses.
+// responses are flushed when no more input is buffered, so a pipelined batch is written with one flush.
+//
+// requests:
+//      {"id":1, "op":"new", "game":"a", "seed":"ABC123" or 12345, "character":"IRONCLAD", "ascension":0, "fields":[...]}
+//      {"id":2, "op":"step", "game":"a", "action":<bits>, "fields":[...]}
+//      {"id":3, "op":"query", "game":"a", "fields":[...]}
+//      {"id":4, "op":"close", "game":"a"}
+//
+// a step takes a search::Action while the game is in a battle and a search::GameAction otherwise, battles are
+// entered and exited by the server so a client only sees decision points.
+// responses echo id and game, have "ok" and either "error" or the requested fields:
+//      "actions"       the bits of every valid action in the current state
+//      "observation"   getObservation(gc, bc) if the server has an observation function
+//      "outcome"       game outcome, and the battle outcome while in a battle
+//      "state"         a small summary: screen, floor, hp, maxHp, gold, inBattle, turn
+//
+// with threadCount > 1 games are assigned to workers by id, responses for one game stay in request order but
+// responses for different games may interleave, clients should match them by id.
+
+namespace sts {
+
+    struct ProtocolGame {
+        GameContext gc;
+        std::unique_ptr<BattleContext> bc; // set while gc.screenState is BATTLE
+    };
+
+    class ProtocolServer {
+    public:
+        typedef std::function<std::vector<int>(const GameContext &gc, const BattleContext *bc)> ObservationFunction;
+
+        // settings
+        int threadCount = 1;
+        ObservationFunction getObservation;
+
+        ProtocolServer() = default;
+
+        // serves until the input stream ends
+        void serve(std::istream &is, std::ostream &os) const;
+
+#ifndef _WIN32
+        // accepts connections on a unix domain socket, each connection is served on its own thread with its own games.
+        // only returns if the socket can't be set up, returns false in that case
+        bool serveUnixSocket(const std::string &path) const;
+#endif
+
+        // handles one request against a set of games, the response is written to ret
+        void handleRequest(std::unordered_map<std::string, ProtocolGame> &games,
+                           const nlohmann::json &request, nlohmann::json &ret) const;
+
+    private:
+        void addFields(const ProtocolGame &game, const nlohmann::json &fields, nlohmann::json &ret) const;
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_PROTOCOLSERVER_H
@@ -0,0 +1,36 @@
+#ifndef STS_LIGHTSPEED_SCRIPTBATCH_H
+#define STS_LIGHTSPEED_SCRIPTBATCH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sts {
+
+    struct ScriptResult {
+        std::string path;
+        bool passed = false;
+        std::string failure; // set when passed is false
+        int lineCount = 0; // lines consumed by the simulator
+        double seconds = 0;
+    };
+
+    // runs console simulator scripts, the same input main reads, on a pool of threads.
+    // each script gets its own ConsoleSimulator and SimulatorContext and stops at its first failed assert or at the
+    // first exception the simulator throws, which fails only that script
+    struct ScriptBatch {
+        typedef std::function<void (std::size_t pathIdx, ScriptResult &result)> ResultFnc;
+
+        static std::vector<std::string> listScripts(const std::string &dirPath); // regular files under dirPath recursively, sorted
+        static ScriptResult runScript(const std::string &path);
+
+        // fn is called from the worker threads as each script finishes, so it must be thread safe
+        static void forEach(const std::vector<std::string> &paths, int threadCount, const ResultFnc &fn);
+
+        // results are in the same order as paths
+        static std::vector<ScriptResult> run(const std::vector<std::string> &paths, int threadCount);
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_SCRIPTBATCH_H
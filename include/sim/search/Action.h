@@ -29,6 +29,13 @@ namespace sts::search {
         END_TURN,
     };
 
+    // how a search represents the choice of a multi card select (exhaust many, gamble)
+    enum class MultiSelectMode {
+        SKIP=0,         // one action that selects nothing
+        SUBSETS,        // one action per distinct selection, SEQUENTIAL if they don't fit in an ActionList
+        SEQUENTIAL,     // pick actions that add one card at a time, branching stays linear in the hand size
+    };
+
     // couldn't make a union work in only 32 bits
     struct Action {
 //        ActionType actionType;
@@ -51,13 +58,44 @@ namespace sts::search {
 
         [[nodiscard]] int getSelectIdx() const;   // for single card select action
         [[nodiscard]] fixed_list<int,10> getSelectedIdxs() const;         // for multi card select actions
+        [[nodiscard]] bool isMultiSelectPick() const;
 
         [[nodiscard]] bool isValidAction(const sts::BattleContext &bc) const;
         std::ostream& printDesc(std::ostream &os, const sts::BattleContext &bc) const;
         void execute(BattleContext &bc) const;
 
 
+        // multi card selects only get the action that selects nothing, use CardSubsetGenerator for the rest
         static std::vector<Action> enumerateCardSelectActions(const BattleContext &bc);
+
+        // a pick adds one hand card to cardSelectInfo.multiSelect_PickedBits() and leaves the selection open, a pick of
+        // no card finishes it. any other multi card select action also selects the cards picked before it
+        static constexpr std::uint32_t MULTI_SELECT_PICK = 1 << 15;
+        static Action multiSelectPick(int handIdx);
+        static Action multiSelectDone();
+    };
+
+    // the distinct selections of up to getMaxPicks(bc) hand cards for a multi card select, generated one at a time.
+    // equivalent cards are interchangeable, a selection takes them in hand order so each selection is generated once
+    class CardSubsetGenerator {
+        fixed_list<fixed_list<int,10>,10> classes; // hand indices of equivalent cards, classes in order of first card
+        std::array<int,10> chosen {}; // number of cards taken from each class
+        int chosenTotal = 0;
+        int maxPicks = 0;
+        bool started = false;
+
+    public:
+        explicit CardSubsetGenerator(const BattleContext &bc);
+
+        bool next(Action &a); // false when exhausted, the empty selection comes first
+        [[nodiscard]] std::int64_t count() const; // number of selections, without generating them
+
+        // the pick actions for a selection made one card at a time, in the same canonical order so that every
+        // selection has exactly one pick sequence. the first action finishes the selection
+        [[nodiscard]] fixed_list<Action,11> getNextPicks(std::uint32_t pickedBits) const;
+
+        static int getMaxPicks(const BattleContext &bc);
+        static bool areEquivalent(const CardInstance &a, const CardInstance &b);
     };
 
 }
@@ -0,0 +1,36 @@
+#ifndef STS_LIGHTSPEED_ACTIONSPACE_H
+#define STS_LIGHTSPEED_ACTIONSPACE_H
+
+#include "sim/search/Action.h"
+
+#include <cstdint>
+
+namespace sts::search {
+
+    // a fixed size discrete encoding of combat actions, for policies with one output per action.
+    // every encodable action has one index: untargeted cards and potions use target 0, the action that selects
+    // nothing in a multi card select maps to MULTI_SELECT_DONE, and selections of several cards at once are not
+    // encodable, they are reached with picks instead
+    struct ActionSpace {
+        static constexpr int MAX_TARGETS = 5;
+        static constexpr int MAX_POTIONS = 5;
+
+        static constexpr int CARD_BEGIN = 0;                                                      // hand idx * MAX_TARGETS + target
+        static constexpr int POTION_BEGIN = CARD_BEGIN + CardManager::MAX_HAND_SIZE*MAX_TARGETS;  // slot * MAX_TARGETS + target
+        static constexpr int POTION_DISCARD_BEGIN = POTION_BEGIN + MAX_POTIONS*MAX_TARGETS;       // slot
+        static constexpr int END_TURN = POTION_DISCARD_BEGIN + MAX_POTIONS;
+        static constexpr int SINGLE_SELECT_BEGIN = END_TURN + 1;                                  // select idx
+        static constexpr int MULTI_SELECT_PICK_BEGIN = SINGLE_SELECT_BEGIN + CardManager::MAX_GROUP_SIZE; // hand idx
+        static constexpr int MULTI_SELECT_DONE = MULTI_SELECT_PICK_BEGIN + CardManager::MAX_HAND_SIZE;
+        static constexpr int SIZE = MULTI_SELECT_DONE + 1;
+
+        static Action decode(int idx); // idx in [0, SIZE)
+        static int encode(Action a); // -1 if the action has no index
+
+        // writes SIZE bytes, 1 where the decoded action is valid in bc. returns the number of valid actions
+        static int writeLegalityMask(const BattleContext &bc, std::uint8_t *mask);
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_ACTIONSPACE_H
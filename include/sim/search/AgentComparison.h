@@ -0,0 +1,106 @@
+#ifndef STS_LIGHTSPEED_AGENTCOMPARISON_H
+#define STS_LIGHTSPEED_AGENTCOMPARISON_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// compares two agent configurations on paired seeds: both play every seed, and the per seed differences in
+// winning and in floor reached are tracked with confidence sequences, intervals that stay valid however often
+// they are looked at. the run stops as soon as the differences are resolved, instead of after a fixed count.
+//
+// agent configs are json objects, every key is optional:
+//      {"agent":"scum" or "simple", "simulationCountBase":50000, "bossSimulationMultiplier":3,
+//       "explorationParameter":4.24, "nodeBudget":0, "determinizationCount":1, "wideningBase":0,
+//       "priorWeight":0, "multiSelectMode":0, "rolloutMaxTurns":0, "staticEvaluator":"intentAware"}
+// staticEvaluator scores playouts cut off by rolloutMaxTurns, either "intentAware" or a StaticEvaluator json object.
+// evaluateTruncatedState is used if it is not given
+
+namespace sts::search {
+
+    struct PlayoutResult {
+        bool won = false;
+        int floorNum = 0;
+        std::int64_t simulationCount = 0;
+        double seconds = 0;
+    };
+
+    struct PairedPlayout {
+        std::uint64_t seed = 0;
+        PlayoutResult a;
+        PlayoutResult b;
+    };
+
+    enum class ComparisonDecision {
+        UNDECIDED = 0,
+        A_BETTER,
+        B_BETTER,
+        EQUIVALENT, // the whole interval is within the tolerance
+    };
+
+    static constexpr const char *comparisonDecisionStrings[] = {
+            "UNDECIDED",
+            "A_BETTER",
+            "B_BETTER",
+            "EQUIVALENT",
+    };
+
+    // running mean and variance of the per seed differences a-b of one metric
+    struct PairedDifference {
+        std::int64_t count = 0;
+        double mean = 0;
+        double m2 = 0;
+
+        void add(double diff);
+        [[nodiscard]] double getVariance() const;
+
+        // half width of a 1-alpha confidence sequence for the mean, the two sided normal mixture boundary of
+        // Howard et al. (2021) tightest around mixturePairs pairs. the variance is the sample variance, at least
+        // minVariance so a metric that hasn't varied yet can't resolve on the first pairs
+        [[nodiscard]] double getRadius(double alpha, int mixturePairs, double minVariance) const;
+    };
+
+    struct AgentComparison {
+        typedef std::function<PlayoutResult (std::uint64_t seed)> AgentFnc;
+        typedef std::function<void (const PairedPlayout &pair, const AgentComparison &comparison)> PairFnc;
+
+        AgentFnc agentA;
+        AgentFnc agentB;
+        PairFnc onPair; // called in seed order with the lock held, after the pair is counted
+
+        // settings
+        std::uint64_t startSeed = 1;
+        int threadCount = 1;
+        int minPairs = 20; // no decision before this many pairs
+        int maxPairs = 2000;
+        double alpha = 0.05; // per metric
+        double winRateTolerance = 0.02; // differences within these are equivalent
+        double floorTolerance = 0.5;
+        double minVariance = 0.01;
+        bool stopOnDifference = true; // also stop when one metric finds a better agent, before the other is resolved
+
+        // results, pairs past the stop that other workers had already started are not counted
+        std::vector<PairedPlayout> pairs; // in seed order
+        PairedDifference winDifference;
+        PairedDifference floorDifference;
+        ComparisonDecision winDecision = ComparisonDecision::UNDECIDED;
+        ComparisonDecision floorDecision = ComparisonDecision::UNDECIDED;
+        int discardedPairCount = 0;
+        double seconds = 0;
+
+        // results and decisions are the same for every threadCount
+        void run();
+
+        [[nodiscard]] bool isResolved() const;
+        [[nodiscard]] ComparisonDecision decide(const PairedDifference &d, double tolerance) const;
+        [[nodiscard]] nlohmann::json getReport(const nlohmann::json &configA, const nlohmann::json &configB) const;
+
+        // throws std::runtime_error on unknown keys
+        static AgentFnc makeAgent(const nlohmann::json &config, int ascension);
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_AGENTCOMPARISON_H
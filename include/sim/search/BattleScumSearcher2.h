@@ -6,6 +6,7 @@
 #define STS_LIGHTSPEED_BATTLESCUMSEARCHER2_H
 
 #include "sim/search/Action.h"
+#include "sim/search/RolloutPolicy.h"
 
 #include <functional>
 #include <memory>
@@ -15,29 +16,57 @@
 
 namespace sts::search {
 
-    typedef std::function<double (const BattleContext&)> EvalFnc;
-
     // to find a solution to a battle with tree pruning
     struct BattleScumSearcher2 {
         class Edge;
         struct Node {
-            std::int64_t simulationCount = 0;
-            double evaluationSum = 0;
             std::vector<Edge> edges;
+            std::uint32_t simulationCount = 0;
+            float meanEvaluation = 0; // a running mean stays precise in a float where a sum of evaluations would not
+
+            [[nodiscard]] double getEvaluationSum() const;
+            void addEvaluation(double evaluation);
         };
 
         struct Edge {
-            Action action;
             Node node;
+            Action action;
         };
 
         std::unique_ptr<const BattleContext> rootState;
         Node root;
 
+        // the tree is pruned between steps when it holds more than nodeBudget nodes, 0 means no limit.
+        // pruning collapses the least visited subtrees back into leaves that keep their own statistics
+        std::int64_t nodeBudget = 0;
+        double pruneTargetRatio = 0.75; // fraction of nodeBudget to prune down to
+        std::int64_t nodeCount = 1;
+        std::int64_t peakNodeCount = 1;
+        std::int64_t reclaimedNodeCount = 0;
+        int pruneCount = 0;
+
         EvalFnc evalFnc;
+        RolloutPolicy rolloutPolicy;
         double explorationParameter = 3*sqrt(2);
 
-        double bestActionValue = std::numeric_limits<double>::min();
+        // progressive widening, 0 means every action becomes an edge when a node is expanded. otherwise the actions
+        // are ranked by a prior and a node with n simulations has ceil(wideningBase * (n+1)^wideningExponent) edges,
+        // the next ranked action is materialized when that count grows
+        double wideningBase = 0;
+        double wideningExponent = 0.5;
+
+        // weight of the term priorWeight * prior * sqrt(N) / (n+1) added to the UCB value of an edge, where the prior
+        // of the edge ranked i is 1/(i+1). with widening off and a positive weight the edges are still ranked
+        double priorWeight = 0;
+
+        // ranks of non card actions against Expert::getPlayOrdering, lower is tried first
+        int endTurnOrdering = 80;
+        int potionOrdering = 100;
+
+        MultiSelectMode multiSelectMode = MultiSelectMode::SKIP;
+
+        double bestActionValue = std::numeric_limits<double>::min(); // only from playouts that reached the end of battle
+        double maxActionValue = std::numeric_limits<double>::min();
         double minActionValue = std::numeric_limits<double>::max();
         int outcomePlayerHp = 0;
 
@@ -53,21 +82,33 @@ namespace sts::search {
         void search(int64_t simulations);
         void step();
 
+        static std::int64_t nodeBudgetForBytes(std::int64_t bytes);
+
         // private helpers
-        void updateFromPlayout(const std::vector<Node*> &stack, const std::vector<Action> &actionStack, const BattleContext &endState);
+        void pruneTree(std::int64_t targetNodeCount);
+        void updateFromPlayout(const std::vector<Node*> &stack, const std::vector<Action> &actionStack, const BattleContext &endState, bool wasCutoff=false);
         [[nodiscard]] bool isTerminalState(const BattleContext &bc) const;
 
+        [[nodiscard]] bool usesPriors() const;
+        [[nodiscard]] int getWidenedEdgeCount(std::uint32_t simulationCount) const;
+        void enumeratePriorOrderedActions(const BattleContext &bc, ActionList &actions) const;
+        void widenNode(Node &node, const BattleContext &bc, int edgeCount); // materializes ranked actions up to edgeCount
+
         double evaluateEdge(const Node &parent, int edgeIdx);
         int selectBestEdgeToSearch(const Node &cur);
         int selectFirstActionForLeafNode(const Node &leafNode);
 
-        void playoutRandom(BattleContext &state, std::vector<Action> &actionStack);
+        bool playout(BattleContext &state, std::vector<Action> &actionStack); // returns true if the rollout policy cut it off
 
+        void enumerateActionsForState(const BattleContext &bc, ActionList &actions) const; // applies multiSelectMode
         void enumerateActionsForNode(Node &node, const BattleContext &bc);
         void enumerateCardActions(Node &node, const BattleContext &bc);
         void enumeratePotionActions(Node &node, const BattleContext &bc);
         void enumerateCardSelectActions(Node &node, const BattleContext &bc);
+        static void enumerateActions(const BattleContext &bc, ActionList &actions);
+
         static double evaluateEndState(const BattleContext &bc);
+        static double evaluateTruncatedState(const BattleContext &bc);
 
         void printSearchTree(std::ostream &os, int levels);
         void printSearchStack(std::ostream &os, bool skipLast=false);
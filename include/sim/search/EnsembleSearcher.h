@@ -0,0 +1,69 @@
+#ifndef STS_LIGHTSPEED_ENSEMBLESEARCHER_H
+#define STS_LIGHTSPEED_ENSEMBLESEARCHER_H
+
+#include "sim/search/BattleScumSearcher2.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sts::search {
+
+    // BattleScumSearcher2 plans against the one future fixed by the random streams of its root state. this runs
+    // determinizationCount independent searches, each on a copy of the battle with aiRng, cardRandomRng, miscRng and
+    // shuffleRng re-seeded (and optionally the draw pile reshuffled), on a pool of threads, then sums the root visit
+    // counts by action. the most visited merged action is good across many futures instead of exploiting one of them.
+    // searches share nothing while running, results are merged in determinization order so they don't depend on threadCount
+    struct EnsembleSearcher {
+        struct RootActionStats {
+            Action action;
+            std::uint64_t simulationCount = 0;
+            double evaluationSum = 0;
+            int searchCount = 0; // number of determinizations that expanded this action
+
+            [[nodiscard]] double getMeanEvaluation() const { return simulationCount ? evaluationSum / simulationCount : 0; }
+        };
+
+        // settings
+        int determinizationCount = 4;
+        int threadCount = 4;
+        std::int64_t simulationsPerSearch = 10000; // the budget of each determinization
+        std::int64_t nodeBudget = 0; // per search, see BattleScumSearcher2::nodeBudget
+        double explorationParameter = 3*sqrt(2); // see BattleScumSearcher2
+        double wideningBase = 0;
+        double priorWeight = 0;
+        MultiSelectMode multiSelectMode = MultiSelectMode::SKIP;
+        // also hides the draw order, cards the player put on top are shuffled too. never done when the root is a
+        // select from the draw pile, its select indices have to name the same card in every determinization
+        bool shuffleDrawPile = true;
+        RolloutPolicy rolloutPolicy;
+
+        std::unique_ptr<const BattleContext> rootState;
+        std::vector<std::unique_ptr<BattleScumSearcher2>> searchers; // one per determinization
+        std::vector<RootActionStats> rootActions; // merged, most visited first
+
+        std::int64_t simulationCount = 0;
+        std::int64_t peakNodeCount = 0; // summed over the searches, they are all held at the same time
+        std::int64_t reclaimedNodeCount = 0;
+
+        explicit EnsembleSearcher(const BattleContext &bc);
+
+        void search();
+
+        // the most visited merged root action. only the root is shared by every determinization, below it the trees
+        // hold different draws and monster moves, so an action index there names a different card in each of them.
+        // falls back to getFallbackAction when nothing valid was merged. only call on a non terminal state
+        [[nodiscard]] Action getBestAction() const;
+
+        // the most visited root action of any single determinization that is valid in the root state, otherwise the
+        // first legal action of the root state
+        [[nodiscard]] Action getFallbackAction() const;
+
+        static std::uint64_t getDeterminizationSeed(const BattleContext &bc, int determinizationIdx);
+        static void determinize(BattleContext &bc, std::uint64_t seed, bool shuffleDrawPile);
+        static bool isDrawPileSelect(const BattleContext &bc); // SECRET_TECHNIQUE, SECRET_WEAPON and SEEK
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_ENSEMBLESEARCHER_H
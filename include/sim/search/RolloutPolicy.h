@@ -0,0 +1,42 @@
+#ifndef STS_LIGHTSPEED_ROLLOUTPOLICY_H
+#define STS_LIGHTSPEED_ROLLOUTPOLICY_H
+
+#include "sim/search/Action.h"
+#include "data_structure/fixed_list.h"
+
+#include <functional>
+#include <random>
+
+namespace sts::search {
+
+    typedef std::function<double (const BattleContext&)> EvalFnc;
+
+    // an upper bound on the number of actions in one state, card select screens may choose from a whole pile
+    typedef fixed_list<Action, CardManager::MAX_GROUP_SIZE*2> ActionList;
+
+    // picks the next action to take during a playout, bc is never in a terminal state
+    typedef std::function<Action (const BattleContext &bc, std::default_random_engine &rng)> RolloutFnc;
+
+    struct RolloutPolicy {
+        RolloutFnc selectAction = &selectUniformRolloutAction;
+
+        // the playout is cut off when either limit is reached, 0 means no limit
+        int maxActions = 0;
+        int maxTurns = 0; // number of turn ends after the playout starts
+
+        EvalFnc cutoffEvalFnc; // scores a cut off playout, evaluateTruncatedState is used if not set
+
+        [[nodiscard]] bool hasCutoff() const;
+        [[nodiscard]] bool shouldCutoff(const BattleContext &bc, int startTurn, int actionCount) const;
+
+        static RolloutPolicy uniform();
+        static RolloutPolicy heuristic();
+        static RolloutPolicy epsilonMix(double epsilon);
+
+        static Action selectUniformRolloutAction(const BattleContext &bc, std::default_random_engine &rng);
+        static Action selectHeuristicRolloutAction(const BattleContext &bc, std::default_random_engine &rng);
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_ROLLOUTPOLICY_H
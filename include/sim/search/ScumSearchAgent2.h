@@ -8,7 +8,9 @@
 #include "game/GameContext.h"
 #include "sim/search/Action.h"
 #include "sim/search/GameAction.h"
+#include "sim/search/RolloutPolicy.h"
 
+#include <cmath>
 #include <memory>
 #include <random>
 
@@ -17,7 +19,9 @@ namespace sts::search {
     class BattleScumSearcher2;
 
     struct ScumSearchAgent2 {
-        std::int64_t simulationCountTotal;
+        std::int64_t simulationCountTotal = 0;
+        std::int64_t peakNodeCount = 0; // largest search tree over all searches
+        std::int64_t reclaimedNodeCount = 0;
         std::vector<int> gameActionHistory;
 
         int stepCount = 0;
@@ -29,8 +33,16 @@ namespace sts::search {
 
         int simulationCountBase = 50000;
         double bossSimulationMultiplier = 3;
+        std::int64_t nodeBudget = 0; // per search, 0 means no limit
+        int determinizationCount = 1; // above 1 each search is an EnsembleSearcher with this many re-seeded copies
+        int ensembleThreadCount = 1;
+        double explorationParameter = 3*sqrt(2); // see BattleScumSearcher2
+        double wideningBase = 0;
+        double priorWeight = 0;
+        MultiSelectMode multiSelectMode = MultiSelectMode::SKIP;
         int stepsNoSolution = 5;
         int stepsWithSolution = 15;
+        RolloutPolicy rolloutPolicy;
 
         std::default_random_engine rng;
 
@@ -46,6 +58,7 @@ namespace sts::search {
 
         void stepThroughSolution(BattleContext &bc, std::vector<search::Action> &actions);
         void stepThroughSearchTree(BattleContext &bc, const search::BattleScumSearcher2 &s);
+        void stepEnsemble(BattleContext &bc, std::int64_t simulationCount);
 
         void stepOutOfCombatPolicy(GameContext &gc);
         void cardSelectPolicy(GameContext &gc);
@@ -23,6 +23,7 @@ namespace sts::search {
         SimpleAgent();
 
         [[nodiscard]] int getIncomingDamage(const BattleContext &bc) const;
+        [[nodiscard]] static int getIncomingDamage(const BattleContext &bc, int act);
 
         void playout(GameContext &gc);
 
@@ -41,6 +42,11 @@ namespace sts::search {
         void stepShopScreen(GameContext &gc);
 
         bool playPotion(BattleContext &bc);
+
+        // the battle policy without side effects, also used for search rollouts
+        static Action getBattleCardPlayAction(const BattleContext &bc, int act);
+        static Action getBattleCardSelectAction(const BattleContext &bc);
+
         static fixed_list<int,16> getBestMapPathForWeights(const Map &m, const int *weights);
         static void runAgentsMt(int threadCount, std::uint64_t startSeed, int playoutCount, bool print);
     };
@@ -0,0 +1,123 @@
+#ifndef STS_LIGHTSPEED_STATICEVALUATOR_H
+#define STS_LIGHTSPEED_STATICEVALUATOR_H
+
+#include <array>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "combat/BattleContext.h"
+#include "sim/search/RolloutPolicy.h"
+
+// static evaluation of battle states that have not ended, on the scale of BattleScumSearcher2::evaluateEndState, so a
+// playout cut off by its RolloutPolicy can be scored without being played to the end.
+// a StaticEvaluator is linear in the features below, which are computed without allocating. EvaluatorCalibration fits
+// the weights against the mean outcome of full playouts from logged battle states
+
+namespace sts::search {
+
+    enum class EvalFeature {
+        BIAS = 0,
+        PLAYER_HP,
+        PLAYER_HP_RATIO,
+        HP_AFTER_INTENT, // hp left if the monsters' intents hit the current block
+        UNBLOCKED_DAMAGE_RATIO, // unblocked intent damage over hp, at most 1
+        MONSTER_HP_RATIO, // getNonMinionMonsterCurHpRatio
+        MONSTER_EFFECTIVE_HP_RATIO, // the same with the monsters' block added to their hp
+        MONSTERS_ALIVE,
+        PROGRESS_HP, // (1-MONSTER_HP_RATIO) * PLAYER_HP
+        PROGRESS_SQUARED_HP, // (1-MONSTER_HP_RATIO)^2 * PLAYER_HP
+        PLAYER_STRENGTH,
+        PLAYER_DEXTERITY,
+        PLAYER_SCALING, // stacks of powers that keep giving strength, block or hp
+        PLAYER_DEBUFFS, // turns of weak, vulnerable and frail
+        MONSTER_STRENGTH,
+        MONSTER_SCALING, // the same as PLAYER_SCALING over the living monsters
+        MONSTER_DEBUFFS, // turns of weak and vulnerable over the living monsters
+        POTION_COUNT,
+        DRAW_PILE_RATIO, // cards left to draw before the next shuffle, over the cards in the draw, discard and hand
+        TURN,
+        INVALID,
+    };
+
+    static constexpr int EVAL_FEATURE_COUNT = static_cast<int>(EvalFeature::INVALID);
+
+    static constexpr const char *evalFeatureStrings[] = {
+            "BIAS",
+            "PLAYER_HP",
+            "PLAYER_HP_RATIO",
+            "HP_AFTER_INTENT",
+            "UNBLOCKED_DAMAGE_RATIO",
+            "MONSTER_HP_RATIO",
+            "MONSTER_EFFECTIVE_HP_RATIO",
+            "MONSTERS_ALIVE",
+            "PROGRESS_HP",
+            "PROGRESS_SQUARED_HP",
+            "PLAYER_STRENGTH",
+            "PLAYER_DEXTERITY",
+            "PLAYER_SCALING",
+            "PLAYER_DEBUFFS",
+            "MONSTER_STRENGTH",
+            "MONSTER_SCALING",
+            "MONSTER_DEBUFFS",
+            "POTION_COUNT",
+            "DRAW_PILE_RATIO",
+            "TURN",
+    };
+
+    typedef std::array<double, EVAL_FEATURE_COUNT> EvalFeatures;
+
+    // curHp over maxHp summed over the monsters that aren't minions, 0 when they are all dead
+    double getNonMinionMonsterCurHpRatio(const BattleContext &bc);
+    double getNonMinionMonsterEffectiveHpRatio(const BattleContext &bc); // counts block as hp
+
+    void getEvalFeatures(const BattleContext &bc, EvalFeatures &features);
+
+    struct StaticEvaluator {
+        EvalFeatures weights {};
+
+        // ended battles are scored by evaluateEndState
+        [[nodiscard]] double evaluate(const BattleContext &bc) const;
+        [[nodiscard]] double evaluate(const EvalFeatures &features) const;
+        [[nodiscard]] EvalFnc getEvalFnc() const; // for RolloutPolicy::cutoffEvalFnc, holds a copy of the weights
+
+        // {"weights":{"BIAS":1.5, ...}}, features that aren't listed get weight 0. throws std::runtime_error on unknown
+        // feature names
+        [[nodiscard]] nlohmann::json toJson() const;
+        static StaticEvaluator fromJson(const nlohmann::json &json);
+
+        // weights fit by the evaluator_fit command on ascension 0 simple agent games, seeds 1 to 400, with 8 playouts
+        // per state of RolloutPolicy::epsilonMix(0.1)
+        static StaticEvaluator intentAware();
+    };
+
+    struct EvaluatorCalibration {
+        struct Sample {
+            EvalFeatures features;
+            double target; // mean evaluateEndState of the playouts
+            double baseline; // evaluateTruncatedState, the default score of a cut off playout
+        };
+
+        std::vector<Sample> samples;
+
+        // plays rolloutCount playouts of a copy of bc to the end of battle with policy's action selection, its cutoff
+        // is ignored, and logs the state's features with their mean evaluateEndState
+        void addSample(const BattleContext &bc, const RolloutPolicy &policy, int rolloutCount, std::default_random_engine &rng);
+
+        // ridge regression on standardized features, ridge is relative to the sample count
+        [[nodiscard]] StaticEvaluator fit(double ridge) const;
+        [[nodiscard]] double getMeanSquaredError(const StaticEvaluator &evaluator) const;
+        [[nodiscard]] double getBaselineMeanSquaredError() const;
+        [[nodiscard]] double getTargetVariance() const;
+
+        // one json array per line: the features in EvalFeature order followed by the baseline and the target
+        void writeSamples(std::ostream &os) const;
+        void readSamples(std::istream &is); // appends, throws std::runtime_error on a malformed line
+    };
+
+}
+
+#endif //STS_LIGHTSPEED_STATICEVALUATOR_H
@@ -11,6 +11,8 @@
 //#define sts_fixed_list_use_raw_array
 //#define sts_card_manager_use_fixed_list
 
+//#define sts_profile
+
 
 #include <cstdint>
 
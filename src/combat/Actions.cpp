@@ -5,6 +5,7 @@
 #include <algorithm>
 #include "combat/Actions.h"
 #include "combat/BattleContext.h"
+#include "combat/DamageModifiers.h"
 #include "game/Game.h"
 
 using namespace sts;
@@ -31,18 +32,8 @@ Action Actions::AttackAllEnemy(int baseDamage) {
         // assume bc.curCard is the card being used
 
         int damageMatrix[5];
-        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            if (!bc.monsters.arr[i].isDeadOrEscaped()) {
-                damageMatrix[i] = bc.calculateCardDamage(bc.curCardQueueItem.card, i, baseDamage);
-            }
-        }
-
-        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            if (!bc.monsters.arr[i].isDeadOrEscaped()) {
-                bc.monsters.arr[i].attacked(bc, damageMatrix[i]);
-            }
-        }
-
+        CardDamageModifiers(bc, bc.curCardQueueItem.card).calculateAll(baseDamage, damageMatrix);
+        bc.monsters.attackAll(bc, damageMatrix);
         bc.checkCombat();
     }};
 }
@@ -51,12 +42,11 @@ Action Actions::AttackAllEnemy(DamageMatrix damageMatrix) {
     return {[=] (BattleContext &bc) {
         // assume bc.curCard is the card being used
 
+        int damage[5];
         for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            if (!bc.monsters.arr[i].isDeadOrEscaped()) {
-                bc.monsters.arr[i].attacked(bc, static_cast<int>(damageMatrix[i]));
-            }
+            damage[i] = static_cast<int>(damageMatrix[i]);
         }
-
+        bc.monsters.attackAll(bc, damage);
         bc.checkCombat();
     }};
 }
@@ -74,11 +64,7 @@ Action Actions::DamageEnemy(int idx, int damage) {
 
 Action Actions::DamageAllEnemy(int damage) { // todo this is probably broken
     return {[=] (BattleContext &bc) {
-        for (int idx = 0; idx < bc.monsters.monsterCount; idx++) {
-            if (!bc.monsters.arr[idx].isDeadOrEscaped()) {
-                bc.monsters.arr[idx].damage(bc, damage); // possible should addToBot here todo
-            }
-        }
+        bc.monsters.damageAll(bc, damage); // possible should addToBot here todo
         bc.checkCombat();
     }};
 }
@@ -976,6 +962,7 @@ Action Actions::ExhaustMany(int limit) {
         bc.inputState = InputState::CARD_SELECT;
         bc.cardSelectInfo.cardSelectTask = CardSelectTask::EXHAUST_MANY;
         bc.cardSelectInfo.pickCount = limit;
+        bc.cardSelectInfo.multiSelect_PickedBits() = 0;
     }};
 }
 
@@ -983,6 +970,7 @@ Action Actions::GambleAction() {
     return {[] (BattleContext &bc) {
         bc.inputState = InputState::CARD_SELECT;
         bc.cardSelectInfo.cardSelectTask = CardSelectTask::GAMBLE;
+        bc.cardSelectInfo.multiSelect_PickedBits() = 0;
     }};
 }
 
@@ -1131,6 +1119,7 @@ Action Actions::LimitBreakAction() {
 Action Actions::ReaperAction(int baseDamage) {
     return {[=] (BattleContext &bc) {
 
+        const CardDamageModifiers modifiers(bc, bc.curCardQueueItem.card);
         int healAmount = 0;
         for (int i = 0; i < bc.monsters.monsterCount; ++i) {
             auto &m = bc.monsters.arr[i];
@@ -1138,7 +1127,7 @@ Action Actions::ReaperAction(int baseDamage) {
                 continue;
             }
             int preDamageHp = m.curHp;
-            m.attacked(bc, bc.calculateCardDamage(bc.curCardQueueItem.card, i, baseDamage));
+            m.attacked(bc, modifiers.calculate(i, baseDamage));
             healAmount += preDamageHp-m.curHp;
         }
 
@@ -1239,10 +1228,11 @@ Action Actions::WhirlwindAction(int baseDamage, int energy, bool useEnergy) {
             bc.player.useEnergy(bc.player.energy);
         }
 
+        const CardDamageModifiers modifiers(bc, bc.curCardQueueItem.card);
         DamageMatrix damageMatrix {0};
         for (int i = 0; i < bc.monsters.monsterCount; ++i) {
             if (!bc.monsters.arr[i].isDeadOrEscaped()) {
-                const auto calcDamage = bc.calculateCardDamage(bc.curCardQueueItem.card, i, baseDamage);
+                const auto calcDamage = modifiers.calculate(i, baseDamage);
 
                 damageMatrix[i] = static_cast<std::uint16_t>( // fit damage into uint16
                     std::min(
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include "combat/BattleContext.h"
+#include "combat/TriggerTables.h"
 #include "game/GameContext.h"
 #include "game/Game.h"
 
@@ -51,6 +52,7 @@ void BattleContext::init(const GameContext &gc, MonsterEncounter encounterToInit
     potionCapacity = gc.potionCapacity;
     potions = gc.potions;
 
+    player.cc = gc.cc;
     player.curHp = gc.curHp;
     player.maxHp = gc.maxHp;
     player.gold = gc.gold;
@@ -872,6 +874,7 @@ void BattleContext::playCardQueueItem(CardQueueItem playItem) {
 void BattleContext::useCard() {
     auto &item = curCardQueueItem;
     auto &c = item.card;
+    STS_PROFILE(const auto profileScope = profile::cardPlayScope(c.getId()));
 
     item.exhaustOnUse |= c.doesExhaust();
     ++player.cardsPlayedThisTurn;
@@ -1614,103 +1617,76 @@ void BattleContext::onUseAttackCard() {
 
     // ********* Powers onUseCard *********
 
-    if (p.hasStatus<PS::AFTER_IMAGE>()) {
-        addToBot(Actions::GainBlock(p.getStatus<PS::AFTER_IMAGE>()));
-    }
-
-    if (!item.purgeOnUse && p.hasStatus<PS::DOUBLE_TAP>()) {
-        queuePurgeCard(c, item.target);
-        p.decrementStatus<PS::DOUBLE_TAP>();
-    }
-
-    if (!item.purgeOnUse && p.hasStatus<PS::DUPLICATION>()) {
-        queuePurgeCard(c, item.target);
-        p.decrementStatus<PS::DUPLICATION>();
-    }
-
-    const auto echoForm = p.getStatus<PS::ECHO_FORM>();
-    if (!item.purgeOnUse && echoForm) {
-        const bool echoFormActive = player.cardsPlayedThisTurn - player.echoFormCardsDoubled <= echoForm;
-        if (echoFormActive) {
-            ++player.echoFormCardsDoubled;
-            queuePurgeCard(c, item.target);
-        }
-    }
-
-    if (p.hasStatus<PS::PANACHE>() && --p.panacheCounter <= 0) {
-        addToBot( Actions::DamageAllEnemy(p.getStatus<PS::PANACHE>()) );
-    }
-
-    if (p.hasStatus<PS::RAGE>()) {
-        addToBot( Actions::GainBlock(p.getStatus<PS::RAGE>()) );
-    }
-
-    if (p.hasStatus<PS::VIGOR>()) {
-        p.removeStatus<PS::VIGOR>();
-    }
-
-    if (p.hasStatus<PS::FREE_ATTACK_POWER>()) {
-        p.decrementStatus<PS::FREE_ATTACK_POWER>();
-    }
-
-    if (p.hasStatus<PS::PEN_NIB>()) {
-        // todo does this need to be added to bot?
-        addToBot( Actions::RemoveStatus<PS::PEN_NIB>() );
-    }
+    onUseCardPowers(triggers::onUseAttackPowers);
 
     // ********* Relics onUseCard *********
     // todo order of relics
 
-    if (p.hasRelic<R::INK_BOTTLE>()) {
-        p.inkBottleCounter++;
-        if (p.inkBottleCounter == 10) {
-            p.inkBottleCounter = 0;
-            addToBot( Actions::DrawCards(1) );
-        }
-    }
+    for (auto bits = triggers::onUseAttackRelics.ownedBy(p); bits; bits &= bits-1) {
+        switch (triggers::onUseAttackRelics[bits::lowest(bits)]) {
+            case R::INK_BOTTLE:
+                p.inkBottleCounter++;
+                if (p.inkBottleCounter == 10) {
+                    p.inkBottleCounter = 0;
+                    addToBot( Actions::DrawCards(1) );
+                }
+                break;
 
-    if (p.hasRelic<R::KUNAI>() && p.attacksPlayedThisTurn % 3 == 0) {
-        addToBot( Actions::BuffPlayer<PS::DEXTERITY>(1) );
-    }
+            case R::KUNAI:
+                if (p.attacksPlayedThisTurn % 3 == 0) {
+                    addToBot( Actions::BuffPlayer<PS::DEXTERITY>(1) );
+                }
+                break;
 
-    if (p.hasRelic<R::ORANGE_PELLETS>()) {
-        p.orangePelletsCardTypesPlayed.set(static_cast<int>(CardType::ATTACK), true); // set bit 0 true
-        if (p.orangePelletsCardTypesPlayed.all()) {
-            p.orangePelletsCardTypesPlayed.reset();
-            addToBot(Actions::RemovePlayerDebuffs());
-        }
-    }
+            case R::ORANGE_PELLETS:
+                p.orangePelletsCardTypesPlayed.set(static_cast<int>(CardType::ATTACK), true); // set bit 0 true
+                if (p.orangePelletsCardTypesPlayed.all()) {
+                    p.orangePelletsCardTypesPlayed.reset();
+                    addToBot(Actions::RemovePlayerDebuffs());
+                }
+                break;
 
-    if (p.hasRelic<R::ORNAMENTAL_FAN>() && p.attacksPlayedThisTurn % 3 == 0) {
-        addToBot( Actions::GainBlock(4) );
-    }
+            case R::ORNAMENTAL_FAN:
+                if (p.attacksPlayedThisTurn % 3 == 0) {
+                    addToBot( Actions::GainBlock(4) );
+                }
+                break;
 
-    if (p.hasRelic<R::SHURIKEN>() && p.attacksPlayedThisTurn % 3 == 0) {
-        addToBot( Actions::BuffPlayer<PS::STRENGTH>(1) );
-    }
+            case R::SHURIKEN:
+                if (p.attacksPlayedThisTurn % 3 == 0) {
+                    addToBot( Actions::BuffPlayer<PS::STRENGTH>(1) );
+                }
+                break;
 
-    if (p.hasRelic<R::NECRONOMICON>() && !p.haveUsedNecronomiconThisTurn && !item.freeToPlay && !item.purgeOnUse &&
-        (c.costForTurn >= 2 || c.isXCost() && item.energyOnUse >= 2)) {
-        queuePurgeCard(c, item.target);
-        p.haveUsedNecronomiconThisTurn = true;
-    }
+            case R::NECRONOMICON:
+                if (!p.haveUsedNecronomiconThisTurn && !item.freeToPlay && !item.purgeOnUse &&
+                    (c.costForTurn >= 2 || c.isXCost() && item.energyOnUse >= 2)) {
+                    queuePurgeCard(c, item.target);
+                    p.haveUsedNecronomiconThisTurn = true;
+                }
+                break;
 
-    if (p.hasRelic<R::PEN_NIB>()) {
-        ++p.penNibCounter;
-        if (p.penNibCounter == 9) {
-            addToBot( Actions::BuffPlayer<PS::PEN_NIB>(1) );
-            p.penNibCounter = -1; // take note of this
-        }
-    }
+            case R::PEN_NIB:
+                ++p.penNibCounter;
+                if (p.penNibCounter == 9) {
+                    addToBot( Actions::BuffPlayer<PS::PEN_NIB>(1) );
+                    p.penNibCounter = -1; // take note of this
+                }
+                break;
 
-    if (p.hasRelic<R::DUALITY>()) {
-        addToBot(Actions::DualityAction());
-    }
+            case R::DUALITY:
+                addToBot(Actions::DualityAction());
+                break;
+
+            case R::NUNCHAKU:
+                if (++p.nunchakuCounter >= 10) {
+                    addToBot(Actions::GainEnergy(1));
+                    p.nunchakuCounter = 0;
+                }
+                break;
 
-    if (p.hasRelic<R::NUNCHAKU>()) {
-        if (++p.nunchakuCounter >= 10) {
-            addToBot(Actions::GainEnergy(1));
-            p.nunchakuCounter = 0;
+            default:
+                break;
         }
     }
 
@@ -1732,44 +1708,12 @@ void BattleContext::onUseAttackCard() {
 }
 
 void BattleContext::onUseSkillCard() {
-    auto &item = curCardQueueItem;
-    auto &c = item.card;
-
     auto &p = player;
     ++p.skillsPlayedThisTurn;
 
     // ********* Powers onUseCard *********
 
-    if (p.hasStatus<PS::AFTER_IMAGE>()) {
-        addToBot(Actions::GainBlock(p.getStatus<PS::AFTER_IMAGE>()));
-    }
-
-    if (!item.purgeOnUse && p.hasStatus<PS::BURST>()) {
-        queuePurgeCard(c, item.target);
-        p.decrementStatus<PS::BURST>();
-    }
-
-    if (!item.purgeOnUse && p.hasStatus<PS::DUPLICATION>()) {
-        queuePurgeCard(c, item.target);
-        p.decrementStatus<PS::DUPLICATION>();
-    }
-
-    const auto echoForm = p.getStatus<PS::ECHO_FORM>();
-    if (!item.purgeOnUse && echoForm) {
-        const bool echoFormActive = player.cardsPlayedThisTurn - player.echoFormCardsDoubled <= echoForm;
-        if (echoFormActive) {
-            ++player.echoFormCardsDoubled;
-            queuePurgeCard(c, item.target);
-        }
-    }
-
-    if (p.hasStatus<PS::HEX>()) {
-        addToBot( Actions::MakeTempCardInDrawPile(CardInstance(CardId::DAZED), 1, true) );
-    }
-
-    if (p.hasStatus<PS::PANACHE>() && --p.panacheCounter <= 0) {
-        addToBot( Actions::DamageAllEnemy(p.getStatus<PS::PANACHE>()) );
-    }
+    onUseCardPowers(triggers::onUseSkillPowers);
 
     // todo Storm
     // todo Heatsinks
@@ -1777,31 +1721,35 @@ void BattleContext::onUseSkillCard() {
 
     // ********* Relics onUseCard *********
     // todo ink bottle/ ornamental fan need to be ordered i believe
+    // todo Mummified Hand
 
-    if (p.hasRelic<R::INK_BOTTLE>()) {
-        p.inkBottleCounter++;
-        if (p.inkBottleCounter == 10) {
-            p.inkBottleCounter = 0;
-            addToBot( Actions::DrawCards(1) );
-        }
-    }
+    for (auto bits = triggers::onUseSkillRelics.ownedBy(p); bits; bits &= bits-1) {
+        switch (triggers::onUseSkillRelics[bits::lowest(bits)]) {
+            case R::INK_BOTTLE:
+                p.inkBottleCounter++;
+                if (p.inkBottleCounter == 10) {
+                    p.inkBottleCounter = 0;
+                    addToBot( Actions::DrawCards(1) );
+                }
+                break;
 
-    if (p.hasRelic<R::ORANGE_PELLETS>()) {
-        p.orangePelletsCardTypesPlayed.set(static_cast<int>(CardType::SKILL), true); // set bit 0 true
-        if (p.orangePelletsCardTypesPlayed.all()) {
-            p.orangePelletsCardTypesPlayed.reset();
-            addToBot(Actions::RemovePlayerDebuffs());
-        }
-    }
+            case R::ORANGE_PELLETS:
+                p.orangePelletsCardTypesPlayed.set(static_cast<int>(CardType::SKILL), true); // set bit 0 true
+                if (p.orangePelletsCardTypesPlayed.all()) {
+                    p.orangePelletsCardTypesPlayed.reset();
+                    addToBot(Actions::RemovePlayerDebuffs());
+                }
+                break;
 
-    if (p.hasRelic<R::LETTER_OPENER>()) {
-        if (p.skillsPlayedThisTurn >= 3 &&  p.skillsPlayedThisTurn % 3 == 0) {
-            addToBot(Actions::DamageAllEnemy(5));
-        }
-    }
+            case R::LETTER_OPENER:
+                if (p.skillsPlayedThisTurn >= 3 &&  p.skillsPlayedThisTurn % 3 == 0) {
+                    addToBot(Actions::DamageAllEnemy(5));
+                }
+                break;
 
-    if (p.hasRelic<R::MUMMIFIED_HAND>()) {
-        // todo
+            default:
+                break;
+        }
     }
 
     /*
@@ -1820,62 +1768,43 @@ void BattleContext::onUseSkillCard() {
 }
 
 void BattleContext::onUsePowerCard() {
-    auto &item = curCardQueueItem;
-    auto &c = item.card;
     auto &p = player;
 
-    if (p.hasStatus<PS::AFTER_IMAGE>()) {
-        addToBot(Actions::GainBlock(p.getStatus<PS::AFTER_IMAGE>()));
-    }
-
-    if (!item.purgeOnUse && p.hasStatus<PS::DUPLICATION>()) {
-        queuePurgeCard(c, item.target);
-        p.decrementStatus<PS::DUPLICATION>();
-    }
+    onUseCardPowers(triggers::onUseOtherPowers);
 
-    const auto echoForm = p.getStatus<PS::ECHO_FORM>();
-    if (!item.purgeOnUse && echoForm) {
-        const bool echoFormActive = player.cardsPlayedThisTurn - player.echoFormCardsDoubled <= echoForm;
-        if (echoFormActive) {
-            ++player.echoFormCardsDoubled;
-            queuePurgeCard(c, item.target);
-        }
-    }
-
-    if (p.hasStatus<PS::HEX>()) {
-        addToBot( Actions::MakeTempCardInDrawPile(CardInstance(CardId::DAZED), 1, true) );
-    }
+    // ********* Relics onUseCard *********
 
-    if (p.hasStatus<PS::PANACHE>() && --p.panacheCounter <= 0) {
-        addToBot( Actions::DamageAllEnemy(p.getStatus<PS::PANACHE>()) );
-    }
+    for (auto bits = triggers::onUsePowerRelics.ownedBy(p); bits; bits &= bits-1) {
+        switch (triggers::onUsePowerRelics[bits::lowest(bits)]) {
+            case R::BIRD_FACED_URN:
+                p.heal(2);
+                break;
 
-    // ********* Relics onUseCard *********
+            case R::INK_BOTTLE:
+                p.inkBottleCounter++;
+                if (p.inkBottleCounter == 10) {
+                    p.inkBottleCounter = 0;
+                    addToBot( Actions::DrawCards(1) );
+                }
+                break;
 
-    if (p.hasRelic<R::BIRD_FACED_URN>()) {
-        p.heal(2);
-    }
+            case R::ORANGE_PELLETS:
+                p.orangePelletsCardTypesPlayed.set(static_cast<int>(CardType::POWER), true); // set bit 0 true
+                if (p.orangePelletsCardTypesPlayed.all()) {
+                    p.orangePelletsCardTypesPlayed.reset();
+                    addToBot(Actions::RemovePlayerDebuffs());
+                }
+                break;
 
-    if (p.hasRelic<R::INK_BOTTLE>()) {
-        p.inkBottleCounter++;
-        if (p.inkBottleCounter == 10) {
-            p.inkBottleCounter = 0;
-            addToBot( Actions::DrawCards(1) );
-        }
-    }
+            case R::MUMMIFIED_HAND:
+                mummifiedHandOnUsePower();
+                break;
 
-    if (p.hasRelic<R::ORANGE_PELLETS>()) {
-        p.orangePelletsCardTypesPlayed.set(static_cast<int>(CardType::POWER), true); // set bit 0 true
-        if (p.orangePelletsCardTypesPlayed.all()) {
-            p.orangePelletsCardTypesPlayed.reset();
-            addToBot(Actions::RemovePlayerDebuffs());
+            default:
+                break;
         }
     }
 
-    if (p.hasRelic<R::MUMMIFIED_HAND>()) {
-        mummifiedHandOnUsePower();
-    }
-
 //    auto &m = monsters.optionMap[2];
 //    if (m.hasStatusInternal<MS::CURIOSITY>()) {
 //        m.buff<MS::STRENGTH>(m.getStatus<MS::CURIOSITY>());
@@ -1887,31 +1816,7 @@ void BattleContext::onUseStatusOrCurseCard() {
     auto &c = item.card;
     auto &p = player;
 
-    if (p.hasStatus<PS::AFTER_IMAGE>()) {
-        addToBot(Actions::GainBlock(p.getStatus<PS::AFTER_IMAGE>()));
-    }
-
-    if (!item.purgeOnUse && p.hasStatus<PS::DUPLICATION>()) {
-        queuePurgeCard(c, item.target);
-        p.decrementStatus<PS::DUPLICATION>();
-    }
-
-    const auto echoForm = p.getStatus<PS::ECHO_FORM>();
-    if (!item.purgeOnUse && echoForm) {
-        const bool echoFormActive = player.cardsPlayedThisTurn - player.echoFormCardsDoubled <= echoForm;
-        if (echoFormActive) {
-            ++player.echoFormCardsDoubled;
-            queuePurgeCard(c, item.target);
-        }
-    }
-
-    if (p.hasStatus<PS::HEX>()) {
-        addToBot( Actions::MakeTempCardInDrawPile(CardInstance(CardId::DAZED), 1, true) );
-    }
-
-    if (p.hasStatus<PS::PANACHE>() && --p.panacheCounter <= 0) {
-        addToBot( Actions::DamageAllEnemy(p.getStatus<PS::PANACHE>()) );
-    }
+    onUseCardPowers(triggers::onUseOtherPowers);
 
     if (c.getType() == CardType::CURSE) {
         if (p.hasRelic<R::BLUE_CANDLE>()) {
@@ -1935,6 +1840,84 @@ void BattleContext::onUseStatusOrCurseCard() {
 
 }
 
+// powers onUseCard for the card in curCardQueueItem, the trigger decides which powers apply to its card type
+void BattleContext::onUseCardPowers(const triggers::StatusTrigger &trigger) {
+    auto &item = curCardQueueItem;
+    auto &c = item.card;
+    auto &p = player;
+
+    for (auto bits = trigger.ownedBy(p); bits; bits &= bits-1) {
+        switch (trigger[bits::lowest(bits)]) {
+            case PS::AFTER_IMAGE:
+                addToBot(Actions::GainBlock(p.getStatus<PS::AFTER_IMAGE>()));
+                break;
+
+            case PS::BURST:
+                if (!item.purgeOnUse) {
+                    queuePurgeCard(c, item.target);
+                    p.decrementStatus<PS::BURST>();
+                }
+                break;
+
+            case PS::DOUBLE_TAP:
+                if (!item.purgeOnUse) {
+                    queuePurgeCard(c, item.target);
+                    p.decrementStatus<PS::DOUBLE_TAP>();
+                }
+                break;
+
+            case PS::DUPLICATION:
+                if (!item.purgeOnUse) {
+                    queuePurgeCard(c, item.target);
+                    p.decrementStatus<PS::DUPLICATION>();
+                }
+                break;
+
+            case PS::ECHO_FORM: {
+                const auto echoForm = p.getStatus<PS::ECHO_FORM>();
+                if (!item.purgeOnUse && echoForm) {
+                    const bool echoFormActive = player.cardsPlayedThisTurn - player.echoFormCardsDoubled <= echoForm;
+                    if (echoFormActive) {
+                        ++player.echoFormCardsDoubled;
+                        queuePurgeCard(c, item.target);
+                    }
+                }
+                break;
+            }
+
+            case PS::HEX:
+                addToBot( Actions::MakeTempCardInDrawPile(CardInstance(CardId::DAZED), 1, true) );
+                break;
+
+            case PS::PANACHE:
+                if (--p.panacheCounter <= 0) {
+                    addToBot( Actions::DamageAllEnemy(p.getStatus<PS::PANACHE>()) );
+                }
+                break;
+
+            case PS::RAGE:
+                addToBot( Actions::GainBlock(p.getStatus<PS::RAGE>()) );
+                break;
+
+            case PS::VIGOR:
+                p.removeStatus<PS::VIGOR>();
+                break;
+
+            case PS::FREE_ATTACK_POWER:
+                p.decrementStatus<PS::FREE_ATTACK_POWER>();
+                break;
+
+            case PS::PEN_NIB:
+                // todo does this need to be added to bot?
+                addToBot( Actions::RemoveStatus<PS::PEN_NIB>() );
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
 void BattleContext::onAfterUseCard() {
     auto &item = curCardQueueItem;
     auto &c = item.card;
@@ -2131,23 +2114,9 @@ void BattleContext::callEndTurnEarlySequence() {
 }
 
 void BattleContext::applyEndOfRoundPowers() {
-    for (int i = 0; i < monsters.monsterCount; i++) {
-        auto &m = monsters.arr[i];
-        if (m.isDying() || m.isEscaping()) {
-            continue;
-        }
-        m.applyEndOfTurnTriggers(*this);
-    }
-
+    monsters.applyEndOfTurnTriggers(*this);
     player.applyAtEndOfRoundPowers();
-
-    for (int i = 0; i < monsters.monsterCount; i++) {
-        auto &m = monsters.arr[i];
-        if (m.isDying() || m.isEscaping()) {
-            continue;
-        }
-        m.applyEndOfRoundPowers(*this);
-    }
+    monsters.applyEndOfRoundPowers(*this);
 }
 
 void BattleContext::afterMonsterTurns() {
@@ -2794,20 +2763,24 @@ void BattleContext::onManualDiscard(const CardInstance &c) {
 }
 
 void BattleContext::onShuffle() {
-    if (player.hasRelic<R::THE_ABACUS>()) {
-        addToBot( Actions::GainBlock(6) );
-    }
+    // todo Melange scry
+    for (auto bits = triggers::onShuffleRelics.ownedBy(player); bits; bits &= bits-1) {
+        switch (triggers::onShuffleRelics[bits::lowest(bits)]) {
+            case R::THE_ABACUS:
+                addToBot( Actions::GainBlock(6) );
+                break;
 
-    if (player.hasRelic<R::MELANGE>()) {
-//        addToBot(Actions::SetState(InputState::SCRY, 3) ); // TODO SCRY Action
-    }
+            case R::SUNDIAL:
+                if (player.sundialCounter == 2) {
+                    player.sundialCounter = 0;
+                    addToBot( Actions::GainEnergy(2) );
+                } else {
+                    ++player.sundialCounter;
+                }
+                break;
 
-    if (player.hasRelic<R::SUNDIAL>()) {
-        if (player.sundialCounter == 2) {
-            player.sundialCounter = 0;
-            addToBot( Actions::GainEnergy(2) );
-        } else {
-            ++player.sundialCounter;
+            default:
+                break;
         }
     }
 }
@@ -2817,21 +2790,36 @@ void BattleContext::triggerAndMoveToExhaustPile(CardInstance c) {
     // player powers onExhaust
     // (the card).triggerOnExhaust
 
-    if (player.hasRelic<R::CHARONS_ASHES>()) {
-        addToTop(Actions::DamageAllEnemy(3));
-    }
+    for (auto bits = triggers::onExhaustRelics.ownedBy(player); bits; bits &= bits-1) {
+        switch (triggers::onExhaustRelics[bits::lowest(bits)]) {
+            case R::CHARONS_ASHES:
+                addToTop(Actions::DamageAllEnemy(3));
+                break;
 
-    if (player.hasRelic<R::DEAD_BRANCH>()){
-        CardId id = getTrulyRandomCardInCombat(cardRandomRng, player.cc);
-        addToBot(Actions::MakeTempCardInHand(id));
-    }
+            case R::DEAD_BRANCH: {
+                CardId id = getTrulyRandomCardInCombat(cardRandomRng, player.cc);
+                addToBot(Actions::MakeTempCardInHand(id));
+                break;
+            }
 
-    if (player.hasStatus<PS::DARK_EMBRACE>()) {
-        addToBot(Actions::DrawCards(player.getStatus<PS::DARK_EMBRACE>()));
+            default:
+                break;
+        }
     }
 
-    if (player.hasStatus<PS::FEEL_NO_PAIN>()) {
-        addToBot(Actions::GainBlock(player.getStatus<PS::FEEL_NO_PAIN>()));
+    for (auto bits = triggers::onExhaustPowers.ownedBy(player); bits; bits &= bits-1) {
+        switch (triggers::onExhaustPowers[bits::lowest(bits)]) {
+            case PS::DARK_EMBRACE:
+                addToBot(Actions::DrawCards(player.getStatus<PS::DARK_EMBRACE>()));
+                break;
+
+            case PS::FEEL_NO_PAIN:
+                addToBot(Actions::GainBlock(player.getStatus<PS::FEEL_NO_PAIN>()));
+                break;
+
+            default:
+                break;
+        }
     }
 
     if (c.getId() == CardId::NECRONOMICURSE) {
@@ -3117,8 +3105,8 @@ namespace sts {
 
     void printPotions(std::ostream &os, const BattleContext &bc) {
         const auto s = "\n\t";
-        os << "\t" << "potionCount: " << bc.potionCount;
-        os << s << "potionCapacity: " << bc.potionCapacity;
+        os << "\t" << "potionCount: " << static_cast<int>(bc.potionCount);
+        os << s << "potionCapacity: " << static_cast<int>(bc.potionCapacity);
 
         os << s << "{ ";
         for (int i = 0; i < bc.potionCapacity; ++i) {
@@ -3135,7 +3123,7 @@ namespace sts {
         os << "\tactionQueueSize: " << bc.actionQueue.size
             << ", cardQueueSize: " << bc.cardQueue.size
             << ", turn: " << bc.turn
-            << ", ascension " << bc.ascension
+            << ", ascension " << static_cast<int>(bc.ascension)
             << ", loopCount: " << bc.loopCount
             << ", sum: " << bc.sum
             << ", seed: " << bc.seed
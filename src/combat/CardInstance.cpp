@@ -4,13 +4,14 @@
 
 #include <algorithm>
 #include "combat/CardInstance.h"
+#include "constants/CardInfo.h"
 
 #include "combat/BattleContext.h"
 
 using namespace sts;
 
 CardInstance::CardInstance(CardId id, bool upgraded) : id(id), upgraded(upgraded) {
-    cost = getEnergyCost(id, upgraded);
+    cost = getCardInfo(id, upgraded).cost;
     costForTurn = cost;
 }
 
@@ -27,7 +28,7 @@ CardId CardInstance::getId() const {
 }
 
 CardType CardInstance::getType() const {
-    return getCardType(id);
+    return getCardInfo(id, upgraded).getType();
 }
 
 const char *CardInstance::getName() const {
@@ -60,27 +61,27 @@ bool CardInstance::canUpgrade() const {
 }
 
 bool CardInstance::isEthereal() const {
-    return isCardEthereal(id, upgraded);
+    return getCardInfo(id, upgraded).has(CardInfo::ETHEREAL);
 }
 
 bool CardInstance::isStrikeCard() const {
-    return isCardStrikeCard(id);
+    return getCardInfo(id, upgraded).has(CardInfo::STRIKE);
 }
 
 bool CardInstance::doesExhaust() const {
-    return doesCardExhaust(id, upgraded);
+    return getCardInfo(id, upgraded).has(CardInfo::EXHAUSTS);
 }
 
 bool CardInstance::hasSelfRetain() const {
-    return doesCardSelfRetain(id, upgraded);
+    return getCardInfo(id, upgraded).has(CardInfo::SELF_RETAIN);
 }
 
 bool CardInstance::requiresTarget() const {
-    return cardTargetsEnemy(id, isUpgraded());
+    return getCardInfo(id, upgraded).has(CardInfo::TARGETS_ENEMY);
 }
 
 bool CardInstance::isXCost() const {
-    return sts::isXCost(id);
+    return getCardInfo(id, upgraded).has(CardInfo::X_COST);
 }
 
 bool CardInstance::isBloodCard() const {
@@ -166,8 +167,8 @@ void CardInstance::upgrade() {
     if (!isUpgraded()) {
         upgraded = true;
         // TODO(dmz) is this logic right?
-        int newcost = getEnergyCost(id, true);
-        if (getEnergyCost(id, false) != newcost) {
+        int newcost = getCardInfo(id, true).cost;
+        if (getCardInfo(id, false).cost != newcost) {
             cost = costForTurn = newcost;
         }
     }
@@ -277,7 +278,8 @@ bool CardInstance::canUseOnAnyTarget(const BattleContext &bc) const {
 }
 
 bool CardInstance::canUse(const BattleContext &bc, int target, const bool inAutoplay) const {
-    if (this->requiresTarget() && (bc.monsters.areMonstersBasicallyDead() || !bc.monsters.arr[target].isTargetable())) {
+    const auto &info = getCardInfo(id, upgraded);
+    if (info.has(CardInfo::TARGETS_ENEMY) && (bc.monsters.areMonstersBasicallyDead() || !bc.monsters.arr[target].isTargetable())) {
         return false;
     }
 
@@ -288,7 +290,7 @@ bool CardInstance::canUse(const BattleContext &bc, int target, const bool inAuto
 
 
     // todo grand finale, signature move, reflex, deus ex machina, tactician
-    switch (getType()) {
+    switch (info.getType()) {
         case CardType::ATTACK:
             if (bc.player.hasStatus<PS::ENTANGLED>()) {
                 return false;
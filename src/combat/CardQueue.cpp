@@ -14,12 +14,12 @@ bool CardQueue::isEmpty() const {
 bool CardQueue::containsCardWithId(int uniqueId) const {
     int idx = frontIdx;
     for (int i = 0; i < size; ++i) {
-        if (frontIdx >= capacity) {
-            idx = 0;
-        }
-        if (arr[idx].card.getUniqueId() == uniqueId) {
+        if (arr[idx].item.card.getUniqueId() == uniqueId) {
             return true;
         }
+        if (++idx >= capacity) {
+            idx = 0;
+        }
     }
     return false;
 }
@@ -31,18 +31,18 @@ void CardQueue::clear() {
 }
 
 void CardQueue::pushFront(CardQueueItem item) {
-    assert(size != arr.size());
+    assert(size != capacity);
     --frontIdx;
     ++size;
     if (frontIdx < 0) {
         frontIdx = capacity - 1;
     }
-    arr.at(frontIdx) = std::move(item);
+    new (&arr[frontIdx].item) CardQueueItem(item);
 }
 
 void CardQueue::pushBack(CardQueueItem item) {
     assert(size != capacity);
-    arr.at(backIdx) = std::move(item);
+    new (&arr[backIdx].item) CardQueueItem(item);
     ++backIdx;
     ++size;
     if (backIdx >= capacity) {
@@ -52,7 +52,7 @@ void CardQueue::pushBack(CardQueueItem item) {
 
 CardQueueItem CardQueue::popFront() {
     assert(size > 0);
-    CardQueueItem &item = arr.at(frontIdx);
+    CardQueueItem &item = arr[frontIdx].item;
     ++frontIdx;
     --size;
     if (frontIdx >= capacity) {
@@ -66,13 +66,13 @@ CardQueueItem CardQueue::popBack() {
     --backIdx;
     --size;
     if (backIdx < 0) {
-        backIdx = arr.size() - 1;
+        backIdx = capacity - 1;
     }
-    CardQueueItem &item = arr.at(backIdx);
+    CardQueueItem &item = arr[backIdx].item;
     return item;
 }
 
 CardQueueItem &CardQueue::front() {
     assert(size > 0);
-    return arr.at(frontIdx);
+    return arr[frontIdx].item;
 }
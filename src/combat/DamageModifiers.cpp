@@ -0,0 +1,130 @@
+#include "combat/DamageModifiers.h"
+#include "combat/BattleContext.h"
+
+#include <algorithm>
+
+using namespace sts;
+
+// the largest multiplier product is 2*2*3*1.75 < 32 with at most 5 fractional bits,
+// so values within this bound keep every float intermediate below 2^24 and exact
+static constexpr int MAX_EXACT_DAMAGE = 1 << 14;
+
+static bool isExactRange(int damage) {
+    return damage >= -MAX_EXACT_DAMAGE && damage <= MAX_EXACT_DAMAGE;
+}
+
+CardDamageModifiers::CardDamageModifiers(const BattleContext &bc, const CardInstance &card) : bc(bc), card(card) {
+    const auto &p = bc.player;
+
+    flatBonus = 0;
+    if (p.hasRelic<R::STRIKE_DUMMY>() && card.isStrikeCard()) {
+        flatBonus += 3;
+    }
+    if (p.hasRelic<R::WRIST_BLADE>() && card.costForTurn == 0) {
+        flatBonus += 4;
+    }
+    flatBonus += p.getStatus<PS::STRENGTH>();
+    if (p.hasStatus<PS::VIGOR>()) {
+        flatBonus += p.getStatus<PS::VIGOR>();
+    }
+
+    if (p.hasStatus<PS::DOUBLE_DAMAGE>()) {
+        playerMultiplier.apply(2, 0);
+    }
+    if (p.hasStatus<PS::PEN_NIB>()) {
+        playerMultiplier.apply(2, 0);
+    }
+    if (p.hasStatus<PS::WEAK>()) {
+        playerMultiplier.apply(3, 2);
+    }
+
+    if (p.stance == Stance::WRATH) {
+        playerMultiplier.apply(2, 0);
+    } else if (p.stance == Stance::DIVINITY) {
+        playerMultiplier.apply(3, 0);
+    }
+}
+
+int CardDamageModifiers::calculate(int targetIdx, int baseDamage) const {
+    const Monster &m = bc.monsters.arr[targetIdx];
+    const int damage = baseDamage + flatBonus;
+    if (m.hasStatus<MS::SLOW>() || !isExactRange(baseDamage) || !isExactRange(flatBonus) || !isExactRange(damage)) {
+        return bc.calculateCardDamage(card, targetIdx, baseDamage);
+    }
+
+    DamageMultiplier x = playerMultiplier;
+    if (m.hasStatus<MS::VULNERABLE>()) {
+        if (bc.player.hasRelic<R::PAPER_PHROG>()) {
+            x.apply(7, 2);
+        } else {
+            x.apply(3, 1);
+        }
+    }
+    if (m.hasStatus<MS::FLIGHT>()) {
+        x.apply(1, 1);
+    }
+
+    const std::int64_t scaled = static_cast<std::int64_t>(damage) * x.mul;
+    const std::int64_t one = std::int64_t(1) << x.shift;
+    if (m.hasStatus<MS::INTANGIBLE>() && scaled < one) {
+        return 1; // calculateCardDamage raises to at least 1
+    }
+    return std::max(0, static_cast<int>(scaled / one)); // truncates toward zero like the float to int cast
+}
+
+void CardDamageModifiers::calculateAll(int baseDamage, int (&out)[5]) const {
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (!bc.monsters.arr[i].isDeadOrEscaped()) {
+            out[i] = calculate(i, baseDamage);
+        }
+    }
+}
+
+IncomingDamageModifiers::IncomingDamageModifiers(const BattleContext &bc) : bc(bc) {
+    const auto &p = bc.player;
+
+    facingIdx = -1;
+    if (p.hasStatus<PS::SURROUNDED>() && !bc.monsters.arr[p.lastTargetedMonster].isDeadOrEscaped()) {
+        facingIdx = p.lastTargetedMonster;
+    }
+
+    if (p.hasStatus<PS::VULNERABLE>()) {
+        if (p.hasRelic<R::ODD_MUSHROOM>()) {
+            playerMultiplier.apply(5, 2);
+        } else {
+            playerMultiplier.apply(3, 1);
+        }
+    }
+    if (p.stance == Stance::WRATH) {
+        playerMultiplier.apply(2, 0);
+    }
+
+    intangible = p.hasStatus<PS::INTANGIBLE>();
+}
+
+int IncomingDamageModifiers::calculate(int monsterIdx, int baseDamage) const {
+    const Monster &m = bc.monsters.arr[monsterIdx];
+    const int damage = baseDamage + m.getStatus<MS::STRENGTH>();
+    const bool weak = m.hasStatus<MS::WEAK>();
+    if ((weak && bc.player.hasRelic<R::PAPER_KRANE>()) || !isExactRange(damage)) {
+        return m.calculateDamageToPlayer(bc, baseDamage);
+    }
+
+    DamageMultiplier x = playerMultiplier;
+    if (facingIdx != -1 && facingIdx != monsterIdx) {
+        x.apply(3, 1);
+    }
+    if (weak) {
+        x.apply(3, 2);
+    }
+
+    const std::int64_t scaled = static_cast<std::int64_t>(damage) * x.mul;
+    const std::int64_t one = std::int64_t(1) << x.shift;
+    if (scaled < 0) {
+        return 0;
+    }
+    if (intangible) {
+        return scaled >= one ? 1 : 0;
+    }
+    return static_cast<int>(scaled / one);
+}
@@ -234,30 +234,6 @@ int Monster::getStatusInternal(MonsterStatus s) const {
     }
 }
 
-bool Monster::isAlive() const {
-    return curHp > 0;
-}
-
-bool Monster::isTargetable() const {
-    return !isDeadOrEscaped();
-}
-
-bool Monster::isDying() const {
-    return curHp <= 0;
-}
-
-bool Monster::isEscaping() const {
-    return isEscapingB;
-}
-
-bool Monster::isDeadOrEscaped() const {
-    return isDying() || isHalfDead() || isEscaping();
-}
-
-bool Monster::isHalfDead() const {
-    return halfDead;
-}
-
 bool Monster::doesEscapeNext() const {
     return escapeNext;
 }
@@ -395,13 +371,7 @@ void Monster::attackedUnblockedHelper(BattleContext &bc, int damage) { // todo,
         buff<MS::SHACKLED>(damage);
     }
 
-    curHp -= damage;
-    if (curHp <= 0) {
-        curHp = 0;
-        die(bc);
-    } else {
-        onHpLost(bc, damage);
-    }
+    loseHp(bc, damage);
 }
 
 void Monster::attacked(BattleContext &bc, int damage) {
@@ -425,15 +395,7 @@ void Monster::attacked(BattleContext &bc, int damage) {
         buff<MS::STRENGTH>(getStatus<MS::ANGRY>());
     }
 
-    const bool hadBlock = block > 0;
-    const int tempDamage = damage;
-    damage -= block;
-    block = std::max(0, block - tempDamage);
-
-    if (hadBlock && block == 0 && bc.player.hasRelic<RelicId::HAND_DRILL>()) {
-        bc.addToBot(Actions::DebuffEnemy<MS::VULNERABLE>(idx, 2, false) );
-    }
-
+    damage = damageBlock(bc, damage);
     if (damage > 0) { // todo can damage be zero???
         attackedUnblockedHelper(bc, damage);
     }
@@ -455,12 +417,7 @@ void Monster::damageUnblockedHelper(BattleContext &bc, int damage) {
         buff<MS::SHACKLED>(damage);
     }
 
-    curHp = std::max(0, curHp-damage);
-    if (curHp == 0) {
-        die(bc);
-    } else {
-        onHpLost(bc, damage);
-    }
+    loseHp(bc, damage);
 }
 
 void Monster::damage(BattleContext &bc, int damage) {
@@ -480,6 +437,13 @@ void Monster::damage(BattleContext &bc, int damage) {
         }
     }
 
+    damage = damageBlock(bc, damage);
+    if (damage > 0) {
+        damageUnblockedHelper(bc, damage);
+    }
+}
+
+int Monster::damageBlock(BattleContext &bc, int damage) {
     const bool hadBlock = block > 0;
     const int tempDamage = damage;
     damage -= block;
@@ -488,11 +452,23 @@ void Monster::damage(BattleContext &bc, int damage) {
     if (hadBlock && block == 0 && bc.player.hasRelic<RelicId::HAND_DRILL>()) {
         bc.addToBot(Actions::DebuffEnemy<MS::VULNERABLE>(idx, 2, false) );
     }
+    return damage;
+}
+
+void Monster::loseHp(BattleContext &bc, int damage) {
+    curHp -= damage;
+    if (curHp <= 0) {
+        curHp = 0;
+        die(bc);
+    } else {
+        onHpLost(bc, damage);
+    }
+}
 
+void Monster::loseHpAfterBlock(BattleContext &bc, int damage) {
+    damage = damageBlock(bc, std::max(0, damage));
     if (damage > 0) {
-        damageUnblockedHelper(bc, damage);
-    } else {
-        return;
+        loseHp(bc, damage);
     }
 }
 
@@ -6,10 +6,37 @@
 
 #include "combat/MonsterGroup.h"
 #include "combat/BattleContext.h"
+#include "combat/DamageModifiers.h"
+
+#include <initializer_list>
 
 
 using namespace sts;
 
+namespace {
+
+    constexpr std::uint64_t getStatusMask(std::initializer_list<MonsterStatus> statuses) {
+        std::uint64_t ret = 0;
+        for (auto s : statuses) {
+            ret |= 1ULL << static_cast<int>(s);
+        }
+        return ret;
+    }
+
+    // the statuses each Monster function tests, a monster with none of them only has its block and hp changed
+    constexpr auto attackedStatuses = getStatusMask({MS::INTANGIBLE, MS::ANGRY, MS::INVINCIBLE, MS::PLATED_ARMOR,
+                                                     MS::CURL_UP, MS::FLIGHT, MS::MALLEABLE, MS::REACTIVE,
+                                                     MS::THORNS, MS::ASLEEP, MS::SHIFTING});
+    constexpr auto damagedStatuses = getStatusMask({MS::INTANGIBLE, MS::INVINCIBLE, MS::ASLEEP, MS::SHIFTING});
+    constexpr auto endOfTurnStatuses = getStatusMask({MS::METALLICIZE, MS::MALLEABLE, MS::PLATED_ARMOR,
+                                                      MS::INTANGIBLE, MS::REGEN, MS::SHACKLED});
+    constexpr auto endOfRoundStatuses = getStatusMask({MS::RITUAL, MS::SLOW, MS::LOCK_ON, MS::WEAK, MS::VULNERABLE,
+                                                       MS::GENERIC_STRENGTH_UP});
+    constexpr auto startOfTurnStatuses = getStatusMask({MS::BARRICADE, MS::CHOKED, MS::FLIGHT, MS::INVINCIBLE,
+                                                        MS::POISON});
+
+}
+
 bool MonsterGroup::areMonstersBasicallyDead() const {
     return monstersAlive <= 0;
 }
@@ -37,6 +64,33 @@ int MonsterGroup::getAliveCount() const {
     return monstersAlive;
 }
 
+void MonsterGroup::getIntentSummary(const BattleContext &bc, IntentSummary &summary) const {
+    const IncomingDamageModifiers modifiers(bc);
+    summary = {};
+    for (int i = 0; i < monsterCount; ++i) {
+        const auto &m = arr[i];
+        if (!m.isAlive()) {
+            continue;
+        }
+
+        DamageInfo dInfo = m.getMoveBaseDamage(bc);
+        dInfo.damage = modifiers.calculate(i, dInfo.damage);
+        summary.damage[i] = dInfo;
+        summary.attacking.set(i, m.isAttacking());
+
+        if (!m.isDeadOrEscaped()) {
+            summary.active.set(i);
+            summary.totalDamage += dInfo.damage * dInfo.attackCount;
+        }
+    }
+}
+
+int MonsterGroup::getIncomingDamage(const BattleContext &bc) const {
+    IntentSummary summary;
+    getIntentSummary(bc, summary);
+    return summary.totalDamage;
+}
+
 int MonsterGroup::getRandomMonsterIdx(Random &rng, bool aliveOnly) const {
     if (aliveOnly) {
         if (monstersAlive == 0) {
@@ -576,6 +630,7 @@ void MonsterGroup::doMonsterTurn(BattleContext &bc) {
         if (skipTurn[bc.monsterTurnIdx]) {
             skipTurn.set(bc.monsterTurnIdx, false);
         } else {
+            STS_PROFILE(const auto profileScope = profile::monsterTurnScope(m.id));
             m.takeTurn(bc);
         }
     }
@@ -588,13 +643,66 @@ void MonsterGroup::doMonsterTurn(BattleContext &bc) {
     ++bc.monsterTurnIdx;
 }
 
+void MonsterGroup::attackAll(BattleContext &bc, const int *damage) {
+    // the boot and envenom act on every unblocked hit, hand drill is handled by Monster::damageBlock
+    const bool playerReacts = bc.player.hasRelic<R::THE_BOOT>() || bc.player.hasStatus<PS::ENVENOM>();
+
+    for (int i = 0; i < monsterCount; ++i) {
+        auto &m = arr[i];
+        if (m.isDeadOrEscaped()) {
+            continue;
+        }
+        if (playerReacts || (m.statusBits & attackedStatuses)) {
+            m.attacked(bc, damage[i]);
+        } else {
+            m.loseHpAfterBlock(bc, damage[i]);
+        }
+    }
+}
+
+void MonsterGroup::damageAll(BattleContext &bc, int damage) {
+    for (int i = 0; i < monsterCount; ++i) {
+        auto &m = arr[i];
+        if (m.isDeadOrEscaped()) {
+            continue;
+        }
+        if (m.statusBits & damagedStatuses) {
+            m.damage(bc, damage);
+        } else {
+            m.loseHpAfterBlock(bc, damage);
+        }
+    }
+}
+
+void MonsterGroup::applyEndOfTurnTriggers(BattleContext &bc) {
+    for (int i = 0; i < monsterCount; ++i) {
+        auto &m = arr[i];
+        if ((m.statusBits & endOfTurnStatuses) && !m.isDying() && !m.isEscaping()) {
+            m.applyEndOfTurnTriggers(bc);
+        }
+    }
+}
+
+void MonsterGroup::applyEndOfRoundPowers(BattleContext &bc) {
+    for (int i = 0; i < monsterCount; ++i) {
+        auto &m = arr[i];
+        if ((m.statusBits & endOfRoundStatuses) && !m.isDying() && !m.isEscaping()) {
+            m.applyEndOfRoundPowers(bc);
+        }
+    }
+}
+
 void MonsterGroup::applyPreTurnLogic(BattleContext &bc) {
     for (int i = 0; i < monsterCount; ++i) {
         auto &m = arr[i];
         if (m.isDying() || m.isEscaping()) { // todo fix this line
             continue;
         }
-        m.applyStartOfTurnPowers(bc); // dont need to do this before I think
+        if (m.statusBits & startOfTurnStatuses) {
+            m.applyStartOfTurnPowers(bc); // dont need to do this before I think
+        } else {
+            m.block = 0;
+        }
     }
 }
 
@@ -8,6 +8,7 @@
 #include <combat/BattleContext.h>
 #include <combat/Actions.h>
 #include "combat/Player.h"
+#include "combat/TriggerTables.h"
 
 using namespace sts;
 
@@ -287,29 +288,34 @@ void Player::hpWasLost(BattleContext &bc, int amount, bool selfDamage) {
     // todo - does order acquired matter with centennial/runic?
     // relics wasHpLost
     // -centennial-puzzle
-    // -emotion chip
+    // -emotion chip // todo
     // -runic cube
     // -self forming clay
 
-    if (hasRelic<RelicId::CENTENNIAL_PUZZLE>()) {
-        setHasRelic<RelicId::CENTENNIAL_PUZZLE>(false);
-        bc.addToTop( Actions::DrawCards(3) );
-    }
+    for (auto bits = triggers::wasHpLostRelics.ownedBy(*this); bits; bits &= bits-1) {
+        switch (triggers::wasHpLostRelics[bits::lowest(bits)]) {
+            case R::CENTENNIAL_PUZZLE:
+                setHasRelic<RelicId::CENTENNIAL_PUZZLE>(false);
+                bc.addToTop( Actions::DrawCards(3) );
+                break;
 
-    if (hasRelic<RelicId::EMOTION_CHIP>()) {
-        // todo
-    }
+            case R::SELF_FORMING_CLAY:
+                buff<PS::NEXT_TURN_BLOCK>(3);
+                break;
 
-    if (hasRelic<RelicId::SELF_FORMING_CLAY>()) {
-        buff<PS::NEXT_TURN_BLOCK>(3);
-    }
+            case R::RUNIC_CUBE:
+                bc.addToTop( Actions::DrawCards(1) );
+                break;
 
-    if (hasRelic<RelicId::RUNIC_CUBE>()) {
-        bc.addToTop( Actions::DrawCards(1) );
-    }
+            case R::RED_SKULL:
+                if (!wasBloodied && curHp <= maxHp/2) {
+                    buff<PS::STRENGTH>(3);
+                }
+                break;
 
-    if (hasRelic<RelicId::RED_SKULL>() && !wasBloodied && curHp <= maxHp/2) {
-        buff<PS::STRENGTH>(3);
+            default:
+                break;
+        }
     }
 
     bc.cards.onTookDamage();
@@ -489,77 +495,81 @@ void Player::applyAtEndOfRoundPowers() {
 
 void Player::applyStartOfTurnRelics(BattleContext &bc) {
     //****** Player relics atTurnStart ******
-    if (hasRelic<R::ART_OF_WAR>()) {
-        if (attacksPlayedThisTurn == 0) {
-            bc.addToBot(Actions::GainEnergy(1));
-        }
-    }
+    // todo Emotion Chip: if lost hp last turn addToBot(new ImpulseAction())
 
-    if (hasRelic<R::BRIMSTONE>()) {
-        buff<PS::STRENGTH>(2);
-        for (int i = 0; i < bc.monsters.monsterCount; i++) {
-            if (bc.monsters.arr[i].isTargetable()) {
-                bc.monsters.arr[i].buff<MS::STRENGTH>(1);
-            }
-        }
-    }
+    for (auto bits = triggers::atTurnStartRelics.ownedBy(*this); bits; bits &= bits-1) {
+        switch (triggers::atTurnStartRelics[bits::lowest(bits)]) {
+            case R::ART_OF_WAR:
+                if (attacksPlayedThisTurn == 0) {
+                    bc.addToBot(Actions::GainEnergy(1));
+                }
+                break;
 
-    if (hasRelic<R::CAPTAINS_WHEEL>()) {
-        if (bc.turn == 2) {
-            bc.addToBot( Actions::GainBlock(18) );
-        }
-    }
+            case R::BRIMSTONE:
+                buff<PS::STRENGTH>(2);
+                for (int i = 0; i < bc.monsters.monsterCount; i++) {
+                    if (bc.monsters.arr[i].isTargetable()) {
+                        bc.monsters.arr[i].buff<MS::STRENGTH>(1);
+                    }
+                }
+                break;
 
-    if (hasRelic<R::DAMARU>()) {
-        bc.addToBot( Actions::BuffPlayer<PS::MANTRA>(1) );
-        // todo handle mantra change stance
-    }
+            case R::CAPTAINS_WHEEL:
+                if (bc.turn == 2) {
+                    bc.addToBot( Actions::GainBlock(18) );
+                }
+                break;
 
-    if (hasRelic<R::EMOTION_CHIP>()) {
-        // todo if lost hp last turn addToBot(new ImpulseAction())
-    }
+            case R::DAMARU:
+                bc.addToBot( Actions::BuffPlayer<PS::MANTRA>(1) );
+                // todo handle mantra change stance
+                break;
 
-    if (hasRelic<R::HAPPY_FLOWER>()) {
-        if (++happyFlowerCounter == 3) {
-            happyFlowerCounter = 0;
-            bc.addToBot( Actions::GainEnergy(1) );
-        }
-    }
+            case R::HAPPY_FLOWER:
+                if (++happyFlowerCounter == 3) {
+                    happyFlowerCounter = 0;
+                    bc.addToBot( Actions::GainEnergy(1) );
+                }
+                break;
 
-    if (hasRelic<R::HORN_CLEAT>()) {
-        if (bc.turn == 1) {
-            bc.addToBot( Actions::GainBlock(14) );
-        }
-    }
+            case R::HORN_CLEAT:
+                if (bc.turn == 1) {
+                    bc.addToBot( Actions::GainBlock(14) );
+                }
+                break;
 
-    if (hasRelic<R::INCENSE_BURNER>()) {
-        if (++incenseBurnerCounter == 6) {
-            incenseBurnerCounter = 0;
-            bc.addToBot( Actions::BuffPlayer<PS::INTANGIBLE>(1) );
-        }
-    }
+            case R::INCENSE_BURNER:
+                if (++incenseBurnerCounter == 6) {
+                    incenseBurnerCounter = 0;
+                    bc.addToBot( Actions::BuffPlayer<PS::INTANGIBLE>(1) );
+                }
+                break;
 
-    if (hasRelic<R::INSERTER>()) {
-        if (++inserterCounter == 2) {
-            inserterCounter = 0; // todo
-            bc.addToBot( {[=](BattleContext &bc) {
-                bc.player.increaseOrbSlots(1);
-            }});
-        }
-    }
+            case R::INSERTER:
+                if (++inserterCounter == 2) {
+                    inserterCounter = 0; // todo
+                    bc.addToBot( {[=](BattleContext &bc) {
+                        bc.player.increaseOrbSlots(1);
+                    }});
+                }
+                break;
 
-    if (hasRelic<R::MERCURY_HOURGLASS>()) {
-        bc.addToBot( Actions::DamageAllEnemy(3) );
-    }
+            case R::MERCURY_HOURGLASS:
+                bc.addToBot( Actions::DamageAllEnemy(3) );
+                break;
 
-    if (hasRelic<R::NECRONOMICON>()) {
-        haveUsedNecronomiconThisTurn = false;
-    }
+            case R::NECRONOMICON:
+                haveUsedNecronomiconThisTurn = false;
+                break;
 
-    if (hasRelic<R::ORANGE_PELLETS>()) {
-        orangePelletsCardTypesPlayed.reset();
-    }
+            case R::ORANGE_PELLETS:
+                orangePelletsCardTypesPlayed.reset();
+                break;
 
+            default:
+                break;
+        }
+    }
 }
 
 void Player::applyStartOfTurnPowers(BattleContext &bc) {
@@ -660,14 +670,21 @@ void Player::applyStartOfTurnPowers(BattleContext &bc) {
 
 void Player::applyStartOfTurnPostDrawRelics(BattleContext &bc) {
     // ****** Player Relics AtTurnStartPostDraw ******
-    if (hasRelic<R::POCKETWATCH>()) {
-        if (cardsPlayedThisTurn <= 3) {
-            bc.addToBot(Actions::DrawCards(3));
-        }
-    }
+    for (auto bits = triggers::atTurnStartPostDrawRelics.ownedBy(*this); bits; bits &= bits-1) {
+        switch (triggers::atTurnStartPostDrawRelics[bits::lowest(bits)]) {
+            case R::POCKETWATCH:
+                if (cardsPlayedThisTurn <= 3) {
+                    bc.addToBot(Actions::DrawCards(3));
+                }
+                break;
+
+            case R::WARPED_TONGS:
+                bc.addToBot(Actions::UpgradeRandomCardAction());
+                break;
 
-    if (hasRelic<R::WARPED_TONGS>()) {
-        bc.addToBot(Actions::UpgradeRandomCardAction());
+            default:
+                break;
+        }
     }
 }
 
@@ -0,0 +1,108 @@
+#include "combat/Profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+using namespace sts;
+
+namespace {
+
+    std::mutex registryMutex;
+    std::vector<profile::Counters*> liveCounters;
+    profile::Counters exitedCounters;
+
+    // registers a thread's counters while it runs, they are folded into exitedCounters when the thread exits
+    struct ThreadCounters {
+        profile::Counters counters;
+
+        ThreadCounters() {
+            std::scoped_lock lock(registryMutex);
+            liveCounters.push_back(&counters);
+        }
+
+        ~ThreadCounters() {
+            std::scoped_lock lock(registryMutex);
+            exitedCounters.merge(counters);
+            liveCounters.erase(std::find(liveCounters.begin(), liveCounters.end(), &counters));
+        }
+    };
+
+    thread_local ThreadCounters threadCounters;
+
+}
+
+void profile::Counters::merge(const profile::Counters &rhs) {
+    for (int i = 0; i < CARD_ID_COUNT; ++i) {
+        cardPlayCount[i] += rhs.cardPlayCount[i];
+        cardPlayCycles[i] += rhs.cardPlayCycles[i];
+    }
+
+    for (int i = 0; i < MONSTER_ID_COUNT; ++i) {
+        monsterTurnCount[i] += rhs.monsterTurnCount[i];
+        monsterTurnCycles[i] += rhs.monsterTurnCycles[i];
+    }
+
+    actionQueuePushCount += rhs.actionQueuePushCount;
+    actionQueuePopCount += rhs.actionQueuePopCount;
+    actionQueueMaxDepth = std::max(actionQueueMaxDepth, rhs.actionQueueMaxDepth);
+    battleContextCopies += rhs.battleContextCopies;
+
+    for (int i = 0; i < SEARCH_PHASE_COUNT; ++i) {
+        searchPhaseCount[i] += rhs.searchPhaseCount[i];
+        searchPhaseCycles[i] += rhs.searchPhaseCycles[i];
+    }
+}
+
+profile::Counters& profile::local() {
+    return threadCounters.counters;
+}
+
+profile::Counters profile::collect() {
+    std::scoped_lock lock(registryMutex);
+    Counters ret = exitedCounters;
+    for (auto c : liveCounters) {
+        ret.merge(*c);
+    }
+    return ret;
+}
+
+void profile::reset() {
+    std::scoped_lock lock(registryMutex);
+    exitedCounters = {};
+    for (auto c : liveCounters) {
+        *c = {};
+    }
+}
+
+void profile::print(std::ostream &os, const profile::Counters &c) {
+    const auto printRow = [&](const char *name, std::uint64_t count, std::uint64_t cycles) {
+        os << std::setw(24) << name << std::setw(14) << count << std::setw(18) << cycles
+           << std::setw(12) << (count ? cycles / count : 0) << '\n';
+    };
+
+    os << "cards played:\n";
+    for (int i = 0; i < CARD_ID_COUNT; ++i) {
+        if (c.cardPlayCount[i]) {
+            printRow(cardEnumStrings[i], c.cardPlayCount[i], c.cardPlayCycles[i]);
+        }
+    }
+
+    os << "monster turns:\n";
+    for (int i = 0; i < MONSTER_ID_COUNT; ++i) {
+        if (c.monsterTurnCount[i]) {
+            printRow(monsterIdStrings[i], c.monsterTurnCount[i], c.monsterTurnCycles[i]);
+        }
+    }
+
+    os << "search phases:\n";
+    for (int i = 0; i < SEARCH_PHASE_COUNT; ++i) {
+        printRow(searchPhaseStrings[i], c.searchPhaseCount[i], c.searchPhaseCycles[i]);
+    }
+
+    os << "actionQueue pushes: " << c.actionQueuePushCount
+       << " pops: " << c.actionQueuePopCount
+       << " maxDepth: " << c.actionQueueMaxDepth << '\n';
+    os << "BattleContext copies: " << c.battleContextCopies << '\n';
+}
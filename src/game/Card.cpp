@@ -4,6 +4,8 @@
 
 #include <game/Card.h>
 
+#include "constants/CardInfo.h"
+
 using namespace sts;
 
 void Card::upgrade() {
@@ -30,15 +32,15 @@ bool Card::isUpgraded() const {
 }
 
 bool Card::isInnate() const {
-    return isCardInnate(id, upgraded);
+    return getCardInfo(id, upgraded).has(CardInfo::INNATE);
 }
 
 bool Card::isStrikeCard() const {
-    return isCardStrikeCard(id);
+    return getCardInfo(id, upgraded).has(CardInfo::STRIKE);
 }
 
 CardType Card::getType() const {
-    return getCardType(id);
+    return getCardInfo(id, upgraded).getType();
 }
 
 const char *Card::getName() const { // todo show if upgraded
@@ -46,15 +48,15 @@ const char *Card::getName() const { // todo show if upgraded
 }
 
 CardRarity Card::getRarity() const {
-    return getCardRarity(id);
+    return getCardInfo(id, upgraded).getRarity();
 }
 
 int Card::getBaseDamage() const {
-    return cardBaseDamage[upgraded ? 1 : 0][static_cast<int>(id)];
+    return getCardInfo(id, upgraded).baseDamage;
 }
 
 bool Card::isStarterStrikeOrDefend() const {
-    return sts::isStarterStrikeOrDefend(id);
+    return getCardInfo(id, upgraded).has(CardInfo::STARTER_STRIKE_OR_DEFEND);
 }
 
 bool Card::isStarterStrike() const {
@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <stdexcept>
+#include <string>
 
 #include "constants/RelicPools.h"
 #include "constants/CardPools.h"
@@ -47,16 +49,14 @@ GameContext::GameContext(CharacterClass cc, std::uint64_t seed, int ascension)
     miscRng(seed),
     mathUtilRng(seed-897897), // uses a time based seed -_-
     cc(cc),
-    map(new Map(Map::fromSeed(seed, ascension, 1, true))),
+    map(MapCache::get(seed, ascension, 1, true)),
     ascension(ascension) {
-    eventList.insert(eventList.end(), EventPools::Act1::events.begin(), EventPools::Act1::events.end());
-    shrineList.insert(shrineList.end(), EventPools::Act1::shrines.begin(), EventPools::Act1::shrines.end());
+    eventList.insert(EventPools::Act1::events.begin(), EventPools::Act1::events.end());
+    shrineList.insert(EventPools::Act1::shrines.begin(), EventPools::Act1::shrines.end());
     if (ascension < 15) {
-        specialOneTimeEventList.insert(specialOneTimeEventList.end(), EventPools::oneTimeEventsAsc0.begin(),
-                                       EventPools::oneTimeEventsAsc0.end());
+        specialOneTimeEventList.insert(EventPools::oneTimeEventsAsc0.begin(), EventPools::oneTimeEventsAsc0.end());
     } else {
-        specialOneTimeEventList.insert(specialOneTimeEventList.end(), EventPools::oneTimeEventsAsc15.begin(),
-                                       EventPools::oneTimeEventsAsc15.end());
+        specialOneTimeEventList.insert(EventPools::oneTimeEventsAsc15.begin(), EventPools::oneTimeEventsAsc15.end());
     }
 
     generateMonsters();
@@ -71,7 +71,30 @@ GameContext::GameContext(CharacterClass cc, std::uint64_t seed, int ascension)
     screenState = ScreenState::EVENT_SCREEN;
 }
 
+namespace {
+    void checkSaveListSize(const char *name, std::size_t size, int capacity) {
+        if (size > static_cast<std::size_t>(capacity)) {
+            throw std::runtime_error(std::string("save file: ") + name + " has " + std::to_string(size)
+                + " entries, at most " + std::to_string(capacity) + " are supported");
+        }
+    }
+}
+
 void GameContext::initFromSave(const SaveFile &s) {
+    // the pools are fixed size, a save listing more than fits did not come from the game
+    checkSaveListSize("event_list", s.event_list.size(), eventList.max_size());
+    checkSaveListSize("one_time_event_list", s.one_time_event_list.size(), specialOneTimeEventList.max_size());
+    checkSaveListSize("common_relics", s.common_relics.size(), commonRelicPool.max_size());
+    checkSaveListSize("uncommon_relics", s.uncommon_relics.size(), uncommonRelicPool.max_size());
+    checkSaveListSize("rare_relics", s.rare_relics.size(), rareRelicPool.max_size());
+    checkSaveListSize("shop_relics", s.shop_relics.size(), shopRelicPool.max_size());
+    checkSaveListSize("boss_relics", s.boss_relics.size(), bossRelicPool.max_size());
+    checkSaveListSize("monster_list", s.monster_list.size(), 16);
+    checkSaveListSize("elite_monster_list", s.elite_monster_list.size(), 10);
+    if (s.boss_list.empty()) {
+        throw std::runtime_error("save file: boss_list is empty");
+    }
+
     seed = s.seed;
 
     outcome = GameOutcome::UNDECIDED;
@@ -119,12 +142,12 @@ void GameContext::initFromSave(const SaveFile &s) {
     shrineList.clear();
     switch (act) {
         case 1:
-            shrineList.insert(shrineList.begin(), EventPools::Act1::shrines.begin(), EventPools::Act1::shrines.end());
+            shrineList.insert(EventPools::Act1::shrines.begin(), EventPools::Act1::shrines.end());
             break;
 
         case 2:
         case 3:
-            shrineList.insert(shrineList.begin(), EventPools::Act2::shrines.begin(), EventPools::Act2::shrines.end());
+            shrineList.insert(EventPools::Act2::shrines.begin(), EventPools::Act2::shrines.end());
             break;
 
         case 4:
@@ -132,18 +155,14 @@ void GameContext::initFromSave(const SaveFile &s) {
             break;
     }
 
-    eventList.insert(eventList.begin(), s.event_list.begin(), s.event_list.end());
-    specialOneTimeEventList.insert(
-            specialOneTimeEventList.begin(),
-            s.one_time_event_list.begin(),
-            s.one_time_event_list.end()
-    );
+    eventList.insert(s.event_list.begin(), s.event_list.end());
+    specialOneTimeEventList.insert(s.one_time_event_list.begin(), s.one_time_event_list.end());
 
-    commonRelicPool.insert(commonRelicPool.begin(), s.common_relics.begin(), s.common_relics.end());
-    uncommonRelicPool.insert(uncommonRelicPool.begin(), s.uncommon_relics.begin(), s.uncommon_relics.end());
-    rareRelicPool.insert(rareRelicPool.begin(), s.rare_relics.begin(), s.rare_relics.end());
-    shopRelicPool.insert(shopRelicPool.begin(), s.shop_relics.begin(), s.shop_relics.end());
-    bossRelicPool.insert(bossRelicPool.begin(), s.boss_relics.begin(), s.boss_relics.end());
+    commonRelicPool.insert(s.common_relics.begin(), s.common_relics.end());
+    uncommonRelicPool.insert(s.uncommon_relics.begin(), s.uncommon_relics.end());
+    rareRelicPool.insert(s.rare_relics.begin(), s.rare_relics.end());
+    shopRelicPool.insert(s.shop_relics.begin(), s.shop_relics.end());
+    bossRelicPool.insert(s.boss_relics.begin(), s.boss_relics.end());
 
 
 //    std::cout << "monsterListSize: " << s.monster_list.size() << std::endl;
@@ -157,18 +176,12 @@ void GameContext::initFromSave(const SaveFile &s) {
     monsterListOffset = 0;
     monsterList = {};
     for (auto m : s.monster_list) {
-        if (monsterList.size() == 16) {
-            assert(false);
-        }
         monsterList.push_back(m);
     }
 
     eliteMonsterListOffset = 0;
     eliteMonsterList = {};
     for (auto m : s.elite_monster_list) {
-        if (eliteMonsterList.size() == 10) {
-            assert(false);
-        }
         eliteMonsterList.push_back(m);
     }
 
@@ -214,7 +227,7 @@ void GameContext::initFromSave(const SaveFile &s) {
         potions[i] = p;
     }
 
-    map = std::make_shared<Map>(Map::fromSeed(seed, ascension, act, true));
+    map = MapCache::get(seed, ascension, act, true);
 
     regainControlAction = [](GameContext &gc) {
         gc.afterBattle();
@@ -430,46 +443,46 @@ void GameContext::initRelics() {
     switch (cc) {
 
         case CharacterClass::IRONCLAD:
-            commonRelicPool.insert(commonRelicPool.end(), Ironclad::commonRelicPool.begin(), Ironclad::commonRelicPool.end());
-            uncommonRelicPool.insert(uncommonRelicPool.end(), Ironclad::uncommonRelicPool.begin(), Ironclad::uncommonRelicPool.end());
-            rareRelicPool.insert(rareRelicPool.end(), Ironclad::rareRelicPool.begin(), Ironclad::rareRelicPool.end());
-            shopRelicPool.insert(shopRelicPool.end(), Ironclad::shopRelicPool.begin(), Ironclad::shopRelicPool.end());
-            bossRelicPool.insert(bossRelicPool.end(), Ironclad::bossRelicPool.begin(), Ironclad::bossRelicPool.end());
+            commonRelicPool.insert(Ironclad::commonRelicPool.begin(), Ironclad::commonRelicPool.end());
+            uncommonRelicPool.insert(Ironclad::uncommonRelicPool.begin(), Ironclad::uncommonRelicPool.end());
+            rareRelicPool.insert(Ironclad::rareRelicPool.begin(), Ironclad::rareRelicPool.end());
+            shopRelicPool.insert(Ironclad::shopRelicPool.begin(), Ironclad::shopRelicPool.end());
+            bossRelicPool.insert(Ironclad::bossRelicPool.begin(), Ironclad::bossRelicPool.end());
             break;
 
         case CharacterClass::SILENT:
-            commonRelicPool.insert(commonRelicPool.end(), Silent::commonRelicPool.begin(), Silent::commonRelicPool.end());
-            uncommonRelicPool.insert(uncommonRelicPool.end(), Silent::uncommonRelicPool.begin(), Silent::uncommonRelicPool.end());
-            rareRelicPool.insert(rareRelicPool.end(), Silent::rareRelicPool.begin(), Silent::rareRelicPool.end());
-            shopRelicPool.insert(shopRelicPool.end(), Silent::shopRelicPool.begin(), Silent::shopRelicPool.end());
-            bossRelicPool.insert(bossRelicPool.end(), Silent::bossRelicPool.begin(), Silent::bossRelicPool.end());
+            commonRelicPool.insert(Silent::commonRelicPool.begin(), Silent::commonRelicPool.end());
+            uncommonRelicPool.insert(Silent::uncommonRelicPool.begin(), Silent::uncommonRelicPool.end());
+            rareRelicPool.insert(Silent::rareRelicPool.begin(), Silent::rareRelicPool.end());
+            shopRelicPool.insert(Silent::shopRelicPool.begin(), Silent::shopRelicPool.end());
+            bossRelicPool.insert(Silent::bossRelicPool.begin(), Silent::bossRelicPool.end());
             break;
 
         case CharacterClass::DEFECT:
-            commonRelicPool.insert(commonRelicPool.end(), Defect::commonRelicPool.begin(), Defect::commonRelicPool.end());
-            uncommonRelicPool.insert(uncommonRelicPool.end(), Defect::uncommonRelicPool.begin(), Defect::uncommonRelicPool.end());
-            rareRelicPool.insert(rareRelicPool.end(), Defect::rareRelicPool.begin(), Defect::rareRelicPool.end());
-            shopRelicPool.insert(shopRelicPool.end(), Defect::shopRelicPool.begin(), Defect::shopRelicPool.end());
-            bossRelicPool.insert(bossRelicPool.end(), Defect::bossRelicPool.begin(), Defect::bossRelicPool.end());
+            commonRelicPool.insert(Defect::commonRelicPool.begin(), Defect::commonRelicPool.end());
+            uncommonRelicPool.insert(Defect::uncommonRelicPool.begin(), Defect::uncommonRelicPool.end());
+            rareRelicPool.insert(Defect::rareRelicPool.begin(), Defect::rareRelicPool.end());
+            shopRelicPool.insert(Defect::shopRelicPool.begin(), Defect::shopRelicPool.end());
+            bossRelicPool.insert(Defect::bossRelicPool.begin(), Defect::bossRelicPool.end());
             break;
 
         case CharacterClass::WATCHER:
-            commonRelicPool.insert(commonRelicPool.end(), Watcher::commonRelicPool.begin(), Watcher::commonRelicPool.end());
-            uncommonRelicPool.insert(uncommonRelicPool.end(), Watcher::uncommonRelicPool.begin(), Watcher::uncommonRelicPool.end());
-            rareRelicPool.insert(rareRelicPool.end(), Watcher::rareRelicPool.begin(), Watcher::rareRelicPool.end());
-            shopRelicPool.insert(shopRelicPool.end(), Watcher::shopRelicPool.begin(), Watcher::shopRelicPool.end());
-            bossRelicPool.insert(bossRelicPool.end(), Watcher::bossRelicPool.begin(), Watcher::bossRelicPool.end());
+            commonRelicPool.insert(Watcher::commonRelicPool.begin(), Watcher::commonRelicPool.end());
+            uncommonRelicPool.insert(Watcher::uncommonRelicPool.begin(), Watcher::uncommonRelicPool.end());
+            rareRelicPool.insert(Watcher::rareRelicPool.begin(), Watcher::rareRelicPool.end());
+            shopRelicPool.insert(Watcher::shopRelicPool.begin(), Watcher::shopRelicPool.end());
+            bossRelicPool.insert(Watcher::bossRelicPool.begin(), Watcher::bossRelicPool.end());
             break;
 
         default:
             break;
     }
 
-    java::Collections::shuffle(commonRelicPool.begin(), commonRelicPool.end(), java::Random(relicRng.nextLong()));
-    java::Collections::shuffle(uncommonRelicPool.begin(), uncommonRelicPool.end(), java::Random(relicRng.nextLong()));
-    java::Collections::shuffle(rareRelicPool.begin(), rareRelicPool.end(), java::Random(relicRng.nextLong()));
-    java::Collections::shuffle(shopRelicPool.begin(), shopRelicPool.end(), java::Random(relicRng.nextLong()));
-    java::Collections::shuffle(bossRelicPool.begin(), bossRelicPool.end(), java::Random(relicRng.nextLong()));
+    java::Collections::shuffle(commonRelicPool.slots_begin(), commonRelicPool.slots_end(), java::Random(relicRng.nextLong()));
+    java::Collections::shuffle(uncommonRelicPool.slots_begin(), uncommonRelicPool.slots_end(), java::Random(relicRng.nextLong()));
+    java::Collections::shuffle(rareRelicPool.slots_begin(), rareRelicPool.slots_end(), java::Random(relicRng.nextLong()));
+    java::Collections::shuffle(shopRelicPool.slots_begin(), shopRelicPool.slots_end(), java::Random(relicRng.nextLong()));
+    java::Collections::shuffle(bossRelicPool.slots_begin(), bossRelicPool.slots_end(), java::Random(relicRng.nextLong()));
 
 }
 
@@ -706,9 +719,9 @@ void GameContext::transitionToAct(int targetAct) {
     curMapNodeX = -1;
     curMapNodeY = -1;
     if (targetAct == 2 || targetAct == 3) {
-        *map = Map::fromSeed(seed, ascension, targetAct, !hasKey(Key::EMERALD_KEY));
+        map = MapCache::get(seed, ascension, targetAct, !hasKey(Key::EMERALD_KEY));
     } else if (targetAct == 4) {
-        *map = Map::act4Map();
+        map = MapCache::getAct4Map();
     }
 
     colorlessCardPool = baseColorlessPool;
@@ -739,12 +752,12 @@ void GameContext::transitionToAct(int targetAct) {
     eventList.clear();
     shrineList.clear();
     if (targetAct == 2) {
-        eventList.insert(eventList.end(), EventPools::Act2::events.begin(), EventPools::Act2::events.end());
-        shrineList.insert(shrineList.end(), EventPools::Act2::shrines.begin(), EventPools::Act2::shrines.end());
+        eventList.insert(EventPools::Act2::events.begin(), EventPools::Act2::events.end());
+        shrineList.insert(EventPools::Act2::shrines.begin(), EventPools::Act2::shrines.end());
 
     } else if (targetAct == 3) {
-        eventList.insert(eventList.end(), EventPools::Act3::events.begin(), EventPools::Act3::events.end());
-        shrineList.insert(shrineList.end(), EventPools::Act3::shrines.begin(), EventPools::Act3::shrines.end());
+        eventList.insert(EventPools::Act3::events.begin(), EventPools::Act3::events.end());
+        shrineList.insert(EventPools::Act3::shrines.begin(), EventPools::Act3::shrines.end());
     }
 
     screenState = ScreenState::MAP_SCREEN;
@@ -1469,62 +1482,50 @@ bool GameContext::obtainRelic(RelicId r) {
 
 
 RelicId GameContext::returnRandomRelic(RelicTier tier, bool shopRoom, bool fromFront) {
-    RelicId retVal = RelicId::INVALID;
-    std::vector<RelicId> *vec;
+    ordered_pool<RelicId, 40> *pool;
 
     switch(tier) {
 
         case RelicTier::COMMON:
             if (commonRelicPool.empty()) {
-                retVal = returnRandomRelic(RelicTier::UNCOMMON, shopRoom);
-            } else {
-                vec = &commonRelicPool;
+                return returnRandomRelic(RelicTier::UNCOMMON, shopRoom);
             }
+            pool = &commonRelicPool;
             break;
 
         case RelicTier::UNCOMMON:
             if (uncommonRelicPool.empty()) {
-                retVal = returnRandomRelic(RelicTier::RARE, shopRoom);
-            } else {
-                vec = &uncommonRelicPool;
+                return returnRandomRelic(RelicTier::RARE, shopRoom);
             }
+            pool = &uncommonRelicPool;
             break;
 
         case RelicTier::RARE:
             if (rareRelicPool.empty()) {
-                retVal = RelicId::CIRCLET;
-            } else {
-                vec = &rareRelicPool;
+                return RelicId::CIRCLET;
             }
+            pool = &rareRelicPool;
             break;
 
         case RelicTier::SHOP:
             if (shopRelicPool.empty()) {
-                retVal = returnRandomRelic(RelicTier::UNCOMMON, shopRoom);
-            } else {
-                vec = &shopRelicPool;
+                return returnRandomRelic(RelicTier::UNCOMMON, shopRoom);
             }
+            pool = &shopRelicPool;
             break;
 
         case RelicTier::BOSS:
             if (bossRelicPool.empty()) {
-                retVal = RelicId::RED_CIRCLET;
-            } else {
-                vec = &bossRelicPool;
+                return RelicId::RED_CIRCLET;
             }
+            pool = &bossRelicPool;
             break;
 
         default:
-            break;
+            return RelicId::INVALID;
     };
 
-    if (fromFront) {
-        retVal = vec->front();
-        vec->erase(vec->begin());
-    } else {
-        retVal = vec->back();
-        vec->erase(vec->end()-1);
-    }
+    const RelicId retVal = fromFront ? pool->pop_front() : pool->pop_back();
 
     bool canSpawn = relicCanSpawn(retVal, shopRoom);
     if (canSpawn) {
@@ -1968,39 +1969,24 @@ Rewards GameContext::createBossCombatReward() {
     return reward;
 }
 
-Event GameContext::getShrine(Random &eventRngCopy) {  // todo fix, this is slow
-    int tempLength = 0;
-    Event tempShrines[20];
-
-    for (auto shrine : shrineList) {
-        if (shrine != Event::MATCH_AND_KEEP || !disableMatchAndKeep) {
-            tempShrines[tempLength++] = shrine;
-        }
+Event GameContext::getShrine(Random &eventRngCopy) {
+    // the game picks from the shrines followed by the one time events that can currently appear
+    auto shrineMask = shrineList.mask();
+    if (disableMatchAndKeep) {
+        shrineMask = shrineList.filter([](Event e) { return e != Event::MATCH_AND_KEEP; });
     }
+    const auto oneTimeMask = specialOneTimeEventList.filter([&](Event e) { return canAddOneTimeEvent(e); });
 
-    for (auto event : specialOneTimeEventList) {
-        if (canAddOneTimeEvent(event)) {
-            tempShrines[tempLength++] = event;
-        }
-    }
+    const int shrineCount = bits::popcount(shrineMask);
+    const int tempLength = shrineCount + bits::popcount(oneTimeMask);
 
     const auto idx = eventRngCopy.random(tempLength-1);
-    const auto shrine = tempShrines[idx];
-    bool didRemove = false;
-    for (auto it = shrineList.begin(); it != shrineList.end(); ++it) {
-        if (*it == shrine) {
-            shrineList.erase(it);
-            didRemove = true;
-            break;
-        }
-    }
-    for (auto it = specialOneTimeEventList.begin(); it != specialOneTimeEventList.end(); ++it) {
-        if (*it == shrine) {
-            specialOneTimeEventList.erase(it);
-            didRemove = true;
-            break;
-        }
-    }
+    const auto shrine = idx < shrineCount ?
+            shrineList.slot(bits::select(shrineMask, idx)) :
+            specialOneTimeEventList.slot(bits::select(oneTimeMask, idx-shrineCount));
+
+    bool didRemove = shrineList.erase_first(shrine);
+    didRemove |= specialOneTimeEventList.erase_first(shrine);
 #ifdef sts_asserts
     assert(didRemove);
 #endif
@@ -2008,25 +1994,15 @@ Event GameContext::getShrine(Random &eventRngCopy) {  // todo fix, this is slow
 }
 
 Event GameContext::getEvent(Random &eventRngCopy) {
-    int tempLength = 0;
-    Event tempEvents[14];
-
-    for (auto event : eventList) {
-        if (canAddEvent(event)) {
-            tempEvents[tempLength++] = event;
-        }
-    }
-
-    if (tempLength == 0) {
+    const auto eventMask = eventList.filter([&](Event e) { return canAddEvent(e); });
+    if (eventMask == 0) {
         return getShrine(eventRng);
     }
 
-    auto idx = eventRngCopy.random(tempLength-1);
-    Event event = tempEvents[idx];
-
-    auto eventListPos = std::find(eventList.begin(), eventList.end(), event);
-    eventList.erase(eventListPos);
-    return tempEvents[idx];
+    const auto idx = eventRngCopy.random(bits::popcount(eventMask)-1);
+    const auto event = eventList.slot(bits::select(eventMask, idx));
+    eventList.erase_first(event);
+    return event;
 }
 
 Event GameContext::generateEvent(Random eventRngCopy) {
@@ -2,8 +2,10 @@
 // Created by gamerpuppy on 6/24/2021.
 //
 
+#include <atomic>
 #include <cmath>
 #include <cassert>
+#include <mutex>
 
 #include "game/Map.h"
 #include "game/Random.h"
@@ -35,14 +37,6 @@ void assignBurningElite(Map &map, Random &mapRng);
 Map::Map(std::uint64_t seed, int ascension, int act, bool assignBurningElite)
     : Map(Map::fromSeed(seed,ascension,act,assignBurningElite)) {}
 
-MapNode &Map::getNode(int x, int y) {
-    return nodes.at(y).at(x);
-}
-
-const MapNode &Map::getNode(int x, int y) const {
-    return nodes.at(y).at(x);
-}
-
 void initNodes(Map &map) {
     for (int y = 0; y < MAP_HEIGHT; y++) {
         for (int x = 0; x < MAP_WIDTH; x++) {
@@ -758,3 +752,125 @@ void assignBurningElite(Map &map, Random &mapRng) {
     map.burningEliteY = eliteRooms.at(idx).y;
 }
 
+
+// ************************************************************
+
+PackedMap PackedMap::pack(const Map &map) {
+    PackedMap ret;
+    for (int y = 0; y < 15; ++y) {
+        for (int x = 0; x < 7; ++x) {
+            const auto &node = map.nodes[y][x];
+            int edgeMask = 0;
+            for (int i = 0; i < node.edgeCount; ++i) {
+                // the top row only has the edge to the boss at x 3, stored in the middle bit
+                edgeMask |= y == 14 ? 0x2 : 1 << (node.edges[i] - x + 1);
+            }
+            ret.nodes[y*7+x] = static_cast<std::uint8_t>(static_cast<int>(node.room) | edgeMask << 4);
+        }
+    }
+    ret.burningEliteX = static_cast<std::int8_t>(map.burningEliteX);
+    ret.burningEliteY = static_cast<std::int8_t>(map.burningEliteY);
+    ret.burningEliteBuff = static_cast<std::int8_t>(map.burningEliteBuff);
+    return ret;
+}
+
+Map PackedMap::unpack() const {
+    Map map;
+    initNodes(map);
+    map.burningEliteX = burningEliteX;
+    map.burningEliteY = burningEliteY;
+    map.burningEliteBuff = burningEliteBuff;
+
+    for (int y = 0; y < 15; ++y) {
+        for (int x = 0; x < 7; ++x) {
+            auto &node = map.nodes[y][x];
+            node.room = getRoom(x, y);
+
+            const int edgeMask = getEdgeMask(x, y);
+            if (y == 14) {
+                if (edgeMask) {
+                    node.addEdge(3);
+                }
+                continue;
+            }
+            for (int i = 0; i < 3; ++i) {
+                if (edgeMask & (1 << i)) {
+                    node.addEdge(x+i-1);
+                    map.nodes[y+1][x+i-1].addParent(x);
+                }
+            }
+        }
+    }
+    return map;
+}
+
+bool PackedMap::operator==(const PackedMap &rhs) const {
+    return nodes == rhs.nodes &&
+        burningEliteX == rhs.burningEliteX &&
+        burningEliteY == rhs.burningEliteY &&
+        burningEliteBuff == rhs.burningEliteBuff;
+}
+
+namespace {
+
+    struct MapCacheSlot {
+        std::uint64_t seed = 0;
+        std::int32_t keyBits = -1; // ascension, act and burning elite, -1 when empty
+        std::shared_ptr<const Map> map;
+    };
+
+    constexpr int MAP_CACHE_LOCK_COUNT = 64;
+
+    std::array<MapCacheSlot, MapCache::SLOT_COUNT> mapCacheSlots;
+    std::array<std::mutex, MAP_CACHE_LOCK_COUNT> mapCacheLocks;
+    std::atomic<std::uint64_t> mapCacheHits {0};
+    std::atomic<std::uint64_t> mapCacheMisses {0};
+
+}
+
+std::shared_ptr<const Map> MapCache::get(std::uint64_t seed, int ascension, int act, bool assignBurningElite) {
+    const std::int32_t keyBits = ascension << 8 | act << 1 | static_cast<int>(assignBurningElite);
+    const auto hash = (seed ^ static_cast<std::uint64_t>(keyBits) * 0x9E3779B97F4A7C15ULL) * 0xBF58476D1CE4E5B9ULL;
+    const int slotIdx = static_cast<int>(hash >> 32) & (SLOT_COUNT-1);
+
+    auto &slot = mapCacheSlots[slotIdx];
+    {
+        std::scoped_lock lock(mapCacheLocks[slotIdx % MAP_CACHE_LOCK_COUNT]);
+        if (slot.keyBits == keyBits && slot.seed == seed) {
+            ++mapCacheHits;
+            return slot.map;
+        }
+    }
+
+    // generate outside of the lock, two threads missing on the same key both generate the same map
+    auto map = std::make_shared<const Map>(Map::fromSeed(seed, ascension, act, assignBurningElite));
+    ++mapCacheMisses;
+
+    std::scoped_lock lock(mapCacheLocks[slotIdx % MAP_CACHE_LOCK_COUNT]);
+    slot.seed = seed;
+    slot.keyBits = keyBits;
+    slot.map = map;
+    return map;
+}
+
+std::shared_ptr<const Map> MapCache::getAct4Map() {
+    static const std::shared_ptr<const Map> act4Map = std::make_shared<const Map>(Map::act4Map());
+    return act4Map;
+}
+
+void MapCache::clear() {
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        std::scoped_lock lock(mapCacheLocks[i % MAP_CACHE_LOCK_COUNT]);
+        mapCacheSlots[i] = MapCacheSlot();
+    }
+    mapCacheHits = 0;
+    mapCacheMisses = 0;
+}
+
+std::uint64_t MapCache::getHitCount() {
+    return mapCacheHits;
+}
+
+std::uint64_t MapCache::getMissCount() {
+    return mapCacheMisses;
+}
@@ -0,0 +1,251 @@
+#include "game/MapPathPlanner.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace sts;
+
+static PathCounts getRoomCounts(const Map &map, int x, int y) {
+    switch (map.nodes[y][x].room) {
+        case Room::ELITE: {
+            PathCounts ret = 1 << (4*static_cast<int>(PathObjective::ELITE));
+            if (map.burningEliteX == x && map.burningEliteY == y) {
+                ret |= 1 << (4*static_cast<int>(PathObjective::BURNING_ELITE));
+            }
+            return ret;
+        }
+        case Room::REST: return 1 << (4*static_cast<int>(PathObjective::REST));
+        case Room::SHOP: return 1 << (4*static_cast<int>(PathObjective::SHOP));
+        case Room::EVENT: return 1 << (4*static_cast<int>(PathObjective::EVENT));
+        case Room::MONSTER: return 1 << (4*static_cast<int>(PathObjective::MONSTER));
+        default: return 0;
+    }
+}
+
+// keeps the leftmost route for each distinct counts
+static void dedupe(std::vector<MapPath> &paths) {
+    std::sort(paths.begin(), paths.end(), [](const MapPath &a, const MapPath &b) {
+        return a.counts < b.counts || (a.counts == b.counts && a.route < b.route);
+    });
+    paths.erase(std::unique(paths.begin(), paths.end(), [](const MapPath &a, const MapPath &b) {
+        return a.counts == b.counts;
+    }), paths.end());
+}
+
+fixed_list<int,16> MapPath::toRoute() const {
+    fixed_list<int,16> ret;
+    for (int y = firstRow; y <= lastRow; ++y) {
+        ret.push_back(getX(y));
+    }
+    ret.push_back(0);
+    return ret;
+}
+
+bool MapPathQuery::isSatisfiedBy(PathCounts counts) const {
+    for (int i = 0; i < PATH_OBJECTIVE_COUNT; ++i) {
+        const int c = (counts >> (4*i)) & 0xF;
+        if (c < minCounts[i] || c > maxCounts[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int MapPathQuery::score(PathCounts counts) const {
+    int ret = 0;
+    for (int i = 0; i < PATH_OBJECTIVE_COUNT; ++i) {
+        ret += weights[i] * static_cast<int>((counts >> (4*i)) & 0xF);
+    }
+    return ret;
+}
+
+void MapPathPlanner::init(const Map &map, int startX, int startY) {
+    paths.clear();
+
+    std::array<std::vector<MapPath>, 7> cur;
+    std::array<std::vector<MapPath>, 7> next;
+
+    if (startY >= 0) {
+        startRow = startY + 1;
+        MapPath p;
+        p.firstRow = static_cast<std::int8_t>(startY + 1);
+        p.lastRow = static_cast<std::int8_t>(startY);
+        cur[startX].push_back(p);
+
+    } else {
+        startRow = 0;
+        for (int x = 0; x < 7; ++x) {
+            if (map.nodes[0][x].edgeCount > 0) {
+                MapPath p;
+                p.counts = getRoomCounts(map, x, 0);
+                p.route = x;
+                p.lastRow = 0;
+                cur[x].push_back(p);
+            }
+        }
+    }
+
+    for (int y = std::max(0, startY); y < 15; ++y) {
+        for (auto &v : next) {
+            v.clear();
+        }
+
+        for (int x = 0; x < 7; ++x) {
+            if (cur[x].empty()) {
+                continue;
+            }
+
+            const auto &node = map.nodes[y][x];
+            if (node.edgeCount == 0 || y == 14) { // the path ends before the boss
+                paths.insert(paths.end(), cur[x].begin(), cur[x].end());
+                continue;
+            }
+
+            for (int i = 0; i < node.edgeCount; ++i) {
+                const auto edge = node.edges[i];
+                const auto roomCounts = getRoomCounts(map, edge, y+1);
+                for (auto p : cur[x]) {
+                    p.counts += roomCounts;
+                    p.route |= static_cast<std::uint64_t>(edge) << (3*(y+1));
+                    p.lastRow = static_cast<std::int8_t>(y+1);
+                    next[edge].push_back(p);
+                }
+            }
+        }
+
+        for (auto &v : next) {
+            dedupe(v);
+        }
+        std::swap(cur, next);
+    }
+
+    dedupe(paths);
+}
+
+std::optional<MapPath> MapPathPlanner::query(const MapPathQuery &q) const {
+    const MapPath *best = nullptr;
+    int bestScore = 0;
+    for (const auto &p : paths) {
+        if (!q.isSatisfiedBy(p.counts)) {
+            continue;
+        }
+        const int score = q.score(p.counts);
+        if (best == nullptr || score > bestScore) {
+            best = &p;
+            bestScore = score;
+        }
+    }
+    if (best == nullptr) {
+        return std::nullopt;
+    }
+    return *best;
+}
+
+std::vector<MapPath> MapPathPlanner::getParetoFrontier(const std::array<std::int8_t, PATH_OBJECTIVE_COUNT> &directions) const {
+    // flip minimized objectives so that larger is always better, ignored objectives become 0
+    const auto normalize = [&](PathCounts counts) {
+        std::array<int, PATH_OBJECTIVE_COUNT> ret {};
+        for (int i = 0; i < PATH_OBJECTIVE_COUNT; ++i) {
+            ret[i] = directions[i] * static_cast<int>((counts >> (4*i)) & 0xF);
+        }
+        return ret;
+    };
+
+    std::vector<std::array<int, PATH_OBJECTIVE_COUNT>> values;
+    values.reserve(paths.size());
+    for (const auto &p : paths) {
+        values.push_back(normalize(p.counts));
+    }
+
+    std::vector<MapPath> ret;
+    for (int i = 0; i < paths.size(); ++i) {
+        bool dominated = false;
+        for (int j = 0; j < paths.size() && !dominated; ++j) {
+            if (i == j) {
+                continue;
+            }
+            bool allGreaterEqual = true;
+            bool anyGreater = false;
+            for (int k = 0; k < PATH_OBJECTIVE_COUNT; ++k) {
+                allGreaterEqual &= values[j][k] >= values[i][k];
+                anyGreater |= values[j][k] > values[i][k];
+            }
+            // with ignored objectives two entries can be equal, keep only the first of them
+            dominated = allGreaterEqual && (anyGreater || j < i);
+        }
+        if (!dominated) {
+            ret.push_back(paths[i]);
+        }
+    }
+    return ret;
+}
+
+namespace {
+
+    struct MapPathBatchInfo {
+        std::uint64_t startSeed;
+        int seedCount;
+        int ascension;
+        const std::vector<int> *acts;
+        const MapPathQuery *q;
+        std::vector<MapPathPlanner::BatchResult> *results;
+
+        std::mutex m;
+        int curSeedIdx = 0;
+    };
+
+    void mapPathBatchRunner(MapPathBatchInfo *info) {
+        MapPathPlanner planner;
+        while (true) {
+            int seedIdx;
+            {
+                std::scoped_lock lock(info->m);
+                seedIdx = info->curSeedIdx++;
+            }
+            if (seedIdx >= info->seedCount) {
+                break;
+            }
+
+            const auto seed = info->startSeed + seedIdx;
+            for (int i = 0; i < info->acts->size(); ++i) {
+                const int act = (*info->acts)[i];
+                planner.init(Map::fromSeed(seed, info->ascension, act, true));
+
+                auto &result = (*info->results)[seedIdx * info->acts->size() + i];
+                result.seed = seed;
+                result.act = act;
+                result.path = planner.query(*info->q);
+            }
+        }
+    }
+
+}
+
+std::vector<MapPathPlanner::BatchResult> MapPathPlanner::queryBatch(std::uint64_t startSeed, int seedCount, int ascension,
+                                                                    const std::vector<int> &acts, const MapPathQuery &q, int threadCount) {
+    std::vector<BatchResult> results(seedCount * acts.size());
+
+    MapPathBatchInfo info;
+    info.startSeed = startSeed;
+    info.seedCount = seedCount;
+    info.ascension = ascension;
+    info.acts = &acts;
+    info.q = &q;
+    info.results = &results;
+
+    if (threadCount <= 1) {
+        mapPathBatchRunner(&info);
+        return results;
+    }
+
+    std::vector<std::unique_ptr<std::thread>> threads;
+    for (int tid = 0; tid < threadCount; ++tid) {
+        threads.emplace_back(new std::thread(mapPathBatchRunner, &info));
+    }
+    for (auto &t : threads) {
+        t->join();
+    }
+    return results;
+}
@@ -0,0 +1,118 @@
+#include "game/RngOracle.h"
+
+#include <cassert>
+
+using namespace sts;
+
+RngOracle::RngOracle(const GameContext &gc) {
+    fork.seed = gc.seed;
+
+    fork.cardRng = gc.cardRng;
+    fork.merchantRng = gc.merchantRng;
+    fork.potionRng = gc.potionRng;
+    fork.relicRng = gc.relicRng;
+    fork.treasureRng = gc.treasureRng;
+
+    fork.commonRelicPool = gc.commonRelicPool;
+    fork.uncommonRelicPool = gc.uncommonRelicPool;
+    fork.rareRelicPool = gc.rareRelicPool;
+    fork.shopRelicPool = gc.shopRelicPool;
+    fork.bossRelicPool = gc.bossRelicPool;
+    fork.colorlessCardPool = gc.colorlessCardPool;
+
+    fork.potionChance = gc.potionChance;
+    fork.cardRarityFactor = gc.cardRarityFactor;
+    fork.shopRemoveCount = gc.shopRemoveCount;
+
+    fork.map = gc.map;
+    fork.curMapNodeX = gc.curMapNodeX;
+    fork.curMapNodeY = gc.curMapNodeY;
+    fork.act = gc.act;
+    fork.ascension = gc.ascension;
+    fork.floorNum = gc.floorNum;
+    fork.cc = gc.cc;
+
+    fork.relics = gc.relics;
+    fork.deck = gc.deck;
+    fork.blueKey = gc.blueKey;
+    fork.greenKey = gc.greenKey;
+    fork.redKey = gc.redKey;
+}
+
+CardReward RngOracle::nextCardReward(Room room) {
+    return fork.createCardReward(room);
+}
+
+Rewards RngOracle::nextCombatReward(Room room) {
+    switch (room) {
+        case Room::MONSTER:
+            return fork.createCombatReward();
+
+        case Room::ELITE:
+            return fork.createEliteCombatReward();
+
+        default:
+#ifdef sts_asserts
+            assert(false);
+#endif
+            return {};
+    }
+}
+
+Shop RngOracle::nextShop() {
+    Shop shop;
+    shop.setup(fork);
+    return shop;
+}
+
+Rewards RngOracle::nextTreasureChest() {
+    fork.setupTreasureRoom();
+    fork.openTreasureRoomChest();
+    return fork.info.rewardsContainer;
+}
+
+RelicId RngOracle::nextRelic(RelicTier tier, bool shopRoom) {
+    return fork.returnRandomRelic(tier, shopRoom);
+}
+
+Potion RngOracle::nextPotionDrop() {
+    Rewards r;
+    fork.addPotionRewards(r);
+    return r.potionCount ? r.potions[0] : Potion::INVALID;
+}
+
+std::vector<CardReward> RngOracle::cardRewards(const GameContext &gc, Room room, int count) {
+    RngOracle oracle(gc);
+    std::vector<CardReward> ret;
+    for (int i = 0; i < count; ++i) {
+        ret.push_back(oracle.nextCardReward(room));
+    }
+    return ret;
+}
+
+std::vector<Shop> RngOracle::shops(const GameContext &gc, int count) {
+    RngOracle oracle(gc);
+    std::vector<Shop> ret;
+    for (int i = 0; i < count; ++i) {
+        ret.push_back(oracle.nextShop());
+    }
+    return ret;
+}
+
+std::vector<RelicId> RngOracle::relics(const GameContext &gc, RelicTier tier, int count) {
+    RngOracle oracle(gc);
+    std::vector<RelicId> ret;
+    for (int i = 0; i < count; ++i) {
+        ret.push_back(oracle.nextRelic(tier));
+    }
+    return ret;
+}
+
+std::vector<Potion> RngOracle::potionDrops(const GameContext &gc, int count) {
+    RngOracle oracle(gc);
+    std::vector<Potion> ret;
+    for (int i = 0; i < count; ++i) {
+        ret.push_back(oracle.nextPotionDrop());
+    }
+    return ret;
+}
@@ -3,8 +3,13 @@
 //
 
 #include <nlohmann/json.hpp>
+#include <array>
+#include <bitset>
 #include <iomanip>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
+#include <unordered_map>
 
 #include "sts_common.h"
 #include "game/SaveFile.h"
@@ -284,3 +289,875 @@ sts::SaveFile sts::SaveFile::loadFromPath(const std::string &path, sts::Characte
     return SaveFile(getJsonFromSaveFile(path), cc);
 }
 
+
+// ************************************************************
+
+namespace {
+
+    constexpr std::uint8_t INVALID_BASE64 = 0x80;
+
+    constexpr std::array<std::uint8_t, 256> makeBase64DecodeTable() {
+        std::array<std::uint8_t, 256> table {};
+        for (auto &x : table) {
+            x = INVALID_BASE64;
+        }
+        for (int i = 0; i < 64; ++i) {
+            table[static_cast<unsigned char>(Base64::chars[i])] = static_cast<std::uint8_t>(i);
+        }
+        return table;
+    }
+
+    constexpr auto base64DecodeTable = makeBase64DecodeTable();
+
+    constexpr std::uint8_t saveFileKey[] { 107, 101, 121 };
+
+    // decodes 4 character groups into 3 bytes xored with xorKey, which repeats every 3 bytes like the save file key.
+    // the output is sized for the whole input up front and written through a pointer, then trimmed
+    void decodeBase64Xor(const char *data, std::size_t size, std::string &out, const std::uint8_t *xorKey) {
+        const auto *in = reinterpret_cast<const unsigned char*>(data);
+        const auto outBegin = out.size();
+        out.resize(outBegin + size / 4 * 3 + 3);
+        auto *const dstBegin = reinterpret_cast<std::uint8_t*>(&out[outBegin]);
+        auto *dst = dstBegin;
+
+        std::size_t i = 0;
+        std::uint32_t bits = 0;
+        int charCount = 0;
+
+        while (i < size) {
+            for (; charCount == 0 && i + 4 <= size; i += 4) {
+                const auto a = base64DecodeTable[in[i]];
+                const auto b = base64DecodeTable[in[i+1]];
+                const auto c = base64DecodeTable[in[i+2]];
+                const auto d = base64DecodeTable[in[i+3]];
+                if ((a | b | c | d) & INVALID_BASE64) {
+                    break;
+                }
+                const std::uint32_t group = a << 18 | b << 12 | c << 6 | d;
+                dst[0] = static_cast<std::uint8_t>((group >> 16) ^ xorKey[0]);
+                dst[1] = static_cast<std::uint8_t>((group >> 8 & 0xFF) ^ xorKey[1]);
+                dst[2] = static_cast<std::uint8_t>((group & 0xFF) ^ xorKey[2]);
+                dst += 3;
+            }
+            if (i >= size) {
+                break;
+            }
+
+            // one character at a time for padding, whitespace and the tail
+            const auto ch = in[i++];
+            if (ch == '=') {
+                break;
+            }
+            const auto v = base64DecodeTable[ch];
+            if (v & INVALID_BASE64) {
+                continue;
+            }
+            bits = bits << 6 | v;
+            if (++charCount == 4) {
+                dst[0] = static_cast<std::uint8_t>((bits >> 16) ^ xorKey[0]);
+                dst[1] = static_cast<std::uint8_t>((bits >> 8 & 0xFF) ^ xorKey[1]);
+                dst[2] = static_cast<std::uint8_t>((bits & 0xFF) ^ xorKey[2]);
+                dst += 3;
+                bits = 0;
+                charCount = 0;
+            }
+        }
+
+        // a partial group, 2 characters hold 1 byte and 3 characters hold 2
+        if (charCount >= 2) {
+            *dst++ = static_cast<std::uint8_t>((bits >> (charCount*6 - 8) & 0xFF) ^ xorKey[0]);
+        }
+        if (charCount == 3) {
+            *dst++ = static_cast<std::uint8_t>((bits >> 2 & 0xFF) ^ xorKey[1]);
+        }
+        out.resize(outBegin + (dst - dstBegin));
+    }
+
+    // save string to enum, built from the NLOHMANN_JSON_SERIALIZE_ENUM mappings so the results are identical
+    template <typename E>
+    class SaveEnumLookup {
+        std::unordered_map<std::string, E> map;
+
+    public:
+        SaveEnumLookup() {
+            typedef std::underlying_type_t<E> U;
+            const int maxValue = std::min(2048, static_cast<int>(std::numeric_limits<U>::max()));
+            for (int i = 0; i <= maxValue; ++i) {
+                const nlohmann::json j = static_cast<E>(i);
+                if (j.is_string()) {
+                    map.emplace(j.get<std::string>(), E());
+                }
+            }
+            for (auto &pair : map) {
+                nlohmann::json(pair.first).get_to(pair.second);
+            }
+        }
+
+        E get(const std::string &s) const {
+            auto it = map.find(s);
+            if (it != map.end()) {
+                return it->second;
+            }
+            E ret;
+            nlohmann::json(s).get_to(ret);
+            return ret;
+        }
+
+        static const SaveEnumLookup& instance() {
+            static const SaveEnumLookup lookup;
+            return lookup;
+        }
+    };
+
+    template <typename E>
+    E saveEnumFromString(const std::string &s) {
+        return SaveEnumLookup<E>::instance().get(s);
+    }
+
+    template <typename E>
+    E saveEnumFromNull() {
+        E ret;
+        nlohmann::json(nullptr).get_to(ret);
+        return ret;
+    }
+
+    enum class SaveField : std::uint8_t {
+        NONE=0,
+        SEED,
+        ASCENSION_LEVEL,
+        ACT_NUM,
+        GOLD,
+        PURGE_COST,
+        CURRENT_HEALTH,
+        MAX_HEALTH,
+        PLAY_TIME,
+        ROOM_X,
+        ROOM_Y,
+        FLOOR_NUM,
+        POST_COMBAT,
+        SMOKED,
+        MUGGED,
+        CURRENT_ROOM,
+        POTION_SEED_COUNT,
+        RELIC_SEED_COUNT,
+        EVENT_SEED_COUNT,
+        MONSTER_SEED_COUNT,
+        MERCHANT_SEED_COUNT,
+        CARD_RANDOM_SEED_COUNT,
+        CARD_SEED_COUNT,
+        TREASURE_SEED_COUNT,
+        HAS_EMERALD_KEY,
+        HAS_RUBY_KEY,
+        HAS_SAPPHIRE_KEY,
+        CARD_RANDOM_SEED_RANDOMIZER,
+        POTION_CHANCE,
+        EVENT_CHANCES,
+        CHOSE_NEOW_REWARD,
+        NEOW_BONUS,
+        NEOW_COST,
+        POTIONS,
+        CARDS,
+        RELICS,
+        RELIC_COUNTERS,
+        BOSS_RELICS,
+        SHOP_RELICS,
+        COMMON_RELICS,
+        UNCOMMON_RELICS,
+        RARE_RELICS,
+        EVENT_LIST,
+        ONE_TIME_EVENT_LIST,
+        MONSTER_LIST,
+        ELITE_MONSTER_LIST,
+        BOSS_LIST,
+        // optional fields after this point
+        BOTTLED_FLAME,
+        BOTTLED_LIGHTNING,
+        BOTTLED_TORNADO,
+        COMBAT_REWARDS,
+        FIELD_COUNT,
+    };
+
+    constexpr int REQUIRED_FIELD_COUNT = static_cast<int>(SaveField::BOTTLED_FLAME);
+
+    constexpr const char* saveFieldNames[] = {
+        "",
+        "seed",
+        "ascension_level",
+        "act_num",
+        "gold",
+        "purgeCost",
+        "current_health",
+        "max_health",
+        "play_time",
+        "room_x",
+        "room_y",
+        "floor_num",
+        "post_combat",
+        "smoked",
+        "mugged",
+        "current_room",
+        "potion_seed_count",
+        "relic_seed_count",
+        "event_seed_count",
+        "monster_seed_count",
+        "merchant_seed_count",
+        "card_random_seed_count",
+        "card_seed_count",
+        "treasure_seed_count",
+        "has_emerald_key",
+        "has_ruby_key",
+        "has_sapphire_key",
+        "card_random_seed_randomizer",
+        "potion_chance",
+        "event_chances",
+        "chose_neow_reward",
+        "neow_bonus",
+        "neow_cost",
+        "potions",
+        "cards",
+        "relics",
+        "relic_counters",
+        "boss_relics",
+        "shop_relics",
+        "common_relics",
+        "uncommon_relics",
+        "rare_relics",
+        "event_list",
+        "one_time_event_list",
+        "monster_list",
+        "elite_monster_list",
+        "boss_list",
+        "bottled_flame",
+        "bottled_lightning",
+        "bottled_tornado",
+        "combat_rewards",
+    };
+
+    static_assert(std::size(saveFieldNames) == static_cast<int>(SaveField::FIELD_COUNT));
+
+    SaveField getSaveField(const std::string &key) {
+        static const auto fields = [] {
+            std::unordered_map<std::string, SaveField> ret;
+            for (int i = 1; i < static_cast<int>(SaveField::FIELD_COUNT); ++i) {
+                ret.emplace(saveFieldNames[i], static_cast<SaveField>(i));
+            }
+            return ret;
+        }();
+        auto it = fields.find(key);
+        return it == fields.end() ? SaveField::NONE : it->second;
+    }
+
+    // fills a SaveFile from sax events. values are only read at depth 1 (top level fields),
+    // depth 2 (elements of top level arrays) and depth 3 (fields of cards and combat rewards), everything else is skipped
+    class SaveFileSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+    public:
+        SaveFile &s;
+        std::bitset<static_cast<int>(SaveField::FIELD_COUNT)> seen;
+
+    private:
+        int depth = 0;
+        SaveField field = SaveField::NONE;
+        std::string itemKey;
+        int arrayIdx = 0;
+
+        float eventChances[4] {};
+
+        std::int64_t cardUpgrades = 0;
+        std::int64_t cardMisc = 0;
+        bool hasCardId = false;
+        bool hasCardUpgrades = false;
+        bool hasCardMisc = false;
+        Card card;
+
+        Save::CombatReward reward;
+        std::string rewardId;
+        bool hasRewardAmount = false;
+        bool hasRewardBonusGold = false;
+        bool hasRewardId = false;
+
+        static void fail(const std::string &msg) {
+            throw std::runtime_error("save file: " + msg);
+        }
+
+        void failType() const {
+            fail(std::string("unexpected value type for ") + saveFieldNames[static_cast<int>(field)]);
+        }
+
+        template <typename T>
+        void setInt(T &out, std::int64_t val) {
+            if (depth != 1) {
+                failType();
+            }
+            out = static_cast<T>(val);
+        }
+
+        void onInt(std::int64_t val);
+        void onFloat(double val);
+        void onBool(bool val);
+        void onString(const std::string &val);
+        void onNull();
+        void onCardValue(std::int64_t val);
+        void onRewardValue(std::int64_t val);
+        void endCard();
+        void endReward();
+
+    public:
+        explicit SaveFileSaxHandler(SaveFile &s) : s(s) {}
+
+        bool null() override { onNull(); return true; }
+        bool boolean(bool val) override { onBool(val); return true; }
+        bool number_integer(number_integer_t val) override { onInt(val); return true; }
+        bool number_unsigned(number_unsigned_t val) override { onInt(static_cast<std::int64_t>(val)); return true; }
+        bool number_float(number_float_t val, const string_t &str) override { onFloat(val); return true; }
+        bool string(string_t &val) override { onString(val); return true; }
+        bool binary(binary_t &val) override { return true; }
+
+        bool start_object(std::size_t elements) override {
+            ++depth;
+            if (depth == 3) {
+                if (field == SaveField::CARDS) {
+                    card = Card();
+                    hasCardId = hasCardUpgrades = hasCardMisc = false;
+                } else if (field == SaveField::COMBAT_REWARDS) {
+                    reward = Save::CombatReward();
+                    reward.type = Save::CombatRewardType::INVALID;
+                    hasRewardAmount = hasRewardBonusGold = hasRewardId = false;
+                }
+            }
+            return true;
+        }
+
+        bool key(string_t &val) override {
+            if (depth == 1) {
+                field = getSaveField(val);
+                if (seen.test(static_cast<int>(field)) && field != SaveField::NONE) {
+                    fail("duplicate field " + val);
+                }
+                seen.set(static_cast<int>(field));
+                arrayIdx = 0;
+            } else if (depth == 3) {
+                itemKey = val;
+            }
+            return true;
+        }
+
+        bool end_object() override {
+            if (depth == 3) {
+                if (field == SaveField::CARDS) {
+                    endCard();
+                } else if (field == SaveField::COMBAT_REWARDS) {
+                    endReward();
+                }
+            }
+            --depth;
+            return true;
+        }
+
+        bool start_array(std::size_t elements) override {
+            ++depth;
+            return true;
+        }
+
+        bool end_array() override {
+            --depth;
+            if (depth == 1 && field == SaveField::EVENT_CHANCES) {
+                s.monsterChance = eventChances[1];
+                s.shopChance = eventChances[2];
+                s.treasureChance = eventChances[3];
+            }
+            return true;
+        }
+
+        bool parse_error(std::size_t position, const std::string &lastToken, const nlohmann::detail::exception &ex) override {
+            fail(ex.what());
+            return false;
+        }
+
+        void checkRequiredFields() const {
+            for (int i = 1; i < REQUIRED_FIELD_COUNT; ++i) {
+                if (!seen.test(i)) {
+                    fail(std::string("missing field ") + saveFieldNames[i]);
+                }
+            }
+        }
+    };
+
+    void SaveFileSaxHandler::onInt(std::int64_t val) {
+        if (depth == 3) {
+            if (field == SaveField::CARDS) {
+                onCardValue(val);
+            } else if (field == SaveField::COMBAT_REWARDS) {
+                onRewardValue(val);
+            }
+            return;
+        }
+
+        switch (field) {
+            case SaveField::SEED:
+                if (depth != 1) {
+                    failType();
+                }
+                s.seed = static_cast<std::uint64_t>(val);
+                break;
+
+            case SaveField::ASCENSION_LEVEL: setInt(s.ascension_level, val); break;
+            case SaveField::ACT_NUM: setInt(s.act_num, val); break;
+            case SaveField::GOLD: setInt(s.gold, val); break;
+            case SaveField::PURGE_COST: setInt(s.purgeCost, val); break;
+            case SaveField::CURRENT_HEALTH: setInt(s.current_health, val); break;
+            case SaveField::MAX_HEALTH: setInt(s.max_health, val); break;
+            case SaveField::PLAY_TIME: setInt(s.play_time, val); break;
+            case SaveField::ROOM_X: setInt(s.room_x, val); break;
+            case SaveField::ROOM_Y: setInt(s.room_y, val); break;
+            case SaveField::FLOOR_NUM: setInt(s.floor_num, val); break;
+            case SaveField::POTION_SEED_COUNT: setInt(s.potion_seed_count, val); break;
+            case SaveField::RELIC_SEED_COUNT: setInt(s.relic_seed_count, val); break;
+            case SaveField::EVENT_SEED_COUNT: setInt(s.event_seed_count, val); break;
+            case SaveField::MONSTER_SEED_COUNT: setInt(s.monster_seed_count, val); break;
+            case SaveField::MERCHANT_SEED_COUNT: setInt(s.merchant_seed_count, val); break;
+            case SaveField::CARD_RANDOM_SEED_COUNT: setInt(s.card_random_seed_count, val); break;
+            case SaveField::CARD_SEED_COUNT: setInt(s.card_seed_count, val); break;
+            case SaveField::TREASURE_SEED_COUNT: setInt(s.treasure_seed_count, val); break;
+            case SaveField::CARD_RANDOM_SEED_RANDOMIZER: setInt(s.card_random_seed_randomizer, val); break;
+            case SaveField::POTION_CHANCE: setInt(s.potion_chance, val); break;
+
+            case SaveField::EVENT_CHANCES:
+                onFloat(static_cast<double>(val));
+                break;
+
+            case SaveField::RELIC_COUNTERS:
+                if (depth != 2) {
+                    failType();
+                }
+                s.relic_counters.push_back(static_cast<int>(val));
+                break;
+
+            case SaveField::NONE:
+                break;
+
+            default:
+                failType();
+        }
+    }
+
+    void SaveFileSaxHandler::onFloat(double val) {
+        if (depth == 3) {
+            onInt(static_cast<std::int64_t>(val));
+            return;
+        }
+
+        if (field == SaveField::EVENT_CHANCES) {
+            if (depth != 2) {
+                failType();
+            }
+            if (arrayIdx < 4) {
+                eventChances[arrayIdx] = static_cast<float>(val);
+            }
+            ++arrayIdx;
+
+        } else if (field != SaveField::NONE) {
+            onInt(static_cast<std::int64_t>(val));
+        }
+    }
+
+    void SaveFileSaxHandler::onBool(bool val) {
+        if (depth != 1) {
+            if (depth == 2 && field != SaveField::NONE) {
+                failType();
+            }
+            return;
+        }
+
+        switch (field) {
+            case SaveField::POST_COMBAT: s.post_combat = val; break;
+            case SaveField::SMOKED: s.smoked = val; break;
+            case SaveField::MUGGED: s.mugged = val; break;
+            case SaveField::HAS_EMERALD_KEY: s.has_emerald_key = val; break;
+            case SaveField::HAS_RUBY_KEY: s.has_ruby_key = val; break;
+            case SaveField::HAS_SAPPHIRE_KEY: s.has_sapphire_key = val; break;
+            case SaveField::CHOSE_NEOW_REWARD: s.chose_neow_reward = val; break;
+            case SaveField::NONE: break;
+            default: failType();
+        }
+    }
+
+    void SaveFileSaxHandler::onString(const std::string &val) {
+        if (depth == 3) {
+            if (field == SaveField::CARDS && itemKey == "id") {
+                card.id = saveEnumFromString<CardId>(val);
+                hasCardId = true;
+
+            } else if (field == SaveField::COMBAT_REWARDS) {
+                if (itemKey == "type") {
+                    reward.type = saveEnumFromString<Save::CombatRewardType>(val);
+                } else if (itemKey == "id") {
+                    rewardId = val;
+                    hasRewardId = true;
+                }
+            }
+            return;
+        }
+
+        if (depth == 1) {
+            switch (field) {
+                case SaveField::CURRENT_ROOM: s.current_room = saveEnumFromString<Save::RoomType>(val); return;
+                case SaveField::NEOW_BONUS: s.neow_bonus = saveEnumFromString<Neow::Bonus>(val); return;
+                case SaveField::NEOW_COST: s.neow_cost = saveEnumFromString<Neow::Drawback>(val); return;
+                case SaveField::BOTTLED_FLAME: s.bottledCards[0] = saveEnumFromString<CardId>(val); return;
+                case SaveField::BOTTLED_LIGHTNING: s.bottledCards[1] = saveEnumFromString<CardId>(val); return;
+                case SaveField::BOTTLED_TORNADO: s.bottledCards[2] = saveEnumFromString<CardId>(val); return;
+                case SaveField::NONE: return;
+                default: failType();
+            }
+        }
+
+        if (depth == 2) {
+            switch (field) {
+                case SaveField::POTIONS: s.potions.push_back(saveEnumFromString<Potion>(val)); return;
+                case SaveField::RELICS: s.relics.push_back(saveEnumFromString<RelicId>(val)); return;
+                case SaveField::BOSS_RELICS: s.boss_relics.push_back(saveEnumFromString<RelicId>(val)); return;
+                case SaveField::SHOP_RELICS: s.shop_relics.push_back(saveEnumFromString<RelicId>(val)); return;
+                case SaveField::COMMON_RELICS: s.common_relics.push_back(saveEnumFromString<RelicId>(val)); return;
+                case SaveField::UNCOMMON_RELICS: s.uncommon_relics.push_back(saveEnumFromString<RelicId>(val)); return;
+                case SaveField::RARE_RELICS: s.rare_relics.push_back(saveEnumFromString<RelicId>(val)); return;
+                case SaveField::EVENT_LIST: s.event_list.push_back(saveEnumFromString<Event>(val)); return;
+                case SaveField::ONE_TIME_EVENT_LIST: s.one_time_event_list.push_back(saveEnumFromString<Event>(val)); return;
+                case SaveField::MONSTER_LIST: s.monster_list.push_back(saveEnumFromString<MonsterEncounter>(val)); return;
+                case SaveField::ELITE_MONSTER_LIST: s.elite_monster_list.push_back(saveEnumFromString<MonsterEncounter>(val)); return;
+                case SaveField::BOSS_LIST: s.boss_list.push_back(saveEnumFromString<MonsterEncounter>(val)); return;
+                case SaveField::NONE: return;
+                default: failType();
+            }
+        }
+    }
+
+    void SaveFileSaxHandler::onNull() {
+        if (depth == 1) {
+            switch (field) {
+                case SaveField::CURRENT_ROOM: s.current_room = saveEnumFromNull<Save::RoomType>(); return;
+                case SaveField::NEOW_BONUS: s.neow_bonus = saveEnumFromNull<Neow::Bonus>(); return;
+                case SaveField::NEOW_COST: s.neow_cost = saveEnumFromNull<Neow::Drawback>(); return;
+                case SaveField::BOTTLED_FLAME: s.bottledCards[0] = saveEnumFromNull<CardId>(); return;
+                case SaveField::BOTTLED_LIGHTNING: s.bottledCards[1] = saveEnumFromNull<CardId>(); return;
+                case SaveField::BOTTLED_TORNADO: s.bottledCards[2] = saveEnumFromNull<CardId>(); return;
+                case SaveField::NONE: return;
+                default: failType();
+            }
+        }
+
+        if (depth == 2) {
+            switch (field) {
+                case SaveField::POTIONS: s.potions.push_back(saveEnumFromNull<Potion>()); return;
+                case SaveField::RELICS: s.relics.push_back(saveEnumFromNull<RelicId>()); return;
+                case SaveField::BOSS_RELICS: s.boss_relics.push_back(saveEnumFromNull<RelicId>()); return;
+                case SaveField::SHOP_RELICS: s.shop_relics.push_back(saveEnumFromNull<RelicId>()); return;
+                case SaveField::COMMON_RELICS: s.common_relics.push_back(saveEnumFromNull<RelicId>()); return;
+                case SaveField::UNCOMMON_RELICS: s.uncommon_relics.push_back(saveEnumFromNull<RelicId>()); return;
+                case SaveField::RARE_RELICS: s.rare_relics.push_back(saveEnumFromNull<RelicId>()); return;
+                case SaveField::EVENT_LIST: s.event_list.push_back(saveEnumFromNull<Event>()); return;
+                case SaveField::ONE_TIME_EVENT_LIST: s.one_time_event_list.push_back(saveEnumFromNull<Event>()); return;
+                case SaveField::MONSTER_LIST: s.monster_list.push_back(saveEnumFromNull<MonsterEncounter>()); return;
+                case SaveField::ELITE_MONSTER_LIST: s.elite_monster_list.push_back(saveEnumFromNull<MonsterEncounter>()); return;
+                case SaveField::BOSS_LIST: s.boss_list.push_back(saveEnumFromNull<MonsterEncounter>()); return;
+                default: return;
+            }
+        }
+    }
+
+    void SaveFileSaxHandler::onCardValue(std::int64_t val) {
+        if (itemKey == "upgrades") {
+            cardUpgrades = val;
+            hasCardUpgrades = true;
+        } else if (itemKey == "misc") {
+            cardMisc = val;
+            hasCardMisc = true;
+        }
+    }
+
+    void SaveFileSaxHandler::onRewardValue(std::int64_t val) {
+        if (itemKey == "amount") {
+            reward.amount = static_cast<int>(val);
+            hasRewardAmount = true;
+        } else if (itemKey == "bonusGold") {
+            reward.bonusGold = static_cast<int>(val);
+            hasRewardBonusGold = true;
+        }
+    }
+
+    void SaveFileSaxHandler::endCard() {
+        if (!hasCardId || !hasCardUpgrades) {
+            fail("card is missing id or upgrades");
+        }
+
+        if (card.id == CardId::SEARING_BLOW) {
+            card.misc = static_cast<std::int16_t>(cardUpgrades);
+            card.upgraded = card.misc;
+        } else {
+            if (!hasCardMisc) {
+                fail("card is missing misc");
+            }
+            card.misc = static_cast<std::int16_t>(cardMisc);
+            card.upgraded = cardUpgrades > 0;
+        }
+        s.cards.push_back(card);
+    }
+
+    void SaveFileSaxHandler::endReward() {
+        switch (reward.type) {
+            case Save::CombatRewardType::STOLEN_GOLD:
+            case Save::CombatRewardType::GOLD:
+                if (!hasRewardAmount || !hasRewardBonusGold) {
+                    fail("gold reward is missing amount or bonusGold");
+                }
+                break;
+
+            case Save::CombatRewardType::CARD:
+            case Save::CombatRewardType::POTION:
+            case Save::CombatRewardType::RELIC:
+                if (!hasRewardId) {
+                    fail("reward is missing id");
+                }
+                if (reward.type == Save::CombatRewardType::CARD) {
+                    reward.cardId = saveEnumFromString<CardId>(rewardId);
+                } else if (reward.type == Save::CombatRewardType::POTION) {
+                    reward.potionId = saveEnumFromString<Potion>(rewardId);
+                } else {
+                    reward.relicId = saveEnumFromString<RelicId>(rewardId);
+                }
+                reward.amount = -1;
+                reward.bonusGold = -1;
+                break;
+
+            default:
+                reward.amount = -1;
+                reward.bonusGold = -1;
+                break;
+        }
+        s.combat_rewards.push_back(reward);
+    }
+
+    template <typename T>
+    void writePod(std::ostream &os, const T &t) {
+        os.write(reinterpret_cast<const char*>(&t), sizeof(T));
+    }
+
+    // no list in a save file comes near this, a larger size means a corrupt snapshot
+    constexpr std::uint32_t MAX_SNAPSHOT_LIST_SIZE = 1 << 16;
+
+    template <typename T>
+    void readPod(std::istream &is, T &t) {
+        if (!is.read(reinterpret_cast<char*>(&t), sizeof(T))) {
+            throw std::runtime_error("save file snapshot: unexpected end of stream");
+        }
+    }
+
+    std::uint32_t readListSize(std::istream &is) {
+        std::uint32_t size = 0;
+        readPod(is, size);
+        if (size > MAX_SNAPSHOT_LIST_SIZE) {
+            throw std::runtime_error("save file snapshot: list of " + std::to_string(size) + " elements");
+        }
+        return size;
+    }
+
+    template <typename T>
+    void writeVector(std::ostream &os, const std::vector<T> &vec) {
+        writePod(os, static_cast<std::uint32_t>(vec.size()));
+        os.write(reinterpret_cast<const char*>(vec.data()), static_cast<std::streamsize>(vec.size() * sizeof(T)));
+    }
+
+    template <typename T>
+    void readVector(std::istream &is, std::vector<T> &vec) {
+        vec.resize(readListSize(is));
+        if (!is.read(reinterpret_cast<char*>(vec.data()), static_cast<std::streamsize>(vec.size() * sizeof(T)))) {
+            throw std::runtime_error("save file snapshot: unexpected end of stream");
+        }
+    }
+
+    // cards and rewards are written field by field so struct padding is never written
+
+    void writeCards(std::ostream &os, const std::vector<Card> &cards) {
+        writePod(os, static_cast<std::uint32_t>(cards.size()));
+        for (const auto &c : cards) {
+            writePod(os, c.id);
+            writePod(os, c.misc);
+            writePod(os, c.upgraded);
+        }
+    }
+
+    void readCards(std::istream &is, std::vector<Card> &cards) {
+        cards.resize(readListSize(is));
+        for (auto &c : cards) {
+            readPod(is, c.id);
+            readPod(is, c.misc);
+            readPod(is, c.upgraded);
+        }
+    }
+
+    void writeCombatRewards(std::ostream &os, const std::vector<Save::CombatReward> &rewards) {
+        writePod(os, static_cast<std::uint32_t>(rewards.size()));
+        for (const auto &r : rewards) {
+            writePod(os, r.type);
+            writePod(os, r.amount);
+            writePod(os, r.bonusGold);
+            writePod(os, r.cardId);
+            writePod(os, r.potionId);
+            writePod(os, r.relicId);
+        }
+    }
+
+    void readCombatRewards(std::istream &is, std::vector<Save::CombatReward> &rewards) {
+        rewards.resize(readListSize(is));
+        for (auto &r : rewards) {
+            readPod(is, r.type);
+            readPod(is, r.amount);
+            readPod(is, r.bonusGold);
+            readPod(is, r.cardId);
+            readPod(is, r.potionId);
+            readPod(is, r.relicId);
+        }
+    }
+
+    constexpr std::uint32_t SNAPSHOT_MAGIC = 0x53545331; // STS1
+
+}
+
+void Base64::decodeFast(const char *data, std::size_t size, std::string &out) {
+    static constexpr std::uint8_t noKey[] {0, 0, 0};
+    decodeBase64Xor(data, size, out, noKey);
+}
+
+std::string SaveFile::decodeSaveFileContents(const std::string &contents) {
+    std::string json;
+    decodeBase64Xor(contents.data(), contents.size(), json, saveFileKey);
+    return json;
+}
+
+SaveFile SaveFile::fromJsonStream(std::string json, CharacterClass cc) {
+    SaveFile s;
+    s.cc = cc;
+    s.bottledCards = { CardId::INVALID, CardId::INVALID, CardId::INVALID };
+
+    SaveFileSaxHandler handler(s);
+    nlohmann::json::sax_parse(json, &handler);
+    handler.checkRequiredFields();
+
+    s.json = std::move(json);
+    return s;
+}
+
+SaveFile SaveFile::loadFromPathFast(const std::string &path, CharacterClass cc) {
+    return fromJsonStream(decodeSaveFileContents(readFileToStringHelper(path)), cc);
+}
+
+void SaveFile::writeSnapshot(std::ostream &os) const {
+    writePod(os, SNAPSHOT_MAGIC);
+
+    writePod(os, seed);
+    writePod(os, cc);
+    for (int x : {ascension_level, act_num, gold, purgeCost, current_health, max_health,
+                  play_time, room_x, room_y, floor_num}) {
+        writePod(os, x);
+    }
+    for (bool b : {post_combat, smoked, mugged}) {
+        writePod(os, b);
+    }
+    writePod(os, current_room);
+
+    for (int x : {potion_seed_count, relic_seed_count, event_seed_count, monster_seed_count,
+                  merchant_seed_count, card_random_seed_count, card_seed_count, treasure_seed_count}) {
+        writePod(os, x);
+    }
+    for (bool b : {has_emerald_key, has_ruby_key, has_sapphire_key}) {
+        writePod(os, b);
+    }
+
+    writePod(os, card_random_seed_randomizer);
+    writePod(os, potion_chance);
+    writePod(os, monsterChance);
+    writePod(os, shopChance);
+    writePod(os, treasureChance);
+
+    writePod(os, chose_neow_reward);
+    writePod(os, neow_bonus);
+    writePod(os, neow_cost);
+
+    writeVector(os, potions);
+    writeCards(os, cards);
+    writePod(os, bottledCards);
+
+    writeVector(os, relics);
+    writeVector(os, relic_counters);
+    writeCombatRewards(os, combat_rewards);
+
+    writeVector(os, boss_relics);
+    writeVector(os, shop_relics);
+    writeVector(os, common_relics);
+    writeVector(os, uncommon_relics);
+    writeVector(os, rare_relics);
+
+    writeVector(os, one_time_event_list);
+    writeVector(os, event_list);
+    writeVector(os, monster_list);
+    writeVector(os, elite_monster_list);
+    writeVector(os, boss_list);
+}
+
+SaveFile SaveFile::readSnapshot(std::istream &is) {
+    std::uint32_t magic = 0;
+    readPod(is, magic);
+    if (magic != SNAPSHOT_MAGIC) {
+        throw std::runtime_error("save file snapshot: bad magic");
+    }
+
+    SaveFile s;
+    readPod(is, s.seed);
+    readPod(is, s.cc);
+    for (int *x : {&s.ascension_level, &s.act_num, &s.gold, &s.purgeCost, &s.current_health, &s.max_health,
+                   &s.play_time, &s.room_x, &s.room_y, &s.floor_num}) {
+        readPod(is, *x);
+    }
+    for (bool *b : {&s.post_combat, &s.smoked, &s.mugged}) {
+        readPod(is, *b);
+    }
+    readPod(is, s.current_room);
+
+    for (int *x : {&s.potion_seed_count, &s.relic_seed_count, &s.event_seed_count, &s.monster_seed_count,
+                   &s.merchant_seed_count, &s.card_random_seed_count, &s.card_seed_count, &s.treasure_seed_count}) {
+        readPod(is, *x);
+    }
+    for (bool *b : {&s.has_emerald_key, &s.has_ruby_key, &s.has_sapphire_key}) {
+        readPod(is, *b);
+    }
+
+    readPod(is, s.card_random_seed_randomizer);
+    readPod(is, s.potion_chance);
+    readPod(is, s.monsterChance);
+    readPod(is, s.shopChance);
+    readPod(is, s.treasureChance);
+
+    readPod(is, s.chose_neow_reward);
+    readPod(is, s.neow_bonus);
+    readPod(is, s.neow_cost);
+
+    readVector(is, s.potions);
+    readCards(is, s.cards);
+    readPod(is, s.bottledCards);
+
+    readVector(is, s.relics);
+    readVector(is, s.relic_counters);
+    readCombatRewards(is, s.combat_rewards);
+
+    readVector(is, s.boss_relics);
+    readVector(is, s.shop_relics);
+    readVector(is, s.common_relics);
+    readVector(is, s.uncommon_relics);
+    readVector(is, s.rare_relics);
+
+    readVector(is, s.one_time_event_list);
+    readVector(is, s.event_list);
+    readVector(is, s.monster_list);
+    readVector(is, s.elite_monster_list);
+    readVector(is, s.boss_list);
+    return s;
+}
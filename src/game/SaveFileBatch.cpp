@@ -0,0 +1,121 @@
+#include "game/SaveFileBatch.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace sts;
+
+namespace {
+
+    struct SaveFileBatchInfo {
+        const std::vector<std::string> *paths;
+        CharacterClass defaultCc;
+        const SaveFileBatch::ResultFnc *fn;
+
+        std::mutex m;
+        std::size_t curIdx = 0;
+    };
+
+    void saveFileBatchRunner(SaveFileBatchInfo *info) {
+        while (true) {
+            std::size_t idx;
+            {
+                std::scoped_lock lock(info->m);
+                idx = info->curIdx++;
+            }
+            if (idx >= info->paths->size()) {
+                break;
+            }
+
+            SaveFileBatchResult result;
+            result.path = (*info->paths)[idx];
+            try {
+                const auto cc = SaveFileBatch::getCharacterClassFromPath(result.path, info->defaultCc);
+                result.save = SaveFile::loadFromPathFast(result.path, cc);
+                result.ok = true;
+
+            } catch (const std::exception &e) {
+                result.error = e.what();
+            }
+            (*info->fn)(idx, result);
+        }
+    }
+
+}
+
+std::vector<std::string> SaveFileBatch::listSaveFiles(const std::string &dirPath) {
+    std::vector<std::string> ret;
+    for (const auto &entry : std::filesystem::directory_iterator(dirPath)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".autosave") {
+            ret.push_back(entry.path().string());
+        }
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+CharacterClass SaveFileBatch::getCharacterClassFromPath(const std::string &path, CharacterClass defaultCc) {
+    const auto name = std::filesystem::path(path).filename().string();
+    const auto startsWith = [&](const char *prefix) { return name.rfind(prefix, 0) == 0; };
+
+    if (startsWith("IRONCLAD")) {
+        return CharacterClass::IRONCLAD;
+    } else if (startsWith("THE_SILENT")) {
+        return CharacterClass::SILENT;
+    } else if (startsWith("DEFECT")) {
+        return CharacterClass::DEFECT;
+    } else if (startsWith("WATCHER")) {
+        return CharacterClass::WATCHER;
+    }
+    return defaultCc;
+}
+
+void SaveFileBatch::forEach(const std::vector<std::string> &paths, int threadCount, CharacterClass defaultCc, const ResultFnc &fn) {
+    SaveFileBatchInfo info;
+    info.paths = &paths;
+    info.defaultCc = defaultCc;
+    info.fn = &fn;
+
+    if (threadCount <= 1) {
+        saveFileBatchRunner(&info);
+        return;
+    }
+
+    std::vector<std::unique_ptr<std::thread>> threads;
+    for (int tid = 0; tid < threadCount; ++tid) {
+        threads.emplace_back(new std::thread(saveFileBatchRunner, &info));
+    }
+    for (auto &t : threads) {
+        t->join();
+    }
+}
+
+std::vector<SaveFileBatchResult> SaveFileBatch::load(const std::vector<std::string> &paths, int threadCount, CharacterClass defaultCc) {
+    std::vector<SaveFileBatchResult> results(paths.size());
+    forEach(paths, threadCount, defaultCc, [&](std::size_t pathIdx, SaveFileBatchResult &result) {
+        results[pathIdx] = std::move(result); // every path index is handed to exactly one worker
+    });
+    return results;
+}
+
+void SaveFileBatch::writeSnapshots(const std::string &outPath, const std::vector<SaveFileBatchResult> &results) {
+    std::ofstream os(outPath, std::ios::binary);
+    for (const auto &r : results) {
+        if (r.ok) {
+            r.save.writeSnapshot(os);
+        }
+    }
+}
+
+std::vector<SaveFile> SaveFileBatch::readSnapshots(const std::string &path) {
+    std::vector<SaveFile> ret;
+    std::ifstream is(path, std::ios::binary);
+    while (is.peek() != std::ifstream::traits_type::eof()) {
+        ret.push_back(SaveFile::readSnapshot(is));
+    }
+    return ret;
+}
@@ -0,0 +1,385 @@
+#include "game/SeedTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "game/GameContext.h"
+#include "game/Map.h"
+#include "game/MapPathPlanner.h"
+#include "game/Neow.h"
+
+using namespace sts;
+
+namespace {
+
+    constexpr char SEED_TABLE_MAGIC[8] = {'S','T','S','S','E','E','D','S'};
+    constexpr std::uint32_t SEED_TABLE_VERSION = 1;
+    constexpr std::uint64_t FILTER_BLOCK_SIZE = 4096;
+
+    struct SeedColumnGroup {
+        int firstColumn;
+        int columnCount;
+        const char *name;
+    };
+
+    constexpr SeedColumnGroup seedColumnGroups[] = {
+            {NEOW_BONUS, 4, "NEOW_BONUS"},
+            {NEOW_DRAWBACK, 4, "NEOW_DRAWBACK"},
+            {BOSS, 1, "BOSS"},
+            {MONSTERS, 16, "MONSTERS"},
+            {ELITES, 10, "ELITES"},
+            {MAP_ROOMS, 6, "MAP_ROOMS"},
+            {BURNING_ELITE_X, 1, "BURNING_ELITE_X"},
+            {BURNING_ELITE_Y, 1, "BURNING_ELITE_Y"},
+            {BURNING_ELITE_BUFF, 1, "BURNING_ELITE_BUFF"},
+            {PATH_MAX_ELITES, 1, "PATH_MAX_ELITES"},
+            {PATH_MIN_ELITES, 1, "PATH_MIN_ELITES"},
+            {PATH_MAX_RESTS, 1, "PATH_MAX_RESTS"},
+            {PATH_MAX_SHOPS, 1, "PATH_MAX_SHOPS"},
+    };
+
+    template<typename T>
+    void putField(std::uint8_t *header, int &offset, T value) {
+        std::memcpy(header + offset, &value, sizeof(T));
+        offset += sizeof(T);
+    }
+
+    template<typename T>
+    T getField(const std::uint8_t *header, int &offset) {
+        T value;
+        std::memcpy(&value, header + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    // sets match[i] for rows [begin, begin+n) of the table
+    void matchBlock(const SeedTable &table, const SeedFilter &f, std::uint64_t begin, int n, std::uint8_t *match) {
+        std::uint8_t any[FILTER_BLOCK_SIZE];
+        std::fill(match, match+n, 1);
+
+        for (const auto &t : f.getTerms()) {
+            if (t.columnCount == 1) {
+                const auto *col = table.getColumn(t.firstColumn) + begin;
+                for (int i = 0; i < n; ++i) {
+                    match[i] &= t.values[col[i]];
+                }
+                continue;
+            }
+
+            std::fill(any, any+n, 0);
+            for (int c = 0; c < t.columnCount; ++c) {
+                const auto *col = table.getColumn(t.firstColumn + c) + begin;
+                for (int i = 0; i < n; ++i) {
+                    any[i] |= t.values[col[i]];
+                }
+            }
+            for (int i = 0; i < n; ++i) {
+                match[i] &= any[i];
+            }
+        }
+    }
+
+    // calls fn(threadIdx, begin, end) on contiguous ranges of rows that start on filter block boundaries
+    template<typename Fn>
+    void forEachRange(std::uint64_t rowCount, int threadCount, Fn fn) {
+        const std::uint64_t blockCount = (rowCount + FILTER_BLOCK_SIZE-1) / FILTER_BLOCK_SIZE;
+        const std::uint64_t blocksPerThread = (blockCount + threadCount-1) / std::max(threadCount, 1);
+        const auto getRange = [&](int tid) {
+            const auto begin = std::min(rowCount, tid * blocksPerThread * FILTER_BLOCK_SIZE);
+            const auto end = std::min(rowCount, (tid+1) * blocksPerThread * FILTER_BLOCK_SIZE);
+            return std::make_pair(begin, end);
+        };
+
+        if (threadCount <= 1) {
+            fn(0, 0, rowCount);
+            return;
+        }
+
+        std::vector<std::unique_ptr<std::thread>> threads;
+        for (int tid = 0; tid < threadCount; ++tid) {
+            const auto range = getRange(tid);
+            threads.emplace_back(new std::thread(fn, tid, range.first, range.second));
+        }
+        for (auto &t : threads) {
+            t->join();
+        }
+    }
+
+}
+
+std::string sts::getSeedColumnName(int column) {
+    for (const auto &g : seedColumnGroups) {
+        if (column >= g.firstColumn && column < g.firstColumn + g.columnCount) {
+            return g.columnCount == 1 ? g.name : std::string(g.name) + "_" + std::to_string(column - g.firstColumn);
+        }
+    }
+    return "INVALID";
+}
+
+int sts::getSeedColumnForName(const std::string &name) {
+    for (int c = 0; c < SEED_COLUMN_COUNT; ++c) {
+        if (getSeedColumnName(c) == name) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+SeedRow sts::computeSeedRow(std::uint64_t seed, int ascension) {
+    SeedRow row {};
+
+    Random neowRng(seed);
+    const auto options = Neow::getOptions(neowRng);
+    for (int i = 0; i < 4; ++i) {
+        row[NEOW_BONUS+i] = static_cast<std::uint8_t>(options[i].r);
+        row[NEOW_DRAWBACK+i] = static_cast<std::uint8_t>(options[i].d);
+    }
+
+    // the monster lists only depend on monsterRng, as they are generated first in the GameContext constructor
+    GameContext gc;
+    gc.monsterRng = Random(seed);
+    gc.ascension = ascension;
+    gc.generateMonsters();
+
+    row[BOSS] = static_cast<std::uint8_t>(gc.boss);
+    for (int i = 0; i < 16 && i < gc.monsterList.size(); ++i) {
+        row[MONSTERS+i] = static_cast<std::uint8_t>(gc.monsterList[i]);
+    }
+    for (int i = 0; i < 10 && i < gc.eliteMonsterList.size(); ++i) {
+        row[ELITES+i] = static_cast<std::uint8_t>(gc.eliteMonsterList[i]);
+    }
+
+    const auto map = Map::fromSeed(seed, ascension, 1, true);
+    for (int y = 0; y < 15; ++y) {
+        for (int x = 0; x < 7; ++x) {
+            const auto room = static_cast<int>(map.getNode(x, y).room);
+            if (room <= static_cast<int>(Room::TREASURE)) {
+                ++row[MAP_ROOMS+room];
+            }
+        }
+    }
+    row[BURNING_ELITE_X] = static_cast<std::uint8_t>(map.burningEliteX);
+    row[BURNING_ELITE_Y] = static_cast<std::uint8_t>(map.burningEliteY);
+    row[BURNING_ELITE_BUFF] = static_cast<std::uint8_t>(map.burningEliteBuff);
+
+    // the planner keeps one path per distinct combination of counts, so extremes are a scan of its paths
+    const MapPathPlanner planner(map);
+    row[PATH_MIN_ELITES] = 255;
+    for (const auto &path : planner.getPaths()) {
+        const auto elites = static_cast<std::uint8_t>(path.getCount(PathObjective::ELITE));
+        row[PATH_MAX_ELITES] = std::max(row[PATH_MAX_ELITES], elites);
+        row[PATH_MIN_ELITES] = std::min(row[PATH_MIN_ELITES], elites);
+        row[PATH_MAX_RESTS] = std::max(row[PATH_MAX_RESTS], static_cast<std::uint8_t>(path.getCount(PathObjective::REST)));
+        row[PATH_MAX_SHOPS] = std::max(row[PATH_MAX_SHOPS], static_cast<std::uint8_t>(path.getCount(PathObjective::SHOP)));
+    }
+
+    return row;
+}
+
+SeedFilter& SeedFilter::where(int column, std::initializer_list<int> values) {
+    return whereAny(column, 1, values);
+}
+
+SeedFilter& SeedFilter::whereRange(int column, int lo, int hi) {
+    Term t {column, 1};
+    for (int v = std::max(lo, 0); v <= std::min(hi, 255); ++v) {
+        t.values[v] = true;
+    }
+    return addTerm(t);
+}
+
+SeedFilter& SeedFilter::whereAny(int firstColumn, int columnCount, std::initializer_list<int> values) {
+    Term t {firstColumn, columnCount};
+    for (auto v : values) {
+        t.values[static_cast<std::uint8_t>(v)] = true;
+    }
+    return addTerm(t);
+}
+
+SeedFilter& SeedFilter::addTerm(const Term &t) {
+    terms.push_back(t);
+    return *this;
+}
+
+void SeedTable::open(const std::string &path) {
+    close();
+
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("could not open " + path);
+    }
+    struct stat st {};
+    ::fstat(fd, &st);
+    size = st.st_size;
+    void *mapping = size ? ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        size = 0;
+        throw std::runtime_error("could not map " + path);
+    }
+    data = static_cast<const std::uint8_t*>(mapping);
+#else
+    std::ifstream is(path, std::ios::binary);
+    buffer.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+#endif
+
+    if (data == nullptr || size < HEADER_SIZE
+        || std::memcmp(data, SEED_TABLE_MAGIC, sizeof(SEED_TABLE_MAGIC)) != 0) {
+        close();
+        throw std::runtime_error(path + " is not a seed table");
+    }
+
+    int offset = sizeof(SEED_TABLE_MAGIC);
+    const auto version = getField<std::uint32_t>(data, offset);
+    ascension = static_cast<int>(getField<std::uint32_t>(data, offset));
+    startSeed = getField<std::uint64_t>(data, offset);
+    rowCount = getField<std::uint64_t>(data, offset);
+    const auto columnCount = getField<std::uint32_t>(data, offset);
+
+    // compared by division so a corrupt rowCount can't overflow the size it implies
+    if (version != SEED_TABLE_VERSION || columnCount != SEED_COLUMN_COUNT ||
+        rowCount > (size - HEADER_SIZE) / SEED_COLUMN_COUNT) {
+        close();
+        throw std::runtime_error(path + " is not a seed table of this version");
+    }
+}
+
+void SeedTable::close() {
+#ifndef _WIN32
+    if (data != nullptr) {
+        ::munmap(const_cast<std::uint8_t*>(data), size);
+    }
+#endif
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+    rowCount = 0;
+}
+
+SeedRow SeedTable::getRow(std::uint64_t row) const {
+    SeedRow ret;
+    for (int c = 0; c < SEED_COLUMN_COUNT; ++c) {
+        ret[c] = get(row, c);
+    }
+    return ret;
+}
+
+std::uint64_t SeedTable::count(const SeedFilter &f, int threadCount) const {
+    std::vector<std::uint64_t> counts(std::max(threadCount, 1));
+
+    forEachRange(rowCount, threadCount, [&](int tid, std::uint64_t begin, std::uint64_t end) {
+        std::uint8_t match[FILTER_BLOCK_SIZE];
+        std::uint64_t sum = 0;
+        for (auto b = begin; b < end; b += FILTER_BLOCK_SIZE) {
+            const int n = static_cast<int>(std::min(FILTER_BLOCK_SIZE, end - b));
+            matchBlock(*this, f, b, n, match);
+            for (int i = 0; i < n; ++i) {
+                sum += match[i];
+            }
+        }
+        counts[tid] = sum;
+    });
+
+    std::uint64_t ret = 0;
+    for (auto c : counts) {
+        ret += c;
+    }
+    return ret;
+}
+
+std::vector<std::uint64_t> SeedTable::select(const SeedFilter &f, std::size_t limit, int threadCount) const {
+    std::vector<std::vector<std::uint64_t>> seeds(std::max(threadCount, 1));
+
+    forEachRange(rowCount, threadCount, [&](int tid, std::uint64_t begin, std::uint64_t end) {
+        std::uint8_t match[FILTER_BLOCK_SIZE];
+        auto &out = seeds[tid];
+        for (auto b = begin; b < end && out.size() < limit; b += FILTER_BLOCK_SIZE) {
+            const int n = static_cast<int>(std::min(FILTER_BLOCK_SIZE, end - b));
+            matchBlock(*this, f, b, n, match);
+            for (int i = 0; i < n && out.size() < limit; ++i) {
+                if (match[i]) {
+                    out.push_back(startSeed + b + i);
+                }
+            }
+        }
+    });
+
+    std::vector<std::uint64_t> ret;
+    for (const auto &s : seeds) {
+        ret.insert(ret.end(), s.begin(), s.begin() + std::min(s.size(), limit - ret.size()));
+    }
+    return ret;
+}
+
+void SeedTable::write(const std::string &path, std::uint64_t startSeed, std::uint64_t seedCount, int ascension,
+                      int threadCount, std::uint64_t chunkSize) {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    if (!os) {
+        throw std::runtime_error("could not open " + path);
+    }
+
+    std::uint8_t header[HEADER_SIZE] {};
+    std::memcpy(header, SEED_TABLE_MAGIC, sizeof(SEED_TABLE_MAGIC));
+    int offset = sizeof(SEED_TABLE_MAGIC);
+    putField<std::uint32_t>(header, offset, SEED_TABLE_VERSION);
+    putField<std::uint32_t>(header, offset, ascension);
+    putField<std::uint64_t>(header, offset, startSeed);
+    putField<std::uint64_t>(header, offset, seedCount);
+    putField<std::uint32_t>(header, offset, SEED_COLUMN_COUNT);
+    os.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+
+    // rows of a chunk are computed in parallel and stored column by column, then each column slice is written in place
+    std::vector<std::uint8_t> chunk(SEED_COLUMN_COUNT * std::min(chunkSize, seedCount));
+
+    for (std::uint64_t chunkBegin = 0; chunkBegin < seedCount; chunkBegin += chunkSize) {
+        const auto n = std::min(chunkSize, seedCount - chunkBegin);
+
+        const auto computeRange = [&](std::uint64_t begin, std::uint64_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const auto row = computeSeedRow(startSeed + chunkBegin + i, ascension);
+                for (int c = 0; c < SEED_COLUMN_COUNT; ++c) {
+                    chunk[c*n + i] = row[c];
+                }
+            }
+        };
+
+        if (threadCount <= 1) {
+            computeRange(0, n);
+        } else {
+            std::vector<std::unique_ptr<std::thread>> threads;
+            for (int tid = 0; tid < threadCount; ++tid) {
+                threads.emplace_back(new std::thread(computeRange, n * tid / threadCount, n * (tid+1) / threadCount));
+            }
+            for (auto &t : threads) {
+                t->join();
+            }
+        }
+
+        for (int c = 0; c < SEED_COLUMN_COUNT; ++c) {
+            os.seekp(static_cast<std::streamoff>(HEADER_SIZE + c * seedCount + chunkBegin));
+            os.write(reinterpret_cast<const char*>(chunk.data() + c*n), static_cast<std::streamsize>(n));
+        }
+        if (!os) {
+            throw std::runtime_error("could not write " + path);
+        }
+    }
+
+    os.close(); // a full disk may only show up when the last buffer is flushed
+    if (!os) {
+        throw std::runtime_error("could not write " + path);
+    }
+}
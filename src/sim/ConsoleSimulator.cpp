@@ -50,6 +50,7 @@ void ConsoleSimulator::setupGameFromSaveFile(const SaveFile &save) {
 
 void ConsoleSimulator::reset() {
     delete gc;
+    gc = nullptr;
 }
 
 void ConsoleSimulator::play(std::istream &is, std::ostream &os, SimulatorContext &c) {
@@ -0,0 +1,398 @@
+#include "sim/ProtocolServer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "game/Game.h"
+#include "sim/search/Action.h"
+#include "sim/search/GameAction.h"
+#include "sim/search/BattleScumSearcher2.h"
+
+using namespace sts;
+using nlohmann::json;
+
+CharacterClass getCharacterClassFromString(const std::string &s); // ConsoleSimulator.cpp
+
+namespace {
+
+    std::string getGameKey(const json &request) {
+        const auto &game = request.at("game");
+        return game.is_string() ? game.get<std::string>() : game.dump();
+    }
+
+    std::uint64_t getSeed(const json &seed) {
+        return seed.is_string() ? SeedHelper::getLong(seed.get<std::string>()) : seed.get<std::uint64_t>();
+    }
+
+    // enters and exits battles until the game is at a decision point or over
+    void advance(ProtocolGame &game) {
+        while (true) {
+            if (game.bc) {
+                if (game.bc->outcome == Outcome::UNDECIDED) {
+                    return;
+                }
+                game.bc->exitBattle(game.gc);
+                game.bc.reset();
+            }
+
+            if (game.gc.outcome != GameOutcome::UNDECIDED || game.gc.screenState != ScreenState::BATTLE) {
+                return;
+            }
+            game.bc = std::make_unique<BattleContext>();
+            game.bc->init(game.gc);
+        }
+    }
+
+    void step(ProtocolGame &game, std::uint32_t bits) {
+        if (game.bc) {
+            const search::Action a(bits);
+            if (!a.isValidAction(*game.bc)) {
+                throw std::invalid_argument("invalid battle action");
+            }
+            a.execute(*game.bc);
+
+        } else {
+            if (game.gc.outcome != GameOutcome::UNDECIDED) {
+                throw std::invalid_argument("game is over");
+            }
+            const search::GameAction a(bits);
+            if (!a.isValidAction(game.gc)) {
+                throw std::invalid_argument("invalid game action");
+            }
+            a.execute(game.gc);
+        }
+        advance(game);
+    }
+
+    json getActions(const ProtocolGame &game) {
+        json ret = json::array();
+        if (game.bc) {
+            search::ActionList actions;
+            search::BattleScumSearcher2::enumerateActions(*game.bc, actions);
+            for (const auto &a : actions) {
+                ret.push_back(a.bits);
+            }
+        } else {
+            for (const auto &a : search::GameAction::getAllActionsInState(game.gc)) {
+                ret.push_back(a.bits);
+            }
+        }
+        return ret;
+    }
+
+    json getState(const ProtocolGame &game) {
+        const auto &gc = game.gc;
+        json ret = {
+                {"screen", screenStateStrings[static_cast<int>(gc.screenState)]},
+                {"floor", gc.floorNum},
+                {"hp", gc.curHp},
+                {"maxHp", gc.maxHp},
+                {"gold", gc.gold},
+                {"inBattle", static_cast<bool>(game.bc)},
+        };
+        if (game.bc) {
+            ret["turn"] = game.bc->turn;
+            ret["hp"] = game.bc->player.curHp;
+        }
+        return ret;
+    }
+
+    json makeError(const json &request, const std::string &msg) {
+        json ret = {{"id", request.is_object() ? request.value("id", json()) : json()}, {"ok", false}, {"error", msg}};
+        return ret;
+    }
+
+#ifndef _WIN32
+    // a buffered stream over a socket, in_avail() reports only what is already buffered so the server can tell
+    // when a pipelined batch has been consumed
+    class FdStreamBuf : public std::streambuf {
+        static constexpr int BUFFER_SIZE = 1 << 16;
+
+        int fd;
+        std::unique_ptr<char[]> inBuf;
+        std::unique_ptr<char[]> outBuf;
+
+    public:
+        explicit FdStreamBuf(int fd) : fd(fd), inBuf(new char[BUFFER_SIZE]), outBuf(new char[BUFFER_SIZE]) {
+            setg(inBuf.get(), inBuf.get(), inBuf.get());
+            setp(outBuf.get(), outBuf.get() + BUFFER_SIZE);
+        }
+
+        ~FdStreamBuf() override {
+            sync();
+        }
+
+    protected:
+        int_type underflow() override {
+            const auto n = ::read(fd, inBuf.get(), BUFFER_SIZE);
+            if (n <= 0) {
+                return traits_type::eof();
+            }
+            setg(inBuf.get(), inBuf.get(), inBuf.get() + n);
+            return traits_type::to_int_type(*gptr());
+        }
+
+        int_type overflow(int_type ch) override {
+            if (sync() == -1) {
+                return traits_type::eof();
+            }
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        int sync() override {
+            const char *cur = pbase();
+            while (cur < pptr()) {
+                const auto n = ::write(fd, cur, pptr() - cur);
+                if (n <= 0) {
+                    return -1;
+                }
+                cur += n;
+            }
+            setp(outBuf.get(), outBuf.get() + BUFFER_SIZE);
+            return 0;
+        }
+    };
+#endif
+
+}
+
+void ProtocolServer::addFields(const ProtocolGame &game, const json &fields, json &ret) const {
+    for (const auto &field : fields) {
+        const auto name = field.get<std::string>();
+        if (name == "actions") {
+            ret["actions"] = getActions(game);
+
+        } else if (name == "observation") {
+            ret["observation"] = getObservation ? json(getObservation(game.gc, game.bc.get())) : json();
+
+        } else if (name == "outcome") {
+            ret["outcome"] = gameOutcomeStrings[static_cast<int>(game.gc.outcome)];
+            if (game.bc) {
+                ret["battleOutcome"] = battleOutcomeStrings[static_cast<int>(game.bc->outcome)];
+            }
+
+        } else if (name == "state") {
+            ret["state"] = getState(game);
+
+        } else {
+            throw std::invalid_argument("unknown field: " + name);
+        }
+    }
+}
+
+void ProtocolServer::handleRequest(std::unordered_map<std::string, ProtocolGame> &games,
+                                   const json &request, json &ret) const {
+    ret = {{"id", request.value("id", json())}};
+    try {
+        const auto op = request.at("op").get<std::string>();
+        const auto key = getGameKey(request);
+        ret["game"] = request.at("game");
+
+        const auto fields = request.value("fields", json::array());
+
+        if (op == "new") {
+            const auto cc = getCharacterClassFromString(request.value("character", std::string("IRONCLAD")));
+            if (cc == CharacterClass::INVALID) {
+                throw std::invalid_argument("invalid character");
+            }
+            const auto seed = getSeed(request.at("seed"));
+            const int ascension = request.value("ascension", 0);
+
+            auto &game = games[key];
+            game.gc = GameContext(cc, seed, ascension);
+            game.bc.reset();
+            advance(game);
+            addFields(game, fields, ret);
+
+        } else if (op == "step" || op == "query") {
+            auto it = games.find(key);
+            if (it == games.end()) {
+                throw std::invalid_argument("unknown game");
+            }
+            if (op == "step") {
+                step(it->second, request.at("action").get<std::uint32_t>());
+            }
+            addFields(it->second, fields, ret);
+
+        } else if (op == "close") {
+            if (games.erase(key) == 0) {
+                throw std::invalid_argument("unknown game");
+            }
+
+        } else {
+            throw std::invalid_argument("unknown op: " + op);
+        }
+        ret["ok"] = true;
+
+    } catch (const std::exception &e) {
+        auto game = ret.value("game", json());
+        ret = makeError(request, e.what());
+        if (!game.is_null()) {
+            ret["game"] = game;
+        }
+    }
+}
+
+void ProtocolServer::serve(std::istream &is, std::ostream &os) const {
+    std::string line;
+
+    if (threadCount <= 1) {
+        std::unordered_map<std::string, ProtocolGame> games;
+        json ret;
+        while (std::getline(is, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            const auto request = json::parse(line, nullptr, false);
+            if (request.is_discarded() || !request.is_object()) {
+                ret = makeError(request, "malformed request");
+            } else {
+                handleRequest(games, request, ret);
+            }
+            os << ret.dump() << '\n';
+            if (is.rdbuf()->in_avail() <= 0) {
+                os.flush();
+            }
+        }
+        os.flush();
+        return;
+    }
+
+    // each game belongs to one worker, so its requests are handled in order without locking the game
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<json> queue;
+        bool done = false;
+        std::unordered_map<std::string, ProtocolGame> games;
+    };
+
+    std::mutex outputMutex;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::unique_ptr<std::thread>> threads;
+
+    for (int i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(new std::thread([&, w=workers[i].get()]() {
+            json ret;
+            while (true) {
+                json request;
+                {
+                    std::unique_lock lock(w->mutex);
+                    w->cv.wait(lock, [=]() { return w->done || !w->queue.empty(); });
+                    if (w->queue.empty()) {
+                        return;
+                    }
+                    request = std::move(w->queue.front());
+                    w->queue.pop_front();
+                }
+
+                handleRequest(w->games, request, ret);
+                const auto response = ret.dump();
+
+                bool batchDone;
+                {
+                    std::scoped_lock lock(w->mutex);
+                    batchDone = w->queue.empty();
+                }
+
+                std::scoped_lock lock(outputMutex);
+                os << response << '\n';
+                if (batchDone) {
+                    os.flush();
+                }
+            }
+        }));
+    }
+
+    while (std::getline(is, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        auto request = json::parse(line, nullptr, false);
+        if (request.is_discarded() || !request.is_object() || !request.contains("game")) {
+            std::scoped_lock lock(outputMutex);
+            os << makeError(request, "malformed request").dump() << '\n';
+            if (is.rdbuf()->in_avail() <= 0) {
+                os.flush();
+            }
+            continue;
+        }
+
+        auto &w = *workers[std::hash<std::string>()(getGameKey(request)) % threadCount];
+        {
+            std::scoped_lock lock(w.mutex);
+            w.queue.push_back(std::move(request));
+        }
+        w.cv.notify_one();
+    }
+
+    for (auto &w : workers) {
+        {
+            std::scoped_lock lock(w->mutex);
+            w->done = true;
+        }
+        w->cv.notify_one();
+    }
+    for (auto &t : threads) {
+        t->join();
+    }
+    os.flush();
+}
+
+#ifndef _WIN32
+bool ProtocolServer::serveUnixSocket(const std::string &path) const {
+    sockaddr_un addr {};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "socket path too long: " << path << std::endl;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+
+    const int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd == -1) {
+        std::cerr << "failed to create socket" << std::endl;
+        return false;
+    }
+
+    ::unlink(path.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 || ::listen(listenFd, 16) == -1) {
+        std::cerr << "failed to listen on " << path << std::endl;
+        ::close(listenFd);
+        return false;
+    }
+
+    while (true) {
+        const int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd == -1) {
+            continue;
+        }
+        std::thread([this, fd]() {
+            {
+                FdStreamBuf buf(fd);
+                std::istream is(&buf);
+                std::ostream os(&buf);
+                serve(is, os);
+            }
+            ::close(fd);
+        }).detach();
+    }
+}
+#endif
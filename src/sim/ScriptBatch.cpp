@@ -0,0 +1,137 @@
+#include "sim/ScriptBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <sstream>
+#include <thread>
+
+#include "sim/ConsoleSimulator.h"
+
+using namespace sts;
+
+namespace {
+
+    struct ScriptBatchInfo {
+        const std::vector<std::string> *paths;
+        const ScriptBatch::ResultFnc *fn;
+
+        std::mutex m;
+        std::size_t curIdx = 0;
+    };
+
+    void scriptBatchRunner(ScriptBatchInfo *info) {
+        while (true) {
+            std::size_t idx;
+            {
+                std::scoped_lock lock(info->m);
+                idx = info->curIdx++;
+            }
+            if (idx >= info->paths->size()) {
+                break;
+            }
+
+            auto result = ScriptBatch::runScript((*info->paths)[idx]);
+            (*info->fn)(idx, result);
+        }
+    }
+
+    // the simulator reports a failed assert as a line in its output
+    std::string getFailureLine(const std::string &output) {
+        const auto pos = output.rfind("FAILED TEST");
+        if (pos == std::string::npos) {
+            return "failed test";
+        }
+        const auto end = output.find('\n', pos);
+        return output.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    }
+
+}
+
+std::vector<std::string> ScriptBatch::listScripts(const std::string &dirPath) {
+    std::vector<std::string> ret;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(dirPath)) {
+        if (entry.is_regular_file() && entry.path().filename().string()[0] != '.') {
+            ret.push_back(entry.path().string());
+        }
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+ScriptResult ScriptBatch::runScript(const std::string &path) {
+    ScriptResult result;
+    result.path = path;
+
+    std::ifstream is(path);
+    if (!is) {
+        result.failure = "could not open file";
+        return result;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    SimulatorContext simContext;
+    simContext.printFirstLine = false;
+    simContext.printLogActions = false;
+    simContext.printInput = false;
+    simContext.printPrompts = false;
+
+    std::ostringstream os;
+    ConsoleSimulator sim;
+    std::string exceptionWhat;
+    bool threw = false;
+    try {
+        // a diverged trace can give the simulator input it can't parse, like a non numeric selection
+        sim.play(is, os, simContext);
+    } catch (const std::exception &e) {
+        threw = true;
+        exceptionWhat = e.what();
+    }
+    sim.reset();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    result.seconds = std::chrono::duration<double>(endTime-startTime).count();
+    result.lineCount = simContext.line;
+    if (threw) {
+        result.passed = false;
+        result.failure = "exception: " + exceptionWhat;
+    } else {
+        result.passed = !simContext.failedTest;
+        if (!result.passed) {
+            result.failure = getFailureLine(os.str());
+        }
+    }
+    return result;
+}
+
+void ScriptBatch::forEach(const std::vector<std::string> &paths, int threadCount, const ResultFnc &fn) {
+    ScriptBatchInfo info;
+    info.paths = &paths;
+    info.fn = &fn;
+
+    if (threadCount <= 1) {
+        scriptBatchRunner(&info);
+        return;
+    }
+
+    std::vector<std::unique_ptr<std::thread>> threads;
+    for (int tid = 0; tid < threadCount; ++tid) {
+        threads.emplace_back(new std::thread(scriptBatchRunner, &info));
+    }
+    for (auto &t : threads) {
+        t->join();
+    }
+}
+
+std::vector<ScriptResult> ScriptBatch::run(const std::vector<std::string> &paths, int threadCount) {
+    std::vector<ScriptResult> results(paths.size());
+    forEach(paths, threadCount, [&](std::size_t pathIdx, ScriptResult &result) {
+        results[pathIdx] = std::move(result); // every path index is handed to exactly one worker
+    });
+    return results;
+}
@@ -4,6 +4,7 @@
 
 #include "sim/search/Action.h"
 
+#include <bitset>
 #include <functional>
 
 using namespace sts;
@@ -63,6 +64,18 @@ fixed_list<int, 10> search::Action::getSelectedIdxs() const {
     return ret;
 }
 
+bool search::Action::isMultiSelectPick() const {
+    return getActionType() == ActionType::MULTI_CARD_SELECT && (bits & MULTI_SELECT_PICK);
+}
+
+search::Action search::Action::multiSelectPick(int handIdx) {
+    return {ActionType::MULTI_CARD_SELECT, static_cast<int>(MULTI_SELECT_PICK) | (1 << handIdx)};
+}
+
+search::Action search::Action::multiSelectDone() {
+    return {ActionType::MULTI_CARD_SELECT, static_cast<int>(MULTI_SELECT_PICK)};
+}
+
 bool isValidPotionAction(const BattleContext &bc, const search::Action &a) {
     if (bc.inputState != InputState::PLAYER_NORMAL) {
         return false;
@@ -193,34 +206,27 @@ bool isValidSingleCardSelectAction(const BattleContext &bc, const search::Action
     }
 }
 
-bool isValidMultiCardSelectAction(const BattleContext &bc, const search::Action &a) { // this can be sped up using compiler intrinsics
-    switch (bc.cardSelectInfo.cardSelectTask) {
-        case sts::CardSelectTask::EXHAUST_MANY: {
-            const auto selected = a.getSelectedIdxs();
-            if (selected.size() > bc.cardSelectInfo.pickCount) {
-                return false;
-            }
-            for (auto x : selected) {
-                if (x >= bc.cards.cardsInHand) {
-                    return false;
-                }
-            }
-            return true;
-        }
+bool isValidMultiCardSelectAction(const BattleContext &bc, const search::Action &a) {
+    if (bc.inputState != InputState::CARD_SELECT) {
+        return false;
+    }
 
-        case sts::CardSelectTask::GAMBLE: {
-            const auto selected = a.getSelectedIdxs();
-            for (auto x : selected) {
-                if (x >= bc.cards.cardsInHand) {
-                    return false;
-                }
-            }
-            return true;
-        }
+    if (bc.cardSelectInfo.cardSelectTask != CardSelectTask::EXHAUST_MANY &&
+        bc.cardSelectInfo.cardSelectTask != CardSelectTask::GAMBLE) {
+        return false;
+    }
 
-        default:
-            return false;
+    const auto pickedBits = static_cast<std::uint32_t>(bc.cardSelectInfo.multiSelect_PickedBits());
+    const auto selectBits = a.bits & 0x3FF;
+    if (a.isMultiSelectPick() && ((selectBits & (selectBits-1)) != 0 || (selectBits & pickedBits) != 0)) {
+        return false; // a pick adds one new card
     }
+
+    const auto bits = selectBits | pickedBits;
+    if ((bits >> bc.cards.cardsInHand) != 0) {
+        return false;
+    }
+    return std::bitset<10>(bits).count() <= search::CardSubsetGenerator::getMaxPicks(bc);
 }
 
 bool search::Action::isValidAction(const BattleContext &bc) const {
@@ -262,10 +268,13 @@ std::ostream& printSingleCardSelectDescHelper(std::ostream &os, const BattleCont
 std::ostream& printMultiCardSelectDescHelper(std::ostream &os, const BattleContext &bc, const search::Action &a) {
     // action is known to be valid here
     os << "{ " << cardSelectTaskStrings[static_cast<int>(bc.cardSelectInfo.cardSelectTask)];
+    if (a.isMultiSelectPick()) {
+        os << " pick";
+    }
 
     const auto selected = a.getSelectedIdxs();
     if (selected.empty()) {
-        return os << " none";
+        return os << (a.isMultiSelectPick() ? " done }" : " none }");
     }
 
     for (int i = 0; i < selected.size(); ++i) {
@@ -403,14 +412,17 @@ void executeSingleCardSelectActionHelper(BattleContext &bc, search::Action a) {
 
 void executeMultiCardSelectActionHelper(BattleContext &bc, search::Action a) {
     // assumed to be valid action here
+    const search::Action selection((a.bits & 0x3FF) | bc.cardSelectInfo.multiSelect_PickedBits());
+    bc.cardSelectInfo.multiSelect_PickedBits() = 0;
+
     switch (bc.cardSelectInfo.cardSelectTask) {
 
         case sts::CardSelectTask::EXHAUST_MANY:
-            bc.chooseExhaustCards(a.getSelectedIdxs());
+            bc.chooseExhaustCards(selection.getSelectedIdxs());
             break;
 
         case sts::CardSelectTask::GAMBLE:
-            bc.chooseGambleCards(a.getSelectedIdxs());
+            bc.chooseGambleCards(selection.getSelectedIdxs());
             break;
 
         default:
@@ -449,6 +461,10 @@ void search::Action::execute(BattleContext &bc) const {
             break;
 
         case ActionType::MULTI_CARD_SELECT:
+            if (isMultiSelectPick() && (bits & 0x3FF)) {
+                bc.cardSelectInfo.multiSelect_PickedBits() |= static_cast<int>(bits & 0x3FF);
+                return; // the selection stays open
+            }
             executeMultiCardSelectActionHelper(bc, *this);
             break;
 
@@ -556,3 +572,118 @@ std::vector<search::Action> search::Action::enumerateCardSelectActions(const Bat
 
 
 
+
+search::CardSubsetGenerator::CardSubsetGenerator(const BattleContext &bc) : maxPicks(getMaxPicks(bc)) {
+    for (int handIdx = 0; handIdx < bc.cards.cardsInHand; ++handIdx) {
+        const auto &c = bc.cards.hand[handIdx];
+        auto it = std::find_if(classes.begin(), classes.end(), [&](const auto &cls) {
+            return areEquivalent(bc.cards.hand[cls[0]], c);
+        });
+        if (it == classes.end()) {
+            classes.push_back({handIdx});
+        } else {
+            it->push_back(handIdx);
+        }
+    }
+}
+
+bool search::CardSubsetGenerator::next(search::Action &a) {
+    if (!started) {
+        started = true;
+
+    } else {
+        // count up in a mixed radix where digit i runs to the size of class i, skipping selections over maxPicks
+        int i = 0;
+        for (; i < classes.size(); ++i) {
+            if (chosen[i] < classes[i].size() && chosenTotal < maxPicks) {
+                ++chosen[i];
+                ++chosenTotal;
+                break;
+            }
+            chosenTotal -= chosen[i];
+            chosen[i] = 0;
+        }
+        if (i == classes.size()) {
+            return false;
+        }
+    }
+
+    std::uint32_t bits = 0;
+    for (int i = 0; i < classes.size(); ++i) {
+        for (int j = 0; j < chosen[i]; ++j) {
+            bits |= 1U << classes[i][j];
+        }
+    }
+    a = Action(ActionType::MULTI_CARD_SELECT, static_cast<int>(bits));
+    return true;
+}
+
+std::int64_t search::CardSubsetGenerator::count() const {
+    std::array<std::int64_t, 11> ways {}; // ways[t] selections of t cards from the classes so far
+    ways[0] = 1;
+    for (const auto &cls : classes) {
+        for (int t = maxPicks; t >= 0; --t) {
+            for (int k = 1; k <= cls.size() && k <= t; ++k) {
+                ways[t] += ways[t-k];
+            }
+        }
+    }
+    std::int64_t ret = 0;
+    for (int t = 0; t <= maxPicks; ++t) {
+        ret += ways[t];
+    }
+    return ret;
+}
+
+fixed_list<search::Action,11> search::CardSubsetGenerator::getNextPicks(std::uint32_t pickedBits) const {
+    fixed_list<Action,11> ret;
+    ret.push_back(Action::multiSelectDone());
+
+    // in the order of classes, the cards of a selection are picked by increasing position. at one level a card equal
+    // to the card before it is skipped, that one is picked first
+    fixed_list<int,10> order;
+    int lastPickedPos = -1;
+    for (const auto &cls : classes) {
+        for (auto handIdx : cls) {
+            if (pickedBits & (1U << handIdx)) {
+                lastPickedPos = order.size();
+            }
+            order.push_back(handIdx);
+        }
+    }
+
+    if (std::bitset<10>(pickedBits).count() >= maxPicks) {
+        return ret;
+    }
+
+    int prevClass = -1;
+    for (int classIdx = 0, pos = 0; classIdx < classes.size(); ++classIdx) {
+        for (int j = 0; j < classes[classIdx].size(); ++j, ++pos) {
+            if (pos <= lastPickedPos) {
+                continue;
+            }
+            if (prevClass != classIdx) {
+                ret.push_back(Action::multiSelectPick(order[pos]));
+                prevClass = classIdx;
+            }
+        }
+    }
+    return ret;
+}
+
+int search::CardSubsetGenerator::getMaxPicks(const BattleContext &bc) {
+    if (bc.cardSelectInfo.cardSelectTask == CardSelectTask::EXHAUST_MANY) {
+        return std::min(bc.cardSelectInfo.pickCount, bc.cards.cardsInHand);
+    }
+    return bc.cards.cardsInHand;
+}
+
+bool search::CardSubsetGenerator::areEquivalent(const CardInstance &a, const CardInstance &b) {
+    return a.id == b.id &&
+           a.getUpgradeCount() == b.getUpgradeCount() &&
+           a.cost == b.cost &&
+           a.costForTurn == b.costForTurn &&
+           a.freeToPlayOnce == b.freeToPlayOnce &&
+           a.retain == b.retain &&
+           a.specialData == b.specialData;
+}
@@ -0,0 +1,142 @@
+#include "sim/search/ActionSpace.h"
+
+#include <cstring>
+
+using namespace sts;
+
+search::Action search::ActionSpace::decode(int idx) {
+    if (idx < POTION_BEGIN) {
+        return {ActionType::CARD, (idx-CARD_BEGIN) / MAX_TARGETS, (idx-CARD_BEGIN) % MAX_TARGETS};
+
+    } else if (idx < POTION_DISCARD_BEGIN) {
+        return {ActionType::POTION, (idx-POTION_BEGIN) / MAX_TARGETS, (idx-POTION_BEGIN) % MAX_TARGETS};
+
+    } else if (idx < END_TURN) {
+        return {ActionType::POTION, idx-POTION_DISCARD_BEGIN, -1};
+
+    } else if (idx == END_TURN) {
+        return Action(ActionType::END_TURN);
+
+    } else if (idx < MULTI_SELECT_PICK_BEGIN) {
+        return {ActionType::SINGLE_CARD_SELECT, idx-SINGLE_SELECT_BEGIN};
+
+    } else if (idx < MULTI_SELECT_DONE) {
+        return Action::multiSelectPick(idx-MULTI_SELECT_PICK_BEGIN);
+
+    } else {
+        return Action::multiSelectDone();
+    }
+}
+
+int search::ActionSpace::encode(Action a) {
+    switch (a.getActionType()) {
+        case ActionType::CARD:
+            if (a.getSourceIdx() >= CardManager::MAX_HAND_SIZE || a.getTargetIdx() >= MAX_TARGETS) {
+                return -1;
+            }
+            return CARD_BEGIN + a.getSourceIdx()*MAX_TARGETS + a.getTargetIdx();
+
+        case ActionType::POTION:
+            if (a.getSourceIdx() >= MAX_POTIONS) {
+                return -1;
+            }
+            if (a.getTargetIdx() > MAX_TARGETS) { // see isValidPotionAction
+                return POTION_DISCARD_BEGIN + a.getSourceIdx();
+            }
+            if (a.getTargetIdx() == MAX_TARGETS) {
+                return -1;
+            }
+            return POTION_BEGIN + a.getSourceIdx()*MAX_TARGETS + a.getTargetIdx();
+
+        case ActionType::SINGLE_CARD_SELECT:
+            return a.getSelectIdx() < CardManager::MAX_GROUP_SIZE ? SINGLE_SELECT_BEGIN + a.getSelectIdx() : -1;
+
+        case ActionType::MULTI_CARD_SELECT: {
+            const auto selectBits = a.bits & 0x3FF;
+            if (selectBits == 0) {
+                return MULTI_SELECT_DONE;
+            }
+            if (!a.isMultiSelectPick() || (selectBits & (selectBits-1)) != 0) {
+                return -1;
+            }
+            int handIdx = 0;
+            while (!(selectBits & (1U << handIdx))) {
+                ++handIdx;
+            }
+            return MULTI_SELECT_PICK_BEGIN + handIdx;
+        }
+
+        case ActionType::END_TURN:
+            return END_TURN;
+
+        default:
+            return -1;
+    }
+}
+
+int search::ActionSpace::writeLegalityMask(const BattleContext &bc, std::uint8_t *mask) {
+    std::memset(mask, 0, SIZE);
+    if (bc.outcome != Outcome::UNDECIDED) {
+        return 0;
+    }
+
+    int legalCount = 0;
+    const auto setLegal = [&](int idx) {
+        mask[idx] = 1;
+        ++legalCount;
+    };
+
+    if (bc.inputState == InputState::PLAYER_NORMAL) {
+        // the same conditions as isValidCardAction and isValidPotionAction, without decoding every index
+        if (bc.isCardPlayAllowed()) {
+            for (int handIdx = 0; handIdx < bc.cards.cardsInHand; ++handIdx) {
+                const auto &c = bc.cards.hand[handIdx];
+                if (!c.canUseOnAnyTarget(bc)) {
+                    continue;
+                }
+                if (!c.requiresTarget()) {
+                    setLegal(CARD_BEGIN + handIdx*MAX_TARGETS);
+                    continue;
+                }
+                for (int tIdx = 0; tIdx < bc.monsters.monsterCount; ++tIdx) {
+                    if (bc.monsters.arr[tIdx].isTargetable()) {
+                        setLegal(CARD_BEGIN + handIdx*MAX_TARGETS + tIdx);
+                    }
+                }
+            }
+        }
+
+        for (int pIdx = 0; pIdx < MAX_POTIONS; ++pIdx) {
+            const auto p = bc.potions[pIdx];
+            if (p == Potion::INVALID || p == Potion::EMPTY_POTION_SLOT) {
+                continue;
+            }
+            setLegal(POTION_DISCARD_BEGIN + pIdx);
+
+            if (p == Potion::FAIRY_POTION) {
+                continue;
+            }
+            if (!potionRequiresTarget(p)) {
+                setLegal(POTION_BEGIN + pIdx*MAX_TARGETS);
+                continue;
+            }
+            for (int tIdx = 0; tIdx < bc.monsters.monsterCount; ++tIdx) {
+                if (bc.monsters.arr[tIdx].isTargetable()) {
+                    setLegal(POTION_BEGIN + pIdx*MAX_TARGETS + tIdx);
+                }
+            }
+        }
+
+        setLegal(END_TURN);
+
+    } else if (bc.inputState == InputState::CARD_SELECT) {
+        // selects are rare, so these just decode and validate
+        for (int idx = SINGLE_SELECT_BEGIN; idx < SIZE; ++idx) {
+            if (decode(idx).isValidAction(bc)) {
+                setLegal(idx);
+            }
+        }
+    }
+
+    return legalCount;
+}
@@ -0,0 +1,304 @@
+#include "sim/search/AgentComparison.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "sim/search/ScumSearchAgent2.h"
+#include "sim/search/SimpleAgent.h"
+#include "sim/search/StaticEvaluator.h"
+
+using namespace sts;
+
+namespace {
+
+    struct AgentComparisonInfo {
+        search::AgentComparison *comparison;
+
+        std::mutex m;
+        int nextPairIdx = 0;
+        bool stopped = false;
+        std::map<int, search::PairedPlayout> finished; // waiting for the pairs before them
+    };
+
+    void agentComparisonRunner(AgentComparisonInfo *info) {
+        auto &ac = *info->comparison;
+        while (true) {
+            int pairIdx;
+            {
+                std::scoped_lock lock(info->m);
+                if (info->stopped || info->nextPairIdx >= ac.maxPairs) {
+                    return;
+                }
+                pairIdx = info->nextPairIdx++;
+            }
+
+            search::PairedPlayout pair;
+            pair.seed = ac.startSeed + pairIdx;
+            pair.a = ac.agentA(pair.seed);
+            pair.b = ac.agentB(pair.seed);
+
+            // pairs are counted in seed order so the stop doesn't depend on which worker finishes first
+            std::scoped_lock lock(info->m);
+            if (info->stopped) {
+                ++ac.discardedPairCount;
+                continue;
+            }
+            info->finished.emplace(pairIdx, pair);
+
+            auto it = info->finished.begin();
+            while (!info->stopped && it != info->finished.end() && it->first == static_cast<int>(ac.pairs.size())) {
+                const auto &p = it->second;
+                ac.pairs.push_back(p);
+                ac.winDifference.add(static_cast<double>(p.a.won) - static_cast<double>(p.b.won));
+                ac.floorDifference.add(p.a.floorNum - p.b.floorNum);
+                ac.winDecision = ac.decide(ac.winDifference, ac.winRateTolerance);
+                ac.floorDecision = ac.decide(ac.floorDifference, ac.floorTolerance);
+                info->stopped = ac.isResolved();
+
+                if (ac.onPair) {
+                    ac.onPair(p, ac);
+                }
+                it = info->finished.erase(it);
+            }
+            if (info->stopped) {
+                ac.discardedPairCount += static_cast<int>(info->finished.size());
+                info->finished.clear();
+            }
+        }
+    }
+
+    nlohmann::json getAgentSummary(const std::vector<search::PairedPlayout> &pairs, bool isA) {
+        std::int64_t winCount = 0;
+        std::int64_t floorSum = 0;
+        std::int64_t simulationCount = 0;
+        double seconds = 0;
+        for (const auto &p : pairs) {
+            const auto &r = isA ? p.a : p.b;
+            winCount += r.won;
+            floorSum += r.floorNum;
+            simulationCount += r.simulationCount;
+            seconds += r.seconds;
+        }
+
+        const auto n = std::max<std::size_t>(pairs.size(), 1);
+        return {
+                {"wins", winCount},
+                {"winRate", static_cast<double>(winCount) / n},
+                {"avgFloor", static_cast<double>(floorSum) / n},
+                {"totalSimulations", simulationCount},
+                {"seconds", seconds},
+        };
+    }
+
+}
+
+void search::PairedDifference::add(double diff) {
+    ++count;
+    const double delta = diff - mean;
+    mean += delta / count;
+    m2 += delta * (diff - mean);
+}
+
+double search::PairedDifference::getVariance() const {
+    return count > 1 ? m2 / (count - 1) : 0;
+}
+
+double search::PairedDifference::getRadius(double alpha, int mixturePairs, double minVariance) const {
+    if (count == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    // in units of the standard deviation, the intrinsic time is the pair count and rho is mixturePairs
+    const double v = count + mixturePairs;
+    const double boundary = std::sqrt(v * (std::log(v / mixturePairs) + 2 * std::log(2 / alpha)));
+    return std::sqrt(std::max(getVariance(), minVariance)) * boundary / count;
+}
+
+search::ComparisonDecision search::AgentComparison::decide(const PairedDifference &d, double tolerance) const {
+    if (d.count < minPairs) {
+        return ComparisonDecision::UNDECIDED;
+    }
+
+    const double radius = d.getRadius(alpha, minPairs, minVariance);
+    const double lower = d.mean - radius;
+    const double upper = d.mean + radius;
+    if (lower > 0) {
+        return ComparisonDecision::A_BETTER;
+    }
+    if (upper < 0) {
+        return ComparisonDecision::B_BETTER;
+    }
+    if (lower > -tolerance && upper < tolerance) {
+        return ComparisonDecision::EQUIVALENT;
+    }
+    return ComparisonDecision::UNDECIDED;
+}
+
+bool search::AgentComparison::isResolved() const {
+    const auto isDifference = [](ComparisonDecision d) {
+        return d == ComparisonDecision::A_BETTER || d == ComparisonDecision::B_BETTER;
+    };
+    if (stopOnDifference && (isDifference(winDecision) || isDifference(floorDecision))) {
+        return true;
+    }
+    return winDecision != ComparisonDecision::UNDECIDED && floorDecision != ComparisonDecision::UNDECIDED;
+}
+
+void search::AgentComparison::run() {
+    pairs.clear();
+    winDifference = PairedDifference();
+    floorDifference = PairedDifference();
+    winDecision = ComparisonDecision::UNDECIDED;
+    floorDecision = ComparisonDecision::UNDECIDED;
+    discardedPairCount = 0;
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    AgentComparisonInfo info;
+    info.comparison = this;
+
+    if (threadCount <= 1) {
+        agentComparisonRunner(&info);
+
+    } else {
+        std::vector<std::unique_ptr<std::thread>> threads;
+        for (int tid = 0; tid < threadCount; ++tid) {
+            threads.emplace_back(new std::thread(agentComparisonRunner, &info));
+        }
+        for (auto &t : threads) {
+            t->join();
+        }
+    }
+
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    seconds = std::chrono::duration<double>(endTime-startTime).count();
+}
+
+nlohmann::json search::AgentComparison::getReport(const nlohmann::json &configA, const nlohmann::json &configB) const {
+    const auto getMetric = [&](const PairedDifference &d, ComparisonDecision decision, double tolerance) {
+        const double radius = d.getRadius(alpha, minPairs, minVariance);
+        return nlohmann::json {
+                {"meanDifference", d.mean},
+                {"variance", d.getVariance()},
+                {"lower", d.count ? d.mean - radius : -tolerance},
+                {"upper", d.count ? d.mean + radius : tolerance},
+                {"tolerance", tolerance},
+                {"decision", comparisonDecisionStrings[static_cast<int>(decision)]},
+        };
+    };
+
+    nlohmann::json pairsJson = nlohmann::json::array();
+    for (const auto &p : pairs) {
+        pairsJson.push_back({p.seed, p.a.won, p.a.floorNum, p.b.won, p.b.floorNum});
+    }
+
+    return {
+            {"configA", configA},
+            {"configB", configB},
+            {"startSeed", startSeed},
+            {"threadCount", threadCount},
+            {"minPairs", minPairs},
+            {"maxPairs", maxPairs},
+            {"alpha", alpha},
+            {"stopOnDifference", stopOnDifference},
+            {"resolved", isResolved()},
+            {"pairCount", pairs.size()},
+            {"discardedPairCount", discardedPairCount},
+            {"seconds", seconds},
+            {"a", getAgentSummary(pairs, true)},
+            {"b", getAgentSummary(pairs, false)},
+            {"winRate", getMetric(winDifference, winDecision, winRateTolerance)},
+            {"floor", getMetric(floorDifference, floorDecision, floorTolerance)},
+            {"pairsColumns", {"seed", "wonA", "floorA", "wonB", "floorB"}},
+            {"pairs", pairsJson},
+    };
+}
+
+search::AgentComparison::AgentFnc search::AgentComparison::makeAgent(const nlohmann::json &config, int ascension) {
+    static constexpr const char *scumKeys[] { "agent", "simulationCountBase", "bossSimulationMultiplier",
+                                              "explorationParameter", "nodeBudget", "determinizationCount",
+                                              "wideningBase", "priorWeight", "multiSelectMode", "rolloutMaxTurns",
+                                              "staticEvaluator" };
+    if (!config.is_object()) {
+        throw std::runtime_error("agent config must be a json object");
+    }
+
+    const auto agentType = config.value("agent", std::string("scum"));
+    if (agentType == "simple") {
+        if (config.size() > 1) {
+            throw std::runtime_error("the simple agent has no settings");
+        }
+        return [=](std::uint64_t seed) {
+            const auto startTime = std::chrono::high_resolution_clock::now();
+            GameContext gc(CharacterClass::IRONCLAD, seed, ascension);
+            SimpleAgent agent;
+            agent.playout(gc);
+
+            PlayoutResult r;
+            r.won = gc.outcome == GameOutcome::PLAYER_VICTORY;
+            r.floorNum = gc.floorNum;
+            r.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now()-startTime).count();
+            return r;
+        };
+    }
+    if (agentType != "scum") {
+        throw std::runtime_error("unknown agent: " + agentType);
+    }
+
+    for (const auto &item : config.items()) {
+        if (std::find(std::begin(scumKeys), std::end(scumKeys), item.key()) == std::end(scumKeys)) {
+            throw std::runtime_error("unknown agent config key: " + item.key());
+        }
+    }
+
+    ScumSearchAgent2 settings;
+    settings.simulationCountBase = config.value("simulationCountBase", settings.simulationCountBase);
+    settings.bossSimulationMultiplier = config.value("bossSimulationMultiplier", settings.bossSimulationMultiplier);
+    settings.explorationParameter = config.value("explorationParameter", settings.explorationParameter);
+    settings.nodeBudget = config.value("nodeBudget", settings.nodeBudget);
+    settings.determinizationCount = config.value("determinizationCount", settings.determinizationCount);
+    settings.wideningBase = config.value("wideningBase", settings.wideningBase);
+    settings.priorWeight = config.value("priorWeight", settings.priorWeight);
+    settings.multiSelectMode = static_cast<MultiSelectMode>(config.value("multiSelectMode", 0));
+    settings.rolloutPolicy.maxTurns = config.value("rolloutMaxTurns", 0);
+    if (config.contains("staticEvaluator")) {
+        const auto &evaluatorJson = config["staticEvaluator"];
+        if (evaluatorJson.is_string() && evaluatorJson.get<std::string>() == "intentAware") {
+            settings.rolloutPolicy.cutoffEvalFnc = StaticEvaluator::intentAware().getEvalFnc();
+        } else if (evaluatorJson.is_object()) {
+            settings.rolloutPolicy.cutoffEvalFnc = StaticEvaluator::fromJson(evaluatorJson).getEvalFnc();
+        } else {
+            throw std::runtime_error("staticEvaluator must be \"intentAware\" or a json object");
+        }
+    }
+
+    return [=](std::uint64_t seed) {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        GameContext gc(CharacterClass::IRONCLAD, seed, ascension);
+        ScumSearchAgent2 agent;
+        agent.simulationCountBase = settings.simulationCountBase;
+        agent.bossSimulationMultiplier = settings.bossSimulationMultiplier;
+        agent.explorationParameter = settings.explorationParameter;
+        agent.nodeBudget = settings.nodeBudget;
+        agent.determinizationCount = settings.determinizationCount;
+        agent.wideningBase = settings.wideningBase;
+        agent.priorWeight = settings.priorWeight;
+        agent.multiSelectMode = settings.multiSelectMode;
+        agent.rolloutPolicy = settings.rolloutPolicy;
+        agent.rng = std::default_random_engine(gc.seed);
+        agent.playout(gc);
+
+        PlayoutResult r;
+        r.won = gc.outcome == GameOutcome::PLAYER_VICTORY;
+        r.floorNum = gc.floorNum;
+        r.simulationCount = agent.simulationCountTotal;
+        r.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now()-startTime).count();
+        return r;
+    };
+}
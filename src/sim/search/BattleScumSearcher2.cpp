@@ -5,7 +5,9 @@
 #include <algorithm>
 #include "sim/search/BattleScumSearcher2.h"
 #include "sim/search/ExpertKnowledge.h"
+#include "sim/search/StaticEvaluator.h"
 
+#include <cmath>
 #include <utility>
 #include <string>
 #include <memory>
@@ -32,13 +34,67 @@ void search::BattleScumSearcher2::search(int64_t simulations) {
         outcomePlayerHp = rootState->player.curHp;
         bestActionSequence = {};
 
-        root.evaluationSum = evaluation;
+        root.meanEvaluation = static_cast<float>(evaluation);
         root.simulationCount = 1;
     }
 
     for (std::int64_t simCount = 0; simCount < simulations; ++simCount) {
         step();
+        if (nodeBudget > 0 && nodeCount > nodeBudget) {
+            pruneTree(static_cast<std::int64_t>(nodeBudget * pruneTargetRatio));
+        }
+    }
+}
+
+std::int64_t search::BattleScumSearcher2::nodeBudgetForBytes(std::int64_t bytes) {
+    return std::max(std::int64_t(1), bytes / static_cast<std::int64_t>(sizeof(Edge)));
+}
+
+// frees the subtree below node and returns the number of nodes freed, node keeps its statistics and becomes a leaf
+static std::int64_t collapseNode(search::BattleScumSearcher2::Node &node) {
+    std::int64_t freed = 0;
+    for (auto &edge : node.edges) {
+        freed += 1 + collapseNode(edge.node);
     }
+    std::vector<search::BattleScumSearcher2::Edge>().swap(node.edges);
+    return freed;
+}
+
+static std::int64_t collapseBelowThreshold(search::BattleScumSearcher2::Node &node, std::uint32_t threshold) {
+    std::int64_t freed = 0;
+    for (auto &edge : node.edges) {
+        if (edge.node.edges.empty()) {
+            continue;
+        }
+        if (edge.node.simulationCount < threshold) {
+            freed += collapseNode(edge.node);
+        } else {
+            freed += collapseBelowThreshold(edge.node, threshold);
+        }
+    }
+    return freed;
+}
+
+void search::BattleScumSearcher2::pruneTree(std::int64_t targetNodeCount) {
+    ++pruneCount;
+    // raise the visit threshold until enough of the tree is gone, the root is never collapsed
+    for (std::uint32_t threshold = 2; nodeCount > targetNodeCount && !root.edges.empty(); threshold *= 2) {
+        const auto freed = collapseBelowThreshold(root, threshold);
+        nodeCount -= freed;
+        reclaimedNodeCount += freed;
+        if (threshold > root.simulationCount) {
+            break;
+        }
+    }
+}
+
+double search::BattleScumSearcher2::Node::getEvaluationSum() const {
+    return static_cast<double>(meanEvaluation) * simulationCount;
+}
+
+void search::BattleScumSearcher2::Node::addEvaluation(double evaluation) {
+    ++simulationCount;
+    meanEvaluation = static_cast<float>(meanEvaluation + (evaluation - meanEvaluation) / simulationCount);
 }
 
 void search::BattleScumSearcher2::step() {
@@ -51,29 +107,55 @@ void search::BattleScumSearcher2::step() {
         auto &curNode = *searchStack.back();
 
         if (isTerminalState(curState)) {
+            STS_PROFILE(const auto profileScope = profile::searchPhaseScope(profile::SearchPhase::BACKPROP));
             updateFromPlayout(searchStack, actionStack, curState);
             return;
         }
 
         const bool isLeaf = curNode.edges.empty();
         if (isLeaf) {
+            {
+                STS_PROFILE(const auto profileScope = profile::searchPhaseScope(profile::SearchPhase::EXPAND));
+                ++simulationIdx;
+                if (usesPriors()) {
+                    widenNode(curNode, curState, getWidenedEdgeCount(curNode.simulationCount));
+                } else {
+                    enumerateActionsForNode(curNode, curState);
+                }
+                nodeCount += static_cast<std::int64_t>(curNode.edges.size());
+                peakNodeCount = std::max(peakNodeCount, nodeCount);
+                const auto selectIdx = selectFirstActionForLeafNode(curNode);
+                auto &edgeTaken = curNode.edges[selectIdx];
 
-            ++simulationIdx;
-            enumerateActionsForNode(curNode, curState);
-            const auto selectIdx = selectFirstActionForLeafNode(curNode);
-            auto &edgeTaken = curNode.edges[selectIdx];
+//                edgeTaken.action.printDesc(std::cout, curState) << std::endl;
+                edgeTaken.action.execute(curState);
 
-//            edgeTaken.action.printDesc(std::cout, curState) << std::endl;
-            edgeTaken.action.execute(curState);
+                actionStack.push_back(edgeTaken.action);
+                searchStack.push_back(&edgeTaken.node);
+            }
 
-            actionStack.push_back(edgeTaken.action);
-            searchStack.push_back(&edgeTaken.node);
+            bool wasCutoff;
+            {
+                STS_PROFILE(const auto profileScope = profile::searchPhaseScope(profile::SearchPhase::ROLLOUT));
+                wasCutoff = playout(curState, actionStack);
+            }
 
-            playoutRandom(curState, actionStack);
-            updateFromPlayout(searchStack, actionStack, curState);
+            STS_PROFILE(const auto profileScope = profile::searchPhaseScope(profile::SearchPhase::BACKPROP));
+            updateFromPlayout(searchStack, actionStack, curState, wasCutoff);
             return;
 
         } else {
+            STS_PROFILE(const auto profileScope = profile::searchPhaseScope(profile::SearchPhase::SELECT));
+            if (wideningBase > 0) {
+                // only re-enumerate when the widened count steps up, a node that has run out of actions stays cheap
+                const auto edgeCount = getWidenedEdgeCount(curNode.simulationCount);
+                if (edgeCount > static_cast<int>(curNode.edges.size()) && edgeCount > getWidenedEdgeCount(curNode.simulationCount-1)) {
+                    const auto prevEdgeCount = static_cast<std::int64_t>(curNode.edges.size());
+                    widenNode(curNode, curState, edgeCount);
+                    nodeCount += static_cast<std::int64_t>(curNode.edges.size()) - prevEdgeCount;
+                    peakNodeCount = std::max(peakNodeCount, nodeCount);
+                }
+            }
             const auto selectIdx = selectBestEdgeToSearch(curNode);
             auto &edgeTaken = curNode.edges[selectIdx];
 
@@ -86,13 +168,22 @@ void search::BattleScumSearcher2::step() {
     }
 }
 
-void search::BattleScumSearcher2::updateFromPlayout(const std::vector<Node *> &stack, const std::vector<Action> &actionStack, const BattleContext &endState) {
-    const auto evaluation = evaluateEndState(endState);
+void search::BattleScumSearcher2::updateFromPlayout(const std::vector<Node *> &stack, const std::vector<Action> &actionStack, const BattleContext &endState, bool wasCutoff) {
+    double evaluation;
+    if (wasCutoff) {
+        evaluation = rolloutPolicy.cutoffEvalFnc ? rolloutPolicy.cutoffEvalFnc(endState) : evaluateTruncatedState(endState);
 
-    if (evaluation > bestActionValue) {
-        bestActionSequence = actionStack;
-        bestActionValue = evaluation;
-        outcomePlayerHp = endState.player.curHp;
+    } else {
+        evaluation = evaluateEndState(endState);
+        if (evaluation > bestActionValue) {
+            bestActionSequence = actionStack;
+            bestActionValue = evaluation;
+            outcomePlayerHp = endState.player.curHp;
+        }
+    }
+
+    if (evaluation > maxActionValue) {
+        maxActionValue = evaluation;
     }
 
     if (evaluation < minActionValue) {
@@ -100,9 +191,7 @@ void search::BattleScumSearcher2::updateFromPlayout(const std::vector<Node *> &s
     }
 
     for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
-        auto &node = *(*it);
-        ++node.simulationCount;
-        node.evaluationSum += evaluation;
+        (*it)->addEvaluation(evaluation);
     }
 }
 
@@ -115,15 +204,20 @@ double search::BattleScumSearcher2::evaluateEdge(const search::BattleScumSearche
     const auto &edge = parent.edges[edgeIdx];
 
     double qualityValue = 0;
-    if (!bestActionSequence.empty()) {
-        auto avgEvaluation = edge.node.evaluationSum / (edge.node.simulationCount+1);
-        double evalRange = bestActionValue - minActionValue;
+    if (maxActionValue != std::numeric_limits<double>::min()) { // have seen a positive evaluation
+        auto avgEvaluation = edge.node.getEvaluationSum() / (edge.node.simulationCount+1);
+        double evalRange = maxActionValue - minActionValue;
         qualityValue = avgEvaluation / evalRange;
     }
 
     double explorationValue = explorationParameter *
             std::sqrt(std::log(parent.simulationCount+1) / (edge.node.simulationCount+1));
 
+    if (priorWeight > 0) {
+        const double prior = 1.0 / (edgeIdx+1);
+        explorationValue += priorWeight * prior * std::sqrt(parent.simulationCount) / (edge.node.simulationCount+1);
+    }
+
     return qualityValue + explorationValue;
 }
 
@@ -150,61 +244,26 @@ int search::BattleScumSearcher2::selectFirstActionForLeafNode(const search::Batt
     return dist(randGen);
 }
 
-void search::BattleScumSearcher2::playoutRandom(BattleContext &state, std::vector<Action> &actionStack) {
-    Node tempNode; // temp
+bool search::BattleScumSearcher2::playout(BattleContext &state, std::vector<Action> &actionStack) {
+    const int startTurn = state.turn;
+    int actionCount = 0;
     while (!isTerminalState(state)) {
-        ++simulationIdx;
-        enumerateActionsForNode(tempNode, state);
-        if (tempNode.edges.empty()) {
-            std::cerr << state.seed << " " << simulationIdx << std::endl;
-            std::cerr << state.monsters.arr[0].getName() << " " << state.floorNum << " " << monsterEncounterStrings[static_cast<int>(state.encounter)] << std::endl;
-            assert(false);
+        if (rolloutPolicy.shouldCutoff(state, startTurn, actionCount)) {
+            return true;
         }
 
-        auto dist = std::uniform_int_distribution<int>(0, static_cast<int>(tempNode.edges.size())-1);
-        const int selectedIdx = dist(randGen);
-
-        const auto action = tempNode.edges[selectedIdx].action;
+        ++simulationIdx;
+        const auto action = rolloutPolicy.selectAction(state, randGen);
 //        action.printDesc(std::cout, state) << std::endl;
         actionStack.push_back(action);
         action.execute(state);
-
-        tempNode.edges.clear();
-    }
-}
-
-void search::BattleScumSearcher2::enumerateActionsForNode(search::BattleScumSearcher2::Node &node,
-                                                               const BattleContext &bc) {
-    switch (bc.inputState) {
-        case InputState::PLAYER_NORMAL:
-            enumerateCardActions(node, bc);
-            enumeratePotionActions(node, bc);
-            node.edges.push_back({Action(ActionType::END_TURN)});
-            break;
-
-        case InputState::CARD_SELECT:
-            enumerateCardSelectActions(node, bc);
-            break;
-
-        default:
-#ifdef sts_asserts
-            std::cerr << "enumerateActionsForNode: invalid input state: " << static_cast<int>(bc.inputState) << std::endl;
-            assert(false);
-#endif
-            break;
+        ++actionCount;
     }
-
-#ifdef sts_print_debug
-    std::cout << "{ (" << node.edges.size() << ") ";
-    for (int i = 0; i < node.edges.size(); ++i) {
-        node.edges[i].action.printDesc(std::cout, bc) << ", ";
-    }
-    std::cout << " }" << std::endl;
-#endif
+    return false;
 }
 
-void search::BattleScumSearcher2::enumerateCardActions(search::BattleScumSearcher2::Node &node,
-                                                            const BattleContext &bc) {
+template <typename Container>
+static void enumerateCardActionsImpl(Container &edges, const BattleContext &bc) {
     if (!bc.isCardPlayAllowed()) {
         return;
     }
@@ -250,18 +309,17 @@ void search::BattleScumSearcher2::enumerateCardActions(search::BattleScumSearche
                 if (!bc.monsters.arr[tIdx].isTargetable()) {
                     continue;
                 }
-                node.edges.push_back({Action(ActionType::CARD, handIdx, tIdx)});
+                edges.push_back({search::Action(search::ActionType::CARD, handIdx, tIdx)});
             }
         } else {
-            node.edges.push_back({Action(ActionType::CARD, handIdx)});
+            edges.push_back({search::Action(search::ActionType::CARD, handIdx)});
         }
     }
 
 }
 
-void search::BattleScumSearcher2::enumeratePotionActions(search::BattleScumSearcher2::Node &node,
-                                                              const BattleContext &bc) {
-
+template <typename Container>
+static void enumeratePotionActionsImpl(Container &edges, const BattleContext &bc) {
     const auto hasValidTarget = bc.monsters.getTargetableCount() > 0;
 
     int foundPotions = 0;
@@ -275,98 +333,95 @@ void search::BattleScumSearcher2::enumeratePotionActions(search::BattleScumSearc
 
         // not enumerating the discard of a potion if it can be used
         if (p == Potion::FAIRY_POTION) {
-            node.edges.push_back({Action(ActionType::POTION, pIdx, -1)});
+            edges.push_back({search::Action(search::ActionType::POTION, pIdx, -1)});
             continue;
         }
 
         if (!potionRequiresTarget(p)) {
-            node.edges.push_back({Action(ActionType::POTION, pIdx)});
+            edges.push_back({search::Action(search::ActionType::POTION, pIdx)});
             continue;
         }
 
         // potion requires target
         if (!hasValidTarget) {
-            node.edges.push_back({Action(ActionType::POTION, pIdx, -1)});
+            edges.push_back({search::Action(search::ActionType::POTION, pIdx, -1)});
             continue;
         }
 
         // there is a valid target
         for (int tIdx = 0; tIdx < bc.monsters.monsterCount; ++tIdx) {
             if (bc.monsters.arr[tIdx].isTargetable()) {
-                node.edges.push_back({Action(ActionType::POTION, pIdx, tIdx)});
+                edges.push_back({search::Action(search::ActionType::POTION, pIdx, tIdx)});
             }
         }
     }
 }
 
-template <typename ForwardIt>
-void setupCardOptionsHelper(search::BattleScumSearcher2::Node &node, const ForwardIt begin, const ForwardIt end, const std::function<bool(const CardInstance &)> &p= nullptr) {
+template <typename Container, typename ForwardIt>
+void setupCardOptionsHelper(Container &edges, const ForwardIt begin, const ForwardIt end, const std::function<bool(const CardInstance &)> &p= nullptr) {
     for (int i = 0; begin+i != end; ++i) {
         const auto &c = begin[i];
         if (!p || (p(c))) {
-            node.edges.push_back(
-                    {search::Action(search::ActionType::SINGLE_CARD_SELECT, i)}
-                );
+            edges.push_back({search::Action(search::ActionType::SINGLE_CARD_SELECT, i)});
         }
     }
 }
 
-void search::BattleScumSearcher2::enumerateCardSelectActions(search::BattleScumSearcher2::Node &node,
-                                                                  const BattleContext &bc) {
-
+template <typename Container>
+static void enumerateCardSelectActionsImpl(Container &edges, const BattleContext &bc) {
     switch (bc.cardSelectInfo.cardSelectTask) {
         case CardSelectTask::ARMAMENTS:
-            setupCardOptionsHelper( node, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
+            setupCardOptionsHelper(edges, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
                                     [] (const CardInstance &c) { return c.canUpgrade(); });
             break;
 
         case CardSelectTask::CODEX:
             for (int i = 0; i < 4; ++i) { // i -> 3 action means skip
-                node.edges.push_back({Action(search::ActionType::SINGLE_CARD_SELECT, i)});
+                edges.push_back({search::Action(search::ActionType::SINGLE_CARD_SELECT, i)});
             }
             break;
 
         case CardSelectTask::DISCOVERY:
             for (int i = 0; i < 3; ++i) {
-                node.edges.push_back({Action(search::ActionType::SINGLE_CARD_SELECT, i)});
+                edges.push_back({search::Action(search::ActionType::SINGLE_CARD_SELECT, i)});
             }
             break;
 
         case CardSelectTask::DUAL_WIELD:
-            setupCardOptionsHelper( node, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
+            setupCardOptionsHelper(edges, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
                                     [] (const CardInstance &c) {
                                         return c.getType() == CardType::POWER || c.getType() == CardType::ATTACK;
                                     });
             break;
 
         case CardSelectTask::EXHUME:
-            setupCardOptionsHelper(node, bc.cards.exhaustPile.begin(), bc.cards.exhaustPile.end(),
+            setupCardOptionsHelper(edges, bc.cards.exhaustPile.begin(), bc.cards.exhaustPile.end(),
                                    [](const auto &c) { return c.getId() != CardId::EXHUME; });
             break;
 
         case CardSelectTask::EXHAUST_ONE:
-            setupCardOptionsHelper(node, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
+            setupCardOptionsHelper(edges, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
             break;
 
         case CardSelectTask::FORETHOUGHT:
         case CardSelectTask::WARCRY:
-            setupCardOptionsHelper(node, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
+            setupCardOptionsHelper(edges, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
             break;
 
         case CardSelectTask::HEADBUTT:
         case CardSelectTask::LIQUID_MEMORIES_POTION:
-            setupCardOptionsHelper(node, bc.cards.discardPile.begin(), bc.cards.discardPile.end());
+            setupCardOptionsHelper(edges, bc.cards.discardPile.begin(), bc.cards.discardPile.end());
             break;
 
         case CardSelectTask::SECRET_TECHNIQUE:
-            setupCardOptionsHelper(node, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
+            setupCardOptionsHelper(edges, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
                                     [] (const CardInstance &c) {
                                         return c.getType() == CardType::SKILL;
                                     });
             break;
 
         case CardSelectTask::SECRET_WEAPON:
-            setupCardOptionsHelper(node, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
+            setupCardOptionsHelper(edges, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
                                     [] (const CardInstance &c) {
                                         return c.getType() == CardType::ATTACK;
                                     });
@@ -375,7 +430,7 @@ void search::BattleScumSearcher2::enumerateCardSelectActions(search::BattleScumS
         case CardSelectTask::EXHAUST_MANY:
         case CardSelectTask::GAMBLE:
             // just dont deal with this right now
-            node.edges.push_back({search::Action(search::ActionType::MULTI_CARD_SELECT, 0)});
+            edges.push_back({search::Action(search::ActionType::MULTI_CARD_SELECT, 0)});
             break;
 
         default:
@@ -386,23 +441,155 @@ void search::BattleScumSearcher2::enumerateCardSelectActions(search::BattleScumS
     }
 }
 
-double getNonMinionMonsterCurHpRatio(const BattleContext &bc) {
-    int curHpTotal = 0;
-    int maxHpTotal = 0;
+template <typename Container>
+static void enumerateActionsImpl(Container &edges, const BattleContext &bc) {
+    switch (bc.inputState) {
+        case InputState::PLAYER_NORMAL:
+            enumerateCardActionsImpl(edges, bc);
+            enumeratePotionActionsImpl(edges, bc);
+            edges.push_back({search::Action(search::ActionType::END_TURN)});
+            break;
+
+        case InputState::CARD_SELECT:
+            enumerateCardSelectActionsImpl(edges, bc);
+            break;
+
+        default:
+#ifdef sts_asserts
+            std::cerr << "enumerateActionsForNode: invalid input state: " << static_cast<int>(bc.inputState) << std::endl;
+            assert(false);
+#endif
+            break;
+    }
+}
+
+// sized exactly so the tree's memory follows its node count
+static void appendEdges(search::BattleScumSearcher2::Node &node, const search::ActionList &actions) {
+    node.edges.reserve(node.edges.size() + actions.size());
+    for (auto a : actions) {
+        node.edges.push_back({{}, a});
+    }
+}
+
+void search::BattleScumSearcher2::enumerateActionsForState(const BattleContext &bc, ActionList &actions) const {
+    const bool isMultiSelect = bc.inputState == InputState::CARD_SELECT &&
+            (bc.cardSelectInfo.cardSelectTask == CardSelectTask::EXHAUST_MANY ||
+             bc.cardSelectInfo.cardSelectTask == CardSelectTask::GAMBLE);
+
+    if (!isMultiSelect || multiSelectMode == MultiSelectMode::SKIP) {
+        enumerateActionsImpl(actions, bc);
+        return;
+    }
 
-    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-        const auto &m = bc.monsters.arr[i];
-        if (!m.hasStatus<MS::MINION>() && m.id != sts::MonsterId::INVALID) {
-            curHpTotal += m.curHp;
-            maxHpTotal += m.maxHp;
+    CardSubsetGenerator gen(bc);
+    if (multiSelectMode == MultiSelectMode::SUBSETS && bc.cardSelectInfo.multiSelect_PickedBits() == 0 &&
+        gen.count() <= CardManager::MAX_GROUP_SIZE*2) {
+        Action a;
+        while (gen.next(a)) {
+            actions.push_back(a);
         }
+        return;
     }
 
-    if (curHpTotal == 0 || maxHpTotal == 0) {
-        return 0;
+    for (auto a : gen.getNextPicks(bc.cardSelectInfo.multiSelect_PickedBits())) {
+        actions.push_back(a);
     }
+}
 
-    return (double)curHpTotal / maxHpTotal;
+void search::BattleScumSearcher2::enumerateActionsForNode(search::BattleScumSearcher2::Node &node,
+                                                               const BattleContext &bc) {
+    ActionList actions;
+    enumerateActionsForState(bc, actions);
+    appendEdges(node, actions);
+
+#ifdef sts_print_debug
+    std::cout << "{ (" << node.edges.size() << ") ";
+    for (int i = 0; i < node.edges.size(); ++i) {
+        node.edges[i].action.printDesc(std::cout, bc) << ", ";
+    }
+    std::cout << " }" << std::endl;
+#endif
+}
+
+bool search::BattleScumSearcher2::usesPriors() const {
+    return wideningBase > 0 || priorWeight > 0;
+}
+
+int search::BattleScumSearcher2::getWidenedEdgeCount(std::uint32_t simulationCount) const {
+    if (wideningBase <= 0) {
+        return std::numeric_limits<int>::max();
+    }
+    return std::max(1, static_cast<int>(std::ceil(wideningBase * std::pow(simulationCount+1.0, wideningExponent))));
+}
+
+void search::BattleScumSearcher2::enumeratePriorOrderedActions(const BattleContext &bc, ActionList &actions) const {
+    enumerateActionsForState(bc, actions);
+
+    fixed_list<std::pair<int,Action>, CardManager::MAX_GROUP_SIZE*2> ranked;
+    for (auto a : actions) {
+        int ordering = 0; // card selects keep their enumeration order
+        switch (a.getActionType()) {
+            case ActionType::CARD:
+                ordering = Expert::getPlayOrdering(bc.cards.hand[a.getSourceIdx()].getId());
+                break;
+
+            case ActionType::POTION:
+                ordering = potionOrdering;
+                break;
+
+            case ActionType::END_TURN:
+                ordering = endTurnOrdering;
+                break;
+
+            default:
+                break;
+        }
+        ranked.push_back({ordering, a});
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    for (int i = 0; i < ranked.size(); ++i) {
+        actions[i] = ranked[i].second;
+    }
+}
+
+void search::BattleScumSearcher2::widenNode(search::BattleScumSearcher2::Node &node, const BattleContext &bc, int edgeCount) {
+    ActionList actions;
+    enumeratePriorOrderedActions(bc, actions);
+
+    const auto end = std::min(edgeCount, static_cast<int>(actions.size()));
+    if (end <= static_cast<int>(node.edges.size())) {
+        return;
+    }
+    node.edges.reserve(end);
+    for (int i = static_cast<int>(node.edges.size()); i < end; ++i) {
+        node.edges.push_back({{}, actions[i]});
+    }
+}
+
+void search::BattleScumSearcher2::enumerateActions(const BattleContext &bc, ActionList &actions) {
+    enumerateActionsImpl(actions, bc);
+}
+
+void search::BattleScumSearcher2::enumerateCardActions(search::BattleScumSearcher2::Node &node,
+                                                            const BattleContext &bc) {
+    ActionList actions;
+    enumerateCardActionsImpl(actions, bc);
+    appendEdges(node, actions);
+}
+
+void search::BattleScumSearcher2::enumeratePotionActions(search::BattleScumSearcher2::Node &node,
+                                                              const BattleContext &bc) {
+    ActionList actions;
+    enumeratePotionActionsImpl(actions, bc);
+    appendEdges(node, actions);
+}
+
+void search::BattleScumSearcher2::enumerateCardSelectActions(search::BattleScumSearcher2::Node &node,
+                                                                  const BattleContext &bc) {
+    ActionList actions;
+    enumerateCardSelectActionsImpl(actions, bc);
+    appendEdges(node, actions);
 }
 
 double search::BattleScumSearcher2::evaluateEndState(const BattleContext &bc) {
@@ -423,6 +610,16 @@ double search::BattleScumSearcher2::evaluateEndState(const BattleContext &bc) {
     }
 }
 
+double search::BattleScumSearcher2::evaluateTruncatedState(const BattleContext &bc) {
+    // blend the loss score with a win at the current hp, weighted by how far along the fight is
+    const double progress = 1 - getNonMinionMonsterCurHpRatio(bc);
+    const double hpRatio = static_cast<double>(bc.player.curHp) / bc.player.maxHp;
+    const double winWeight = progress * progress * hpRatio;
+
+    const double winScore = 100 * (35 + bc.player.curHp + bc.potionCount * 4 - (bc.turn * 0.01));
+    return winWeight * winScore + (1-winWeight) * evaluateEndState(bc);
+}
+
 struct LayerStruct {
     const search::BattleScumSearcher2::Node *node;
     BattleContext *bc;
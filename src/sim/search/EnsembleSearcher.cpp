@@ -0,0 +1,169 @@
+#include "sim/search/EnsembleSearcher.h"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "sim/search/ActionSpace.h"
+
+using namespace sts;
+
+namespace {
+
+    struct EnsembleSearchInfo {
+        std::mutex mutex;
+        int nextIdx = 0;
+        search::EnsembleSearcher *searcher = nullptr;
+    };
+
+    void ensembleSearchRunner(EnsembleSearchInfo *info) {
+        auto &es = *info->searcher;
+        while (true) {
+            int idx;
+            {
+                std::scoped_lock lock(info->mutex);
+                if (info->nextIdx >= es.determinizationCount) {
+                    return;
+                }
+                idx = info->nextIdx++;
+            }
+
+            const auto seed = search::EnsembleSearcher::getDeterminizationSeed(*es.rootState, idx);
+            BattleContext bc(*es.rootState);
+            search::EnsembleSearcher::determinize(bc, seed, es.shuffleDrawPile);
+
+            auto s = std::make_unique<search::BattleScumSearcher2>(bc);
+            s->rolloutPolicy = es.rolloutPolicy;
+            s->nodeBudget = es.nodeBudget;
+            s->explorationParameter = es.explorationParameter;
+            s->wideningBase = es.wideningBase;
+            s->priorWeight = es.priorWeight;
+            s->multiSelectMode = es.multiSelectMode;
+            s->randGen.seed(static_cast<std::default_random_engine::result_type>(seed));
+            s->search(es.simulationsPerSearch);
+
+            es.searchers[idx] = std::move(s); // every index is handed to exactly one worker
+        }
+    }
+
+}
+
+search::EnsembleSearcher::EnsembleSearcher(const BattleContext &bc) : rootState(new BattleContext(bc)) {}
+
+std::uint64_t search::EnsembleSearcher::getDeterminizationSeed(const BattleContext &bc, int determinizationIdx) {
+    // splitmix64 finalizer, so neighbouring turns and indices give unrelated streams
+    std::uint64_t x = bc.seed + 0x9E3779B97F4A7C15ULL * (static_cast<std::uint64_t>(determinizationIdx) + 1)
+            + (static_cast<std::uint64_t>(bc.floorNum) << 32) + static_cast<std::uint64_t>(bc.turn);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+void search::EnsembleSearcher::determinize(BattleContext &bc, std::uint64_t seed, bool shuffleDrawPile) {
+    bc.aiRng = Random(seed);
+    bc.cardRandomRng = Random(seed + 1);
+    bc.miscRng = Random(seed + 2);
+    bc.shuffleRng = Random(seed + 3);
+
+    if (shuffleDrawPile && !isDrawPileSelect(bc)) {
+        java::Collections::shuffle(
+                bc.cards.drawPile.begin(),
+                bc.cards.drawPile.end(),
+                java::Random(bc.shuffleRng.randomLong())
+        );
+    }
+}
+
+bool search::EnsembleSearcher::isDrawPileSelect(const BattleContext &bc) {
+    if (bc.inputState != InputState::CARD_SELECT) {
+        return false;
+    }
+    switch (bc.cardSelectInfo.cardSelectTask) {
+        case CardSelectTask::SECRET_TECHNIQUE:
+        case CardSelectTask::SECRET_WEAPON:
+        case CardSelectTask::SEEK:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void search::EnsembleSearcher::search() {
+    searchers.clear();
+    searchers.resize(std::max(determinizationCount, 0));
+
+    EnsembleSearchInfo info;
+    info.searcher = this;
+
+    const int workerCount = std::min(threadCount, determinizationCount);
+    if (workerCount <= 1) {
+        ensembleSearchRunner(&info);
+
+    } else {
+        std::vector<std::unique_ptr<std::thread>> threads;
+        for (int tid = 0; tid < workerCount; ++tid) {
+            threads.emplace_back(new std::thread(ensembleSearchRunner, &info));
+        }
+        for (auto &t : threads) {
+            t->join();
+        }
+    }
+
+    // determinizations can expand different root actions, progressive widening adds them in an order that depends on
+    // the search, so an action is merged from however many trees expanded it
+    rootActions.clear();
+    simulationCount = 0;
+    peakNodeCount = 0;
+    reclaimedNodeCount = 0;
+
+    std::unordered_map<std::uint32_t, std::size_t> actionIdxs;
+    for (const auto &s : searchers) {
+        simulationCount += s->root.simulationCount;
+        peakNodeCount += s->peakNodeCount;
+        reclaimedNodeCount += s->reclaimedNodeCount;
+
+        for (const auto &edge : s->root.edges) {
+            const auto it = actionIdxs.try_emplace(edge.action.bits, rootActions.size()).first;
+            if (it->second == rootActions.size()) {
+                rootActions.push_back({edge.action});
+            }
+            auto &stats = rootActions[it->second];
+            stats.simulationCount += edge.node.simulationCount;
+            stats.evaluationSum += edge.node.getEvaluationSum();
+            ++stats.searchCount;
+        }
+    }
+
+    std::stable_sort(rootActions.begin(), rootActions.end(), [](const auto &a, const auto &b) {
+        return a.simulationCount > b.simulationCount;
+    });
+}
+
+search::Action search::EnsembleSearcher::getBestAction() const {
+    if (rootActions.empty() || !rootActions.front().action.isValidAction(*rootState)) {
+        return getFallbackAction();
+    }
+    return rootActions.front().action;
+}
+
+search::Action search::EnsembleSearcher::getFallbackAction() const {
+    const BattleScumSearcher2::Edge *best = nullptr;
+    for (const auto &s : searchers) {
+        for (const auto &edge : s->root.edges) {
+            if ((best == nullptr || edge.node.simulationCount > best->node.simulationCount)
+                && edge.action.isValidAction(*rootState)) {
+                best = &edge;
+            }
+        }
+    }
+    if (best != nullptr) {
+        return best->action;
+    }
+
+    std::array<std::uint8_t, ActionSpace::SIZE> mask {};
+    ActionSpace::writeLegalityMask(*rootState, mask.data());
+    const auto it = std::find(mask.begin(), mask.end(), 1);
+    return ActionSpace::decode(static_cast<int>(it - mask.begin()));
+}
@@ -0,0 +1,65 @@
+#include "sim/search/RolloutPolicy.h"
+#include "sim/search/BattleScumSearcher2.h"
+#include "sim/search/SimpleAgent.h"
+
+#include <algorithm>
+
+using namespace sts;
+
+static int getActForFloor(int floorNum) {
+    return std::clamp((floorNum-1) / 17 + 1, 1, 4);
+}
+
+bool search::RolloutPolicy::hasCutoff() const {
+    return maxActions > 0 || maxTurns > 0;
+}
+
+bool search::RolloutPolicy::shouldCutoff(const BattleContext &bc, int startTurn, int actionCount) const {
+    return (maxActions > 0 && actionCount >= maxActions) ||
+           (maxTurns > 0 && bc.turn - startTurn >= maxTurns);
+}
+
+search::RolloutPolicy search::RolloutPolicy::uniform() {
+    return {};
+}
+
+search::RolloutPolicy search::RolloutPolicy::heuristic() {
+    RolloutPolicy p;
+    p.selectAction = &selectHeuristicRolloutAction;
+    return p;
+}
+
+search::RolloutPolicy search::RolloutPolicy::epsilonMix(double epsilon) {
+    RolloutPolicy p;
+    p.selectAction = [=](const BattleContext &bc, std::default_random_engine &rng) {
+        std::uniform_real_distribution<double> dist(0, 1);
+        if (dist(rng) < epsilon) {
+            return selectUniformRolloutAction(bc, rng);
+        }
+        return selectHeuristicRolloutAction(bc, rng);
+    };
+    return p;
+}
+
+search::Action search::RolloutPolicy::selectUniformRolloutAction(const BattleContext &bc, std::default_random_engine &rng) {
+    ActionList actions;
+    BattleScumSearcher2::enumerateActions(bc, actions);
+    if (actions.empty()) {
+        std::cerr << bc.seed << " " << bc.monsters.arr[0].getName() << " " << bc.floorNum << " " << monsterEncounterStrings[static_cast<int>(bc.encounter)] << std::endl;
+        assert(false);
+    }
+
+    auto dist = std::uniform_int_distribution<int>(0, actions.size()-1);
+    return actions[dist(rng)];
+}
+
+search::Action search::RolloutPolicy::selectHeuristicRolloutAction(const BattleContext &bc, std::default_random_engine &rng) {
+    if (bc.inputState == InputState::CARD_SELECT) {
+        const auto a = SimpleAgent::getBattleCardSelectAction(bc);
+        if (a != Action()) {
+            return a;
+        }
+        return selectUniformRolloutAction(bc, rng); // the agent has no opinion on this screen
+    }
+    return SimpleAgent::getBattleCardPlayAction(bc, getActForFloor(bc.floorNum));
+}
@@ -9,6 +9,7 @@
 #include <game/Game.h>
 #include "sim/PrintHelpers.h"
 #include "sim/search/BattleScumSearcher2.h"
+#include "sim/search/EnsembleSearcher.h"
 
 using namespace sts;
 
@@ -70,8 +71,21 @@ void search::ScumSearchAgent2::playoutBattle(BattleContext &bc) {
         const std::int64_t simulationCount = isBossEncounter(bc.encounter) ?
                                               (bossSimulationMultiplier * simulationCountBase) : simulationCountBase;
 
+        if (determinizationCount > 1) {
+            stepEnsemble(bc, simulationCount);
+            continue;
+        }
+
         search::BattleScumSearcher2 searcher(bc);
+        searcher.rolloutPolicy = rolloutPolicy;
+        searcher.nodeBudget = nodeBudget;
+        searcher.explorationParameter = explorationParameter;
+        searcher.wideningBase = wideningBase;
+        searcher.priorWeight = priorWeight;
+        searcher.multiSelectMode = multiSelectMode;
         searcher.search(simulationCount);
+        peakNodeCount = std::max(peakNodeCount, searcher.peakNodeCount);
+        reclaimedNodeCount += searcher.reclaimedNodeCount;
 
         if (searcher.outcomePlayerHp > bestOutcomePlayerHp)
         {
@@ -137,6 +151,32 @@ void search::ScumSearchAgent2::stepThroughSearchTree(BattleContext &bc, const se
     }
 }
 
+// an ensemble has no single solution to replay, only its merged root action means the same in every determinization,
+// so one action is taken per search
+void search::ScumSearchAgent2::stepEnsemble(BattleContext &bc, std::int64_t simulationCount) {
+    search::EnsembleSearcher searcher(bc);
+    searcher.determinizationCount = determinizationCount;
+    searcher.threadCount = ensembleThreadCount;
+    searcher.simulationsPerSearch = simulationCount;
+    searcher.nodeBudget = nodeBudget;
+    searcher.explorationParameter = explorationParameter;
+    searcher.wideningBase = wideningBase;
+    searcher.priorWeight = priorWeight;
+    searcher.multiSelectMode = multiSelectMode;
+    searcher.rolloutPolicy = rolloutPolicy;
+    searcher.search();
+
+    peakNodeCount = std::max(peakNodeCount, searcher.peakNodeCount);
+    reclaimedNodeCount += searcher.reclaimedNodeCount;
+    simulationCountTotal += searcher.simulationCount;
+
+    const auto action = searcher.getBestAction();
+    if (printLogs) {
+        printHelper(bc, action);
+    }
+    takeAction(bc, action);
+}
+
 void search::ScumSearchAgent2::stepRandom(GameContext &gc) {
     std::vector<search::GameAction> possibleActions(search::GameAction::getAllActionsInState(gc));
     std::uniform_int_distribution<int> distr(0, static_cast<int>(possibleActions.size())-1);
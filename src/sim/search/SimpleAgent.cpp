@@ -15,7 +15,6 @@
 
 using namespace sts;
 
-static bool haveInitMaps = false;
 static int cardPriorityMap[372] {};
 static int cardPlayMap[372] {};
 static int bossRelicPriorityMap[200] {};
@@ -147,23 +146,20 @@ void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs)
 //}
 
 int search::SimpleAgent::getIncomingDamage(const BattleContext &bc) const {
-    int incomingDamage = 0;
-    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-        const auto &m = bc.monsters.arr[i];
-        if (m.isDeadOrEscaped() || m.isHalfDead()) {
-            continue;
-        }
+    return getIncomingDamage(bc, curGameContext->act);
+}
 
-        DamageInfo dInfo;
-        if (bc.player.hasRelic<R::RUNIC_DOME>()) {
-            dInfo = {5*curGameContext->act, 1};
+int search::SimpleAgent::getIncomingDamage(const BattleContext &bc, int act) {
+    if (!bc.player.hasRelic<R::RUNIC_DOME>()) {
+        return bc.monsters.getIncomingDamage(bc);
+    }
 
-        } else {
-            dInfo = m.getMoveBaseDamage(bc);
-            dInfo.damage = m.calculateDamageToPlayer(bc, dInfo.damage);
+    // intents are hidden, guess from the act
+    int incomingDamage = 0;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (!bc.monsters.arr[i].isDeadOrEscaped()) {
+            incomingDamage += 5*act;
         }
-
-        incomingDamage += dInfo.damage * dInfo.attackCount;
     }
     return incomingDamage;
 }
@@ -331,9 +327,13 @@ void search::SimpleAgent::playoutBattle(BattleContext &bc) {
 }
 
 void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
+    takeAction(bc, getBattleCardPlayAction(bc, curGameContext->act));
+}
+
+search::Action search::SimpleAgent::getBattleCardPlayAction(const BattleContext &bc, int act) {
+    initMaps(); // may be called without constructing an agent, e.g. from a rollout policy
     if (!bc.isCardPlayAllowed() || bc.player.cardsPlayedThisTurn > 1000) {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
+        return Action(ActionType::END_TURN);
     }
 
     fixed_list<int,10> playableCardsIdxs;
@@ -345,8 +345,7 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
     }
 
     if (playableCardsIdxs.empty()) {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
+        return Action(ActionType::END_TURN);
     }
 
     fixed_list<int,10> zeroCost;
@@ -372,8 +371,8 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
         }
     }
 
-    const int incomingDamage = getIncomingDamage(bc);
-    if (bc.player.block > (incomingDamage - curGameContext->act - 4)) {
+    const int incomingDamage = getIncomingDamage(bc, act);
+    if (bc.player.block > (incomingDamage - act - 4)) {
         fixed_list<int,10> offensiveCards;
         for (auto handIdx : nonZeroCostCards) {
             const auto &c = bc.cards.hand[handIdx];
@@ -409,14 +408,12 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
         bestCardIdx = getBestCardToPlay(bc, zeroCostAttacks);
 
     } else {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
+        return Action(ActionType::END_TURN);
     }
 
     const auto &c = bc.cards.hand[bestCardIdx];
     if (!c.requiresTarget()) {
-        takeAction(bc, Action(ActionType::CARD, bestCardIdx));
-        return;
+        return Action(ActionType::CARD, bestCardIdx);
     }
 
     int targetIdx;
@@ -425,7 +422,7 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
     } else {
         targetIdx = getHighHpMonster(bc);
     }
-    takeAction(bc, Action(ActionType::CARD, bestCardIdx, targetIdx));
+    return Action(ActionType::CARD, bestCardIdx, targetIdx);
 }
 
 template <typename ForwardIt>
@@ -443,7 +440,14 @@ void setupCardOptionsHelper(std::vector<std::pair<search::Action,CardInstance>>
 
 
 void search::SimpleAgent::stepBattleCardSelect(BattleContext &bc) {
+    const auto a = getBattleCardSelectAction(bc);
+    if (a != Action()) {
+        takeAction(bc, a);
+    }
+}
 
+search::Action search::SimpleAgent::getBattleCardSelectAction(const BattleContext &bc) {
+    initMaps(); // may be called without constructing an agent, e.g. from a rollout policy
     std::vector<std::pair<search::Action,CardInstance>> actions;
     switch (bc.cardSelectInfo.cardSelectTask) {
         case CardSelectTask::ARMAMENTS:
@@ -505,8 +509,7 @@ void search::SimpleAgent::stepBattleCardSelect(BattleContext &bc) {
 
         case CardSelectTask::EXHAUST_MANY:
         case CardSelectTask::GAMBLE: // just select none
-            takeAction(bc, search::Action(search::ActionType::MULTI_CARD_SELECT, 0));
-            return;
+            return search::Action(search::ActionType::MULTI_CARD_SELECT, 0);
 
         default:
 #ifdef sts_asserts
@@ -538,13 +541,11 @@ void search::SimpleAgent::stepBattleCardSelect(BattleContext &bc) {
         case CardSelectTask::SETUP:
         case CardSelectTask::SEEK:
         case CardSelectTask::WARCRY:
-            takeAction(bc, actions.front().first);
-            break;
+            return actions.front().first;
 
         case CardSelectTask::EXHAUST_ONE:
         case CardSelectTask::RECYCLE:
-            takeAction(bc, actions.back().first);
-            break;
+            return actions.back().first;
 
         case CardSelectTask::EXHAUST_MANY:
         case CardSelectTask::INVALID:
@@ -555,6 +556,7 @@ void search::SimpleAgent::stepBattleCardSelect(BattleContext &bc) {
 #endif
             break;
     }
+    return Action(); // invalid, no selection for this task
 }
 
 void search::SimpleAgent::stepOutOfCombat(GameContext &gc) {
@@ -1091,12 +1093,7 @@ constexpr std::array<RelicId,24> bossRelicPriorities = {
 };
 
 
-void initMaps() {
-    // there are synchronization issues with this if multiple threads start at once
-    if (haveInitMaps) {
-        return;
-    }
-    haveInitMaps = true;
+static void buildMaps() {
     for (int i = 0; i < cardPlayPriorities.size(); ++i) {
         CardId c = cardPlayPriorities[i];
         cardPlayMap[static_cast<int>(c)] = i + 1;
@@ -1239,3 +1236,9 @@ void search::SimpleAgent::runAgentsMt(int threadCount, std::uint64_t startSeed,
               << " elapsed: " << duration
               << std::endl;
 }
+
+// rollouts call this from every search thread, call_once makes the others wait until the tables are complete
+void initMaps() {
+    static std::once_flag flag;
+    std::call_once(flag, buildMaps);
+}
@@ -0,0 +1,372 @@
+#include "sim/search/StaticEvaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "sim/search/BattleScumSearcher2.h"
+
+using namespace sts;
+
+namespace {
+
+    typedef search::EvalFeature EF;
+
+    void setFeature(search::EvalFeatures &features, EF f, double value) {
+        features[static_cast<int>(f)] = value;
+    }
+
+    // solves a*x = b in place with partial pivoting, a is n by n in row major order, singular columns give 0
+    void solveLinearSystem(std::vector<double> &a, std::vector<double> &b, int n) {
+        for (int col = 0; col < n; ++col) {
+            int pivot = col;
+            for (int row = col+1; row < n; ++row) {
+                if (std::abs(a[row*n + col]) > std::abs(a[pivot*n + col])) {
+                    pivot = row;
+                }
+            }
+            if (std::abs(a[pivot*n + col]) < 1e-12) {
+                continue;
+            }
+            if (pivot != col) {
+                for (int i = 0; i < n; ++i) {
+                    std::swap(a[col*n + i], a[pivot*n + i]);
+                }
+                std::swap(b[col], b[pivot]);
+            }
+            for (int row = 0; row < n; ++row) {
+                if (row == col) {
+                    continue;
+                }
+                const double factor = a[row*n + col] / a[col*n + col];
+                if (factor == 0) {
+                    continue;
+                }
+                for (int i = col; i < n; ++i) {
+                    a[row*n + i] -= factor * a[col*n + i];
+                }
+                b[row] -= factor * b[col];
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            b[i] = std::abs(a[i*n + i]) < 1e-12 ? 0 : b[i] / a[i*n + i];
+        }
+    }
+
+}
+
+double search::getNonMinionMonsterCurHpRatio(const BattleContext &bc) {
+    int curHpTotal = 0;
+    int maxHpTotal = 0;
+
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        const auto &m = bc.monsters.arr[i];
+        if (!m.hasStatus<MS::MINION>() && m.id != sts::MonsterId::INVALID) {
+            curHpTotal += m.curHp;
+            maxHpTotal += m.maxHp;
+        }
+    }
+
+    if (curHpTotal == 0 || maxHpTotal == 0) {
+        return 0;
+    }
+
+    return (double)curHpTotal / maxHpTotal;
+}
+
+double search::getNonMinionMonsterEffectiveHpRatio(const BattleContext &bc) {
+    int effectiveHpTotal = 0;
+    int maxHpTotal = 0;
+
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        const auto &m = bc.monsters.arr[i];
+        if (!m.hasStatus<MS::MINION>() && m.id != sts::MonsterId::INVALID) {
+            if (m.curHp > 0) {
+                effectiveHpTotal += m.curHp + m.block;
+            }
+            maxHpTotal += m.maxHp;
+        }
+    }
+
+    if (effectiveHpTotal == 0 || maxHpTotal == 0) {
+        return 0;
+    }
+
+    return (double)effectiveHpTotal / maxHpTotal;
+}
+
+void search::getEvalFeatures(const BattleContext &bc, EvalFeatures &features) {
+    const auto &p = bc.player;
+    const double hp = p.curHp;
+    const int unblockedDamage = std::max(0, bc.monsters.getIncomingDamage(bc) - p.block);
+    const double monsterHpRatio = getNonMinionMonsterCurHpRatio(bc);
+    const double progress = 1 - monsterHpRatio;
+
+    int monsterStrength = 0;
+    int monsterScaling = 0;
+    int monsterDebuffs = 0;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        const auto &m = bc.monsters.arr[i];
+        if (m.isDeadOrEscaped()) {
+            continue;
+        }
+        monsterStrength += m.getStatus<MS::STRENGTH>();
+        monsterScaling += m.getStatus<MS::RITUAL>() + m.getStatus<MS::GENERIC_STRENGTH_UP>()
+                + m.getStatus<MS::METALLICIZE>() + m.getStatus<MS::PLATED_ARMOR>() + m.getStatus<MS::REGEN>();
+        monsterDebuffs += m.getStatus<MS::WEAK>() + m.getStatus<MS::VULNERABLE>();
+    }
+
+    const int playerScaling = p.getStatus<PS::DEMON_FORM>() + p.getStatus<PS::RITUAL>()
+            + p.getStatus<PS::METALLICIZE>() + p.getStatus<PS::PLATED_ARMOR>() + p.getStatus<PS::REGEN>()
+            + p.getStatus<PS::FEEL_NO_PAIN>();
+    const int playerDebuffs = p.getStatus<PS::WEAK>() + p.getStatus<PS::VULNERABLE>() + p.getStatus<PS::FRAIL>();
+
+    const int drawPileSize = bc.cards.drawPile.size();
+    const int cycleSize = drawPileSize + bc.cards.discardPile.size() + bc.cards.cardsInHand;
+
+    setFeature(features, EF::BIAS, 1);
+    setFeature(features, EF::PLAYER_HP, hp);
+    setFeature(features, EF::PLAYER_HP_RATIO, hp / p.maxHp);
+    setFeature(features, EF::HP_AFTER_INTENT, std::max(0, p.curHp - unblockedDamage));
+    setFeature(features, EF::UNBLOCKED_DAMAGE_RATIO, p.curHp > 0 ? std::min(1.0, unblockedDamage / hp) : 1);
+    setFeature(features, EF::MONSTER_HP_RATIO, monsterHpRatio);
+    setFeature(features, EF::MONSTER_EFFECTIVE_HP_RATIO, getNonMinionMonsterEffectiveHpRatio(bc));
+    setFeature(features, EF::MONSTERS_ALIVE, bc.monsters.monstersAlive);
+    setFeature(features, EF::PROGRESS_HP, progress * hp);
+    setFeature(features, EF::PROGRESS_SQUARED_HP, progress * progress * hp);
+    setFeature(features, EF::PLAYER_STRENGTH, p.getStatus<PS::STRENGTH>());
+    setFeature(features, EF::PLAYER_DEXTERITY, p.getStatus<PS::DEXTERITY>());
+    setFeature(features, EF::PLAYER_SCALING, playerScaling);
+    setFeature(features, EF::PLAYER_DEBUFFS, playerDebuffs);
+    setFeature(features, EF::MONSTER_STRENGTH, monsterStrength);
+    setFeature(features, EF::MONSTER_SCALING, monsterScaling);
+    setFeature(features, EF::MONSTER_DEBUFFS, monsterDebuffs);
+    setFeature(features, EF::POTION_COUNT, bc.potionCount);
+    setFeature(features, EF::DRAW_PILE_RATIO, cycleSize ? static_cast<double>(drawPileSize) / cycleSize : 0);
+    setFeature(features, EF::TURN, bc.turn);
+}
+
+double search::StaticEvaluator::evaluate(const BattleContext &bc) const {
+    if (bc.outcome != Outcome::UNDECIDED) {
+        return BattleScumSearcher2::evaluateEndState(bc);
+    }
+    EvalFeatures features;
+    getEvalFeatures(bc, features);
+    return evaluate(features);
+}
+
+double search::StaticEvaluator::evaluate(const EvalFeatures &features) const {
+    double ret = 0;
+    for (int i = 0; i < EVAL_FEATURE_COUNT; ++i) {
+        ret += weights[i] * features[i];
+    }
+    return ret;
+}
+
+search::EvalFnc search::StaticEvaluator::getEvalFnc() const {
+    return [evaluator=*this](const BattleContext &bc) {
+        return evaluator.evaluate(bc);
+    };
+}
+
+nlohmann::json search::StaticEvaluator::toJson() const {
+    nlohmann::json weightsJson = nlohmann::json::object();
+    for (int i = 0; i < EVAL_FEATURE_COUNT; ++i) {
+        weightsJson[evalFeatureStrings[i]] = weights[i];
+    }
+    return {{"weights", weightsJson}};
+}
+
+search::StaticEvaluator search::StaticEvaluator::fromJson(const nlohmann::json &json) {
+    if (!json.is_object() || !json.contains("weights") || !json["weights"].is_object()) {
+        throw std::runtime_error("static evaluator json must be an object with a \"weights\" object");
+    }
+
+    StaticEvaluator ret;
+    for (const auto &item : json["weights"].items()) {
+        const auto it = std::find_if(std::begin(evalFeatureStrings), std::end(evalFeatureStrings),
+                                     [&](const char *s) { return item.key() == s; });
+        if (it == std::end(evalFeatureStrings)) {
+            throw std::runtime_error("unknown static evaluator feature: " + item.key());
+        }
+        if (!item.value().is_number()) {
+            throw std::runtime_error("static evaluator weight must be a number: " + item.key());
+        }
+        ret.weights[it - std::begin(evalFeatureStrings)] = item.value().get<double>();
+    }
+    return ret;
+}
+
+search::StaticEvaluator search::StaticEvaluator::intentAware() {
+    StaticEvaluator ret;
+    ret.weights = {
+            5353,      // BIAS
+            -41.93,    // PLAYER_HP
+            10020,     // PLAYER_HP_RATIO
+            51.17,     // HP_AFTER_INTENT
+            -641.7,    // UNBLOCKED_DAMAGE_RATIO
+            -7192,     // MONSTER_HP_RATIO
+            551.6,     // MONSTER_EFFECTIVE_HP_RATIO
+            318.4,     // MONSTERS_ALIVE
+            -44.52,    // PROGRESS_HP
+            12.07,     // PROGRESS_SQUARED_HP
+            102.3,     // PLAYER_STRENGTH
+            16.13,     // PLAYER_DEXTERITY
+            -67,       // PLAYER_SCALING
+            -12.8,     // PLAYER_DEBUFFS
+            -12.05,    // MONSTER_STRENGTH
+            -46.72,    // MONSTER_SCALING
+            -51.96,    // MONSTER_DEBUFFS
+            462.1,     // POTION_COUNT
+            -470.9,    // DRAW_PILE_RATIO
+            -228.7,    // TURN
+    };
+    return ret;
+}
+
+void search::EvaluatorCalibration::addSample(const BattleContext &bc, const RolloutPolicy &policy, int rolloutCount,
+                                             std::default_random_engine &rng) {
+    Sample s;
+    getEvalFeatures(bc, s.features);
+    s.baseline = BattleScumSearcher2::evaluateTruncatedState(bc);
+
+    double sum = 0;
+    for (int i = 0; i < rolloutCount; ++i) {
+        BattleContext state(bc);
+        while (state.outcome == Outcome::UNDECIDED) {
+            policy.selectAction(state, rng).execute(state);
+        }
+        sum += BattleScumSearcher2::evaluateEndState(state);
+    }
+    s.target = sum / std::max(1, rolloutCount);
+    samples.push_back(s);
+}
+
+search::StaticEvaluator search::EvaluatorCalibration::fit(double ridge) const {
+    StaticEvaluator ret;
+    if (samples.empty()) {
+        return ret;
+    }
+
+    // the bias is fit through the means, the other features are scaled to unit variance so one ridge fits all
+    constexpr int d = EVAL_FEATURE_COUNT;
+    const auto n = static_cast<double>(samples.size());
+    std::array<double, d> mean {};
+    std::array<double, d> scale {};
+    double targetMean = 0;
+    for (const auto &s : samples) {
+        for (int j = 1; j < d; ++j) {
+            mean[j] += s.features[j] / n;
+        }
+        targetMean += s.target / n;
+    }
+    for (const auto &s : samples) {
+        for (int j = 1; j < d; ++j) {
+            scale[j] += (s.features[j]-mean[j]) * (s.features[j]-mean[j]) / n;
+        }
+    }
+    for (int j = 1; j < d; ++j) {
+        scale[j] = std::sqrt(scale[j]);
+    }
+
+    const auto getZ = [&](const Sample &s, int j) {
+        return scale[j] > 0 ? (s.features[j]-mean[j]) / scale[j] : 0;
+    };
+
+    // the normal equations over features 1 to d-1
+    constexpr int k = d-1;
+    std::vector<double> a(k*k, 0);
+    std::vector<double> b(k, 0);
+    for (const auto &s : samples) {
+        std::array<double, k> z;
+        for (int j = 0; j < k; ++j) {
+            z[j] = getZ(s, j+1);
+        }
+        for (int r = 0; r < k; ++r) {
+            for (int c = 0; c < k; ++c) {
+                a[r*k + c] += z[r] * z[c];
+            }
+            b[r] += z[r] * (s.target - targetMean);
+        }
+    }
+    for (int j = 0; j < k; ++j) {
+        a[j*k + j] += ridge * n;
+    }
+    solveLinearSystem(a, b, k);
+
+    ret.weights[0] = targetMean;
+    for (int j = 1; j < d; ++j) {
+        if (scale[j] > 0) {
+            ret.weights[j] = b[j-1] / scale[j];
+            ret.weights[0] -= ret.weights[j] * mean[j];
+        }
+    }
+    return ret;
+}
+
+double search::EvaluatorCalibration::getMeanSquaredError(const StaticEvaluator &evaluator) const {
+    double sum = 0;
+    for (const auto &s : samples) {
+        const double error = evaluator.evaluate(s.features) - s.target;
+        sum += error * error;
+    }
+    return samples.empty() ? 0 : sum / samples.size();
+}
+
+double search::EvaluatorCalibration::getBaselineMeanSquaredError() const {
+    double sum = 0;
+    for (const auto &s : samples) {
+        sum += (s.baseline - s.target) * (s.baseline - s.target);
+    }
+    return samples.empty() ? 0 : sum / samples.size();
+}
+
+double search::EvaluatorCalibration::getTargetVariance() const {
+    if (samples.empty()) {
+        return 0;
+    }
+    double mean = 0;
+    for (const auto &s : samples) {
+        mean += s.target / samples.size();
+    }
+    double sum = 0;
+    for (const auto &s : samples) {
+        sum += (s.target - mean) * (s.target - mean);
+    }
+    return sum / samples.size();
+}
+
+void search::EvaluatorCalibration::writeSamples(std::ostream &os) const {
+    for (const auto &s : samples) {
+        nlohmann::json line(s.features);
+        line.push_back(s.baseline);
+        line.push_back(s.target);
+        os << line.dump() << '\n';
+    }
+}
+
+void search::EvaluatorCalibration::readSamples(std::istream &is) {
+    std::string line;
+    int lineNum = 0;
+    while (std::getline(is, line)) {
+        ++lineNum;
+        if (line.empty()) {
+            continue;
+        }
+
+        const auto json = nlohmann::json::parse(line, nullptr, false);
+        const bool isNumbers = json.is_array() && std::all_of(json.begin(), json.end(), [](const auto &x) { return x.is_number(); });
+        if (!isNumbers || json.size() != EVAL_FEATURE_COUNT+2) {
+            throw std::runtime_error("malformed evaluator sample on line " + std::to_string(lineNum));
+        }
+
+        Sample s;
+        for (int i = 0; i < EVAL_FEATURE_COUNT; ++i) {
+            s.features[i] = json[i].get<double>();
+        }
+        s.baseline = json[EVAL_FEATURE_COUNT].get<double>();
+        s.target = json[EVAL_FEATURE_COUNT+1].get<double>();
+        samples.push_back(s);
+    }
+}